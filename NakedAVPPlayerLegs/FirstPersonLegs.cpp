@@ -0,0 +1,270 @@
+// ================================================================
+// File: Code/Game/FirstPersonLegs.cpp
+// Native driver for the Far Cry first-person legs
+// ================================================================
+
+#include "StdAfx.h"
+#include "FirstPersonLegs.h"
+#include "Game.h"
+
+#include <IEntitySystem.h>
+#include <ICryAnimation.h>
+#include <IActorSystem.h>
+#include <IPhysics.h>
+
+// Pulses run after a long frame (level load, alt-tab) are capped so the
+// driver does not spiral; the rest of the time is dropped
+static const int MAX_PULSES_PER_FRAME = 5;
+
+// Below this speed the legs keep their pose (as the Lua version did)
+static const float MIN_SWING_SPEED = 0.1f;
+
+CFirstPersonLegs::CFirstPersonLegs()
+    : m_bConfigured(false)
+    , m_bEnabled(true)
+    , m_bHidden(false)
+    , m_pulseTimer(0.0f)
+    , m_swingTime(0.0f)
+{
+}
+
+void CFirstPersonLegs::Configure(const SFirstPersonLegsParams& params)
+{
+    m_params = params;
+    m_params.pulseRate = max(m_params.pulseRate, 0.001f);
+
+    m_bConfigured = true;
+    m_bHidden = false;
+    m_pulseTimer = 0.0f;
+    m_swingTime = 0.0f;
+}
+
+// Legs entity removed; nothing to drive until configured again
+void CFirstPersonLegs::Reset()
+{
+    m_bConfigured = false;
+    m_params = SFirstPersonLegsParams();
+}
+
+void CFirstPersonLegs::Enable()
+{
+    m_bEnabled = true;
+    m_pulseTimer = 0.0f;
+}
+
+void CFirstPersonLegs::Disable()
+{
+    m_bEnabled = false;
+
+    if (IEntity* pLegs = gEnv->pEntitySystem->GetEntity(m_params.legsId))
+        SetLegsHidden(pLegs, true);
+}
+
+bool CFirstPersonLegs::Toggle()
+{
+    if (m_bEnabled)
+        Disable();
+    else
+        Enable();
+    return m_bEnabled;
+}
+
+// ================================================================
+// Pulse (JKDF2's SetPulse(0.01)) at a fixed rate
+// ================================================================
+void CFirstPersonLegs::Update(float frameTime)
+{
+    if (!m_bConfigured || !m_bEnabled)
+        return;
+
+    m_pulseTimer += frameTime;
+
+    int pulses = 0;
+    while (m_pulseTimer >= m_params.pulseRate && pulses < MAX_PULSES_PER_FRAME)
+    {
+        m_pulseTimer -= m_params.pulseRate;
+        pulses++;
+    }
+
+    if (pulses == MAX_PULSES_PER_FRAME)
+        m_pulseTimer = 0.0f;
+
+    // Placement only depends on the latest state, so one pass covers
+    // every pulse that was due; only the swing clock needs their time
+    if (pulses > 0)
+        Pulse(pulses * m_params.pulseRate);
+}
+
+void CFirstPersonLegs::Pulse(float pulseTime)
+{
+    IEntity* pPlayer = gEnv->pEntitySystem->GetEntity(m_params.playerId);
+    IEntity* pLegs = gEnv->pEntitySystem->GetEntity(m_params.legsId);
+
+    // Entities went away under us (level change); wait for Configure
+    if (!pPlayer || !pLegs)
+    {
+        m_bConfigured = false;
+        return;
+    }
+
+    IActor* pActor = g_pGame->GetIGameFramework()->GetIActorSystem()->GetActor(m_params.playerId);
+
+    if (!ShouldShowLegs(pActor))
+    {
+        SetLegsHidden(pLegs, true);
+        return;
+    }
+
+    SetLegsHidden(pLegs, false);
+    PlaceLegs(pPlayer, pLegs, pActor);
+    AnimateLegs(pPlayer, pLegs, pulseTime);
+}
+
+// Third person, dead, or not looking down: nothing to see
+bool CFirstPersonLegs::ShouldShowLegs(IActor* pActor) const
+{
+    if (!pActor || pActor->IsThirdPerson() || pActor->GetHealth() <= 0)
+        return false;
+
+    Ang3 viewAngles(pActor->GetViewRotation());
+    return viewAngles.x > m_params.lookDownPitch;
+}
+
+// Hidden rather than destroyed, so looking down again does not respawn
+void CFirstPersonLegs::SetLegsHidden(IEntity* pLegs, bool bHidden)
+{
+    if (m_bHidden == bHidden)
+        return;
+
+    pLegs->Hide(bHidden);
+    m_bHidden = bHidden;
+}
+
+// ================================================================
+// Placement (JKDF2's SetThingVel/SetThingLook equivalent)
+// ================================================================
+void CFirstPersonLegs::PlaceLegs(IEntity* pPlayer, IEntity* pLegs, IActor* pActor)
+{
+    const Quat& playerRot = pPlayer->GetWorldRotation();
+
+    Vec3 legsPos = pPlayer->GetWorldPos() + playerRot * m_params.offset;
+
+    if (pActor->GetStance() == STANCE_CROUCH)
+        legsPos.z -= m_params.crouchDrop;
+
+    pLegs->SetWorldTM(Matrix34::Create(Vec3(1.0f, 1.0f, 1.0f), playerRot, legsPos));
+}
+
+// ================================================================
+// Leg Swing (basic procedural animation)
+// ================================================================
+void CFirstPersonLegs::AnimateLegs(IEntity* pPlayer, IEntity* pLegs, float pulseTime)
+{
+    if (m_params.leftThighId < 0 && m_params.rightThighId < 0)
+        return;
+
+    IPhysicalEntity* pPhysics = pPlayer->GetPhysics();
+    if (!pPhysics)
+        return;
+
+    pe_status_dynamics dynamics;
+    if (!pPhysics->GetStatus(&dynamics))
+        return;
+
+    float speed = dynamics.v.GetLength();
+    if (speed < MIN_SWING_SPEED)
+        return;
+
+    ICharacterInstance* pCharacter = pLegs->GetCharacter(0);
+    ISkeletonPose* pPose = pCharacter ? pCharacter->GetISkeletonPose() : NULL;
+    if (!pPose)
+        return;
+
+    m_swingTime += pulseTime;
+    float swingAmount = sinf(m_swingTime * speed * m_params.swingFrequency) * m_params.swingAmount;
+
+    // Right leg 180 degrees out of phase
+    if (m_params.leftThighId >= 0)
+    {
+        QuatT joint = pPose->GetAbsJointByID(m_params.leftThighId);
+        joint.q = Quat::CreateRotationX(swingAmount);
+        pPose->SetAbsJointByID(m_params.leftThighId, joint);
+    }
+
+    if (m_params.rightThighId >= 0)
+    {
+        QuatT joint = pPose->GetAbsJointByID(m_params.rightThighId);
+        joint.q = Quat::CreateRotationX(-swingAmount);
+        pPose->SetAbsJointByID(m_params.rightThighId, joint);
+    }
+}
+
+// ================================================================
+// Script Binding
+// ================================================================
+CScriptBind_FirstPersonLegs::CScriptBind_FirstPersonLegs(ISystem* pSystem, CFirstPersonLegs* pLegs)
+    : m_pLegs(pLegs)
+{
+    Init(pSystem->GetIScriptSystem(), pSystem);
+    SetGlobalName("FirstPersonLegsDriver");
+
+#undef SCRIPT_REG_CLASSNAME
+#define SCRIPT_REG_CLASSNAME &CScriptBind_FirstPersonLegs::
+
+    SCRIPT_REG_TEMPLFUNC(Configure, "params");
+    SCRIPT_REG_FUNC(Reset);
+    SCRIPT_REG_FUNC(Enable);
+    SCRIPT_REG_FUNC(Disable);
+    SCRIPT_REG_FUNC(Toggle);
+}
+
+int CScriptBind_FirstPersonLegs::Configure(IFunctionHandler* pH, SmartScriptTable params)
+{
+    SFirstPersonLegsParams legsParams;
+    ScriptHandle playerId, legsId;
+
+    if (!params->GetValue("playerId", playerId) || !params->GetValue("legsId", legsId))
+    {
+        GameWarning("FirstPersonLegsDriver.Configure: playerId and legsId are required");
+        return pH->EndFunction(false);
+    }
+
+    legsParams.playerId = (EntityId)playerId.n;
+    legsParams.legsId = (EntityId)legsId.n;
+
+    // Everything else is optional and keeps its default
+    params->GetValue("offset", legsParams.offset);
+    params->GetValue("crouchDrop", legsParams.crouchDrop);
+    params->GetValue("pulseRate", legsParams.pulseRate);
+    params->GetValue("lookDownPitch", legsParams.lookDownPitch);
+    params->GetValue("swingAmount", legsParams.swingAmount);
+    params->GetValue("swingFrequency", legsParams.swingFrequency);
+    params->GetValue("leftThighId", legsParams.leftThighId);
+    params->GetValue("rightThighId", legsParams.rightThighId);
+
+    m_pLegs->Configure(legsParams);
+    return pH->EndFunction(true);
+}
+
+int CScriptBind_FirstPersonLegs::Reset(IFunctionHandler* pH)
+{
+    m_pLegs->Reset();
+    return pH->EndFunction();
+}
+
+int CScriptBind_FirstPersonLegs::Enable(IFunctionHandler* pH)
+{
+    m_pLegs->Enable();
+    return pH->EndFunction();
+}
+
+int CScriptBind_FirstPersonLegs::Disable(IFunctionHandler* pH)
+{
+    m_pLegs->Disable();
+    return pH->EndFunction();
+}
+
+int CScriptBind_FirstPersonLegs::Toggle(IFunctionHandler* pH)
+{
+    return pH->EndFunction(m_pLegs->Toggle());
+}
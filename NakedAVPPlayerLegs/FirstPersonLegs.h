@@ -0,0 +1,99 @@
+// ================================================================
+// File: Code/Game/FirstPersonLegs.h
+// Native driver for the Far Cry first-person legs
+//
+// FirstPersonLegs.lua spawns the legs entity and resolves its joints
+// once, then hands them to this driver through the
+// FirstPersonLegsDriver script table. From then on every pulse (view
+// checks, placement, leg swing) runs here; the script only forwards
+// Enable/Disable/Toggle.
+// ================================================================
+
+#ifndef __FIRSTPERSONLEGS_H__
+#define __FIRSTPERSONLEGS_H__
+
+#pragma once
+
+#include <IScriptSystem.h>
+#include <ScriptHelpers.h>
+
+struct SFirstPersonLegsParams
+{
+    SFirstPersonLegsParams()
+        : playerId(0)
+        , legsId(0)
+        , offset(0.0f, -0.2f, -0.5f)
+        , crouchDrop(0.3f)
+        , pulseRate(0.01f)
+        , lookDownPitch(0.3f)
+        , swingAmount(0.1f)
+        , swingFrequency(5.0f)
+        , leftThighId(-1)
+        , rightThighId(-1)
+    {
+    }
+
+    EntityId playerId;
+    EntityId legsId;
+    Vec3 offset;            // From the player, in player space
+    float crouchDrop;       // Extra drop while crouched
+    float pulseRate;        // Seconds per pulse (0.01 = 100Hz like JKDF2)
+    float lookDownPitch;    // Legs only shown when looking further down (radians)
+    float swingAmount;      // Thigh swing (radians) at speed 1
+    float swingFrequency;
+    int leftThighId;        // Joint ids, -1 when the model has no such joint
+    int rightThighId;
+};
+
+class CFirstPersonLegs
+{
+public:
+    CFirstPersonLegs();
+
+    void Configure(const SFirstPersonLegsParams& params);
+    void Reset();
+
+    void Enable();
+    void Disable();
+    bool Toggle();
+    bool IsEnabled() const { return m_bEnabled; }
+
+    // From CGame::Update with the frame time; runs the due pulses
+    void Update(float frameTime);
+
+private:
+    void Pulse(float pulseTime);
+    bool ShouldShowLegs(IActor* pActor) const;
+    void PlaceLegs(IEntity* pPlayer, IEntity* pLegs, IActor* pActor);
+    void AnimateLegs(IEntity* pPlayer, IEntity* pLegs, float pulseTime);
+    void SetLegsHidden(IEntity* pLegs, bool bHidden);
+
+    SFirstPersonLegsParams m_params;
+    bool m_bConfigured;
+    bool m_bEnabled;
+    bool m_bHidden;
+    float m_pulseTimer;
+    float m_swingTime;
+};
+
+// ================================================================
+// Script Binding (FirstPersonLegsDriver)
+// ================================================================
+class CScriptBind_FirstPersonLegs : public CScriptableBase
+{
+public:
+    CScriptBind_FirstPersonLegs(ISystem* pSystem, CFirstPersonLegs* pLegs);
+    virtual ~CScriptBind_FirstPersonLegs() {}
+
+    // FirstPersonLegsDriver.Configure({ playerId=, legsId=, offset=, ... })
+    int Configure(IFunctionHandler* pH, SmartScriptTable params);
+    int Reset(IFunctionHandler* pH);
+    int Enable(IFunctionHandler* pH);
+    int Disable(IFunctionHandler* pH);
+    int Toggle(IFunctionHandler* pH);
+
+private:
+    CFirstPersonLegs* m_pLegs;
+};
+
+#endif // __FIRSTPERSONLEGS_H__
@@ -1,6 +1,11 @@
 -- ================================================================
 -- File: Scripts/Game/FirstPersonLegs.lua
 -- JKDF2-style first-person legs for Far Cry 1
+--
+-- The script spawns the legs once and hands them to the native
+-- driver (FirstPersonLegs.cpp, FirstPersonLegsDriver), which runs the
+-- pulse: view checks, placement and leg swing. The script itself
+-- only handles enable/disable/toggle.
 -- ================================================================
 
 FirstPersonLegs = {
@@ -14,12 +19,13 @@ FirstPersonLegs = {
     Enabled = 1,
     PulseRate = 0.01,  -- 100Hz like JKDF2
     HealthCheckDelay = 0.25,
+    Offset = { x = 0, y = -0.2, z = -0.5 },  -- Behind and below camera
+    CrouchDrop = 0.3,
+    LookDownPitch = 0.3,  -- ~17 degrees
     
     -- Internal state
     bInitialized = false,
-    bLegsCreated = false,
-    LastHealth = 100,
-    PulseTimer = 0
+    bLegsCreated = false
 }
 
 -- ================================================================
@@ -51,68 +57,16 @@ function FirstPersonLegs:Startup()
         end
     end
     
-    -- Set pulse rate (JKDF2's SetPulse(0.01))
-    self.PulseTimer = 0
     self.bInitialized = true
     
-    System.Log("FirstPersonLegs: System initialized")
-end
-
--- ================================================================
--- Pulse Message (JKDF2's "pulse" equivalent)
--- ================================================================
-function FirstPersonLegs:Pulse(deltaTime)
-    if not self.bInitialized or self.Enabled == 0 then
-        return
-    end
-    
-    self.PulseTimer = self.PulseTimer + deltaTime
-    if self.PulseTimer < self.PulseRate then
-        return
-    end
-    self.PulseTimer = 0
-    
-    -- Main update logic (like JKDF2 COG pulse)
-    self:Update()
-end
-
--- ================================================================
--- Update Function (JKDF2 COG pulse logic)
--- ================================================================
-function FirstPersonLegs:Update()
-    -- Check camera mode (JKDF2's GetCurrentCamera() == 1)
-    local bThirdPerson = (self.Player:GetViewMode() == 3)  -- 3 = third person
-    
-    -- Check health (JKDF2's GetThingHealth(Player) <= 0)
-    local currentHealth = self.Player:GetHealth()
-    
-    if bThirdPerson or currentHealth <= 0 then
-        if self.bLegsCreated then
-            self:DestroyLegs()
-        end
-        return
-    end
-    
-    -- Check if looking down to see legs
-    local viewAngles = self.Player:GetViewAngles()
-    local bLookingDown = viewAngles.x > 0.3  -- ~17 degrees
-    
-    if not bLookingDown then
-        if self.bLegsCreated then
-            self:DestroyLegs()
-        end
-        return
-    end
-    
-    -- Create legs if needed
+    -- Legs live for the whole session; the driver hides them while
+    -- they should not be seen
     if not self.bLegsCreated then
         self:CreateLegs()
     end
+    FirstPersonLegsDriver.Enable()
     
-    -- Update legs if active
-    if self.bLegsCreated and self.Legs then
-        self:UpdateLegs()
-    end
+    System.Log("FirstPersonLegs: System initialized")
 end
 
 -- ================================================================
@@ -170,6 +124,27 @@ function FirstPersonLegs:CreateLegs()
     -- Set render flags (only visible to local player)
     self.Legs:SetViewDistRatio(0)  -- 0 = only render for local player
     
+    -- Hand the legs to the native driver (JKDF2's SetPulse(0.01));
+    -- joints are looked up here once, not every pulse
+    local leftThighId, rightThighId = -1, -1
+    local character = self.Legs:GetCharacter(0)
+    local skeletonPose = character and character:GetISkeletonPose()
+    if skeletonPose then
+        leftThighId = skeletonPose:GetJointIDByName("Bip01 L Thigh")
+        rightThighId = skeletonPose:GetJointIDByName("Bip01 R Thigh")
+    end
+    
+    FirstPersonLegsDriver.Configure({
+        playerId = playerEntity.id,
+        legsId = self.Legs.id,
+        offset = self.Offset,
+        crouchDrop = self.CrouchDrop,
+        pulseRate = self.PulseRate,
+        lookDownPitch = self.LookDownPitch,
+        leftThighId = leftThighId,
+        rightThighId = rightThighId,
+    })
+    
     self.bLegsCreated = true
     System.Log("FirstPersonLegs: Legs created")
 end
@@ -259,89 +234,6 @@ function FirstPersonLegs:HideViaMaterial()
     end
 end
 
--- ================================================================
--- Update Legs (JKDF2's SetThingVel/SetThingLook equivalent)
--- ================================================================
-function FirstPersonLegs:UpdateLegs()
-    if not self.Legs or not self.Player then
-        return
-    end
-    
-    local playerEntity = self.Player:GetEntity()
-    if not playerEntity then
-        return
-    end
-    
-    -- Update position (slightly below player for first-person)
-    local playerPos = playerEntity:GetWorldPos()
-    local playerRot = playerEntity:GetWorldRotation()
-    
-    -- Offset (like JKDF2's position adjustment)
-    local offset = Vec3(0, -0.2, -0.5)  -- Behind and below camera
-    
-    -- Transform offset by player rotation
-    offset = playerRot:TransformVector(offset)
-    local legsPos = playerPos + offset
-    
-    self.Legs:SetWorldPos(legsPos)
-    self.Legs:SetWorldRotation(playerRot)
-    
-    -- Copy velocity (JKDF2's SetThingVel)
-    local velocity = playerEntity:GetVelocity()
-    
-    -- Handle crouching (JKDF2's IsThingCrouching check)
-    if self.Player:IsCrouching() then
-        -- Adjust for crouch
-        legsPos.z = legsPos.z - 0.3
-        self.Legs:SetWorldPos(legsPos)
-    end
-    
-    -- Simple leg animation based on movement
-    self:AnimateLegs(velocity)
-end
-
--- ================================================================
--- Animate Legs (Basic procedural animation)
--- ================================================================
-function FirstPersonLegs:AnimateLegs(velocity)
-    if not self.Legs then
-        return
-    end
-    
-    local speed = velocity:len()
-    local character = self.Legs:GetCharacter(0)
-    if not character or speed < 0.1 then
-        return
-    end
-    
-    local skeletonPose = character:GetISkeletonPose()
-    if not skeletonPose then
-        return
-    end
-    
-    -- Get current time for animation
-    local time = System.GetCurrTime()
-    
-    -- Simple leg swing animation
-    local swingAmount = math.sin(time * speed * 5) * 0.1
-    
-    -- Left leg
-    local leftLegId = skeletonPose:GetJointIDByName("Bip01 L Thigh")
-    if leftLegId >= 0 then
-        local leftTransform = skeletonPose:GetAbsJointByID(leftLegId)
-        leftTransform.q = Quat:CreateRotationX(swingAmount)
-        skeletonPose:SetAbsJointByID(leftLegId, leftTransform)
-    end
-    
-    -- Right leg (180 degrees out of phase)
-    local rightLegId = skeletonPose:GetJointIDByName("Bip01 R Thigh")
-    if rightLegId >= 0 then
-        local rightTransform = skeletonPose:GetAbsJointByID(rightLegId)
-        rightTransform.q = Quat:CreateRotationX(-swingAmount)
-        skeletonPose:SetAbsJointByID(rightLegId, rightTransform)
-    end
-end
-
 -- ================================================================
 -- Destroy Legs (JKDF2's DestroyThing equivalent)
 -- ================================================================
@@ -350,7 +242,8 @@ function FirstPersonLegs:DestroyLegs()
         return
     end
     
-    -- Remove entity
+    -- Stop driving it, then remove entity
+    FirstPersonLegsDriver.Reset()
     System.RemoveEntity(self.Legs.id)
     self.Legs = nil
     self.bLegsCreated = false
@@ -361,18 +254,43 @@ end
 -- ================================================================
 -- Console Commands (JKDF2-style testing)
 -- ================================================================
+function FirstPersonLegs.Enable()
+    FirstPersonLegs.Enabled = 1
+    if FirstPersonLegs.bLegsCreated then
+        FirstPersonLegsDriver.Enable()
+    else
+        FirstPersonLegs:Startup()
+    end
+    System.Log("FirstPersonLegs: ON")
+end
+
+function FirstPersonLegs.Disable()
+    FirstPersonLegs.Enabled = 0
+    FirstPersonLegsDriver.Disable()
+    System.Log("FirstPersonLegs: OFF")
+end
+
 function FirstPersonLegs.Toggle()
     if FirstPersonLegs.Enabled == 1 then
-        FirstPersonLegs.Enabled = 0
-        FirstPersonLegs:DestroyLegs()
-        System.Log("FirstPersonLegs: OFF")
+        FirstPersonLegs.Disable()
     else
-        FirstPersonLegs.Enabled = 1
-        FirstPersonLegs:Startup()
-        System.Log("FirstPersonLegs: ON")
+        FirstPersonLegs.Enable()
     end
 end
 
+-- Entity events (FirstPersonLegs.xml)
+function FirstPersonLegs:Event_Enable()
+    FirstPersonLegs.Enable()
+end
+
+function FirstPersonLegs:Event_Disable()
+    FirstPersonLegs.Disable()
+end
+
+function FirstPersonLegs:Event_Toggle()
+    FirstPersonLegs.Toggle()
+end
+
 function FirstPersonLegs.Debug()
     System.Log("=== FirstPersonLegs Debug ===")
     System.Log("Enabled: " .. tostring(FirstPersonLegs.Enabled))
@@ -391,8 +309,7 @@ end
 -- System Registration
 -- ================================================================
 
--- Register for updates (similar to JKDF2's pulse system)
-Script.SetUpdateHandler(FirstPersonLegs)
+-- No script update handler: the pulse runs in the native driver
 
 -- Auto-start on game load
 function OnGameStart()
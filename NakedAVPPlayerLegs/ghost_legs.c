@@ -9,6 +9,34 @@
 #include "player.h"
 #include "gamedef.h"
 #include "dynblock.h"
+#include "ghost_legs.h"
+#include "ghost_legs_walk.h"
+
+/* ================================================================
+   Visibility Thresholds
+   Legs appear once the view pitches past GL_SHOW_PITCH and stay until
+   it comes back above GL_HIDE_PITCH, so hovering around one angle does
+   not flicker them on and off.
+   ================================================================ */
+#define GL_SHOW_PITCH 3072                   // ~270 degrees (looking forward)
+#define GL_HIDE_PITCH (GL_SHOW_PITCH - 128)  // ~11 degrees of hysteresis
+
+/* ================================================================
+   Pulse Rate
+   GL_Update runs at a fixed rate regardless of frame rate; frames in
+   between draw the legs interpolated between the last two pulses.
+   ================================================================ */
+#define GL_PULSE_STEP       (ONE_FIXED / 100)  // 0.01 seconds (like JKDF2)
+#define GL_MAX_PULSE_STEPS  5                  // Catch-up limit after a stall
+
+/* ================================================================
+   Legs Pose (what a pulse produces; interpolated when drawn)
+   ================================================================ */
+typedef struct GL_LEGS_POSE
+{
+    int iCrouchDrop;                 // World vz drop while crouching
+    int iSwing[2];                   // Swing offset on leg_left/leg_right
+} GL_LEGS_POSE;
 
 /* ================================================================
    Ghost Legs State Structure
@@ -17,12 +45,32 @@ typedef struct GHOST_LEGS_SYSTEM
 {
     DISPLAYBLOCK* pLegsDisplay;      // Ghost legs display block
     STRATEGYBLOCK* pLegsStrategy;    // Ghost legs strategy block
-    int bActive;                     // Is system active?
+    int bActive;                     // Do the legs blocks exist?
+    int bVisible;                    // Are they currently drawn?
     int bInitialized;                // Is system initialized?
     VECTORCH vOffset;                // Position offset from player
     int iTorsoJointIndex;            // Torso joint to hide (-1 if not found)
     int iUpdateCounter;              // Update counter for pulse system
     int iLastPlayerHealth;           // Last known player health
+    
+    // Swing joints resolved once per cloned model (NULL if absent)
+    SECTION_DATA* pSwingSections[2]; // leg_left, leg_right
+    HMODELCONTROLLER* pResolvedHModel; // Model the handles belong to
+    
+    // Player model the legs were cloned from (rebuild when it changes)
+    int iBuiltShape;
+    HMODELCONTROLLER* pSourceHModel;
+    
+    // Fixed-rate pulse clock
+    int bPulseClockStarted;
+    int iLastPulseTime;              // Game time at the last GL_PulseSystem call
+    int iPulseAccumulator;           // Time not yet consumed by pulses
+    
+    // Pose from the previous and latest pulse
+    GL_LEGS_POSE PrevPose;
+    GL_LEGS_POSE CurrPose;
+    int iSwingPhase;
+    int iAppliedSwing[2];            // Swing currently added to each joint
 } GHOST_LEGS_SYSTEM;
 
 static GHOST_LEGS_SYSTEM GhostLegs;
@@ -55,28 +103,50 @@ void GL_InitSystem(void)
    ================================================================ */
 void GL_PulseSystem(void)
 {
-    static int iLastPulseTime = 0;
     int iCurrentTime = GetGameTime();
     
-    // Pulse every 0.01 seconds (like JKDF2)
-    if(iCurrentTime - iLastPulseTime < (ONE_FIXED / 100))
-        return;
+    // First call, or the clock went backwards (game loaded): resync
+    if(!GhostLegs.bPulseClockStarted || iCurrentTime < GhostLegs.iLastPulseTime)
+    {
+        GhostLegs.bPulseClockStarted = 1;
+        GhostLegs.iLastPulseTime = iCurrentTime;
+        GhostLegs.iPulseAccumulator = GL_PULSE_STEP; // Pulse once right away
+    }
     
-    iLastPulseTime = iCurrentTime;
+    GhostLegs.iPulseAccumulator += iCurrentTime - GhostLegs.iLastPulseTime;
+    GhostLegs.iLastPulseTime = iCurrentTime;
     
-    // Main update logic
-    GL_Update();
+    // Drop time we can't catch up on rather than spiralling
+    if(GhostLegs.iPulseAccumulator > GL_MAX_PULSE_STEPS * GL_PULSE_STEP)
+        GhostLegs.iPulseAccumulator = GL_MAX_PULSE_STEPS * GL_PULSE_STEP;
+    
+    // Zero or more fixed steps (main update logic)
+    while(GhostLegs.iPulseAccumulator >= GL_PULSE_STEP)
+    {
+        GhostLegs.PrevPose = GhostLegs.CurrPose;
+        GL_Update();
+        GhostLegs.iPulseAccumulator -= GL_PULSE_STEP;
+    }
+    
+    // Draw between the last two pulses
+    if(GhostLegs.bVisible)
+    {
+        GL_RenderLegs(DIV_FIXED(GhostLegs.iPulseAccumulator, GL_PULSE_STEP));
+    }
 }
 
 /* ================================================================
    Main Update Function (JKDF2's "pulse" equivalent)
+   The legs blocks are created once and kept for the life of the
+   player; per-pulse work only flips visibility. They are rebuilt only
+   when the player's model changes.
    ================================================================ */
 void GL_Update(void)
 {
     // Check if system should be active
     if(!g_iFirstPersonLegsEnabled || !Player || !Player->ObStrategyBlock)
     {
-        GL_DestroyLegs();
+        GL_SetLegsVisible(0);
         return;
     }
     
@@ -89,23 +159,66 @@ void GL_Update(void)
     
     int bShouldShowLegs = GL_ShouldShowLegs(pPlayerStatus);
     
-    if(bShouldShowLegs && !GhostLegs.bActive)
+    // Player model swapped (creature change, respawn as another class)
+    if(GhostLegs.bActive && GL_LegsNeedRebuild())
     {
-        // Create legs (like JKDF2's CreateThing/FireProjectile)
-        GL_CreateLegs();
+        GL_DestroyLegs();
     }
-    else if(!bShouldShowLegs && GhostLegs.bActive)
+    
+    if(bShouldShowLegs && !GhostLegs.bActive)
     {
-        // Destroy legs (like JKDF2's DestroyThing)
-        GL_DestroyLegs();
+        // Create legs once (like JKDF2's CreateThing/FireProjectile)
+        GL_CreateLegs();
     }
     
-    // Update legs if active
-    if(GhostLegs.bActive)
+    int bWasVisible = GhostLegs.bVisible;
+    GL_SetLegsVisible(bShouldShowLegs);
+    
+    // Update legs if visible
+    if(GhostLegs.bVisible)
     {
         GL_UpdateLegsPosition();
         GL_UpdateLegsAnimation();
+        
+        // Just shown: nothing sensible to interpolate from
+        if(!bWasVisible)
+            GhostLegs.PrevPose = GhostLegs.CurrPose;
+    }
+}
+
+/* ================================================================
+   Show/Hide Legs (JKDF2's ThingHidden equivalent)
+   ================================================================ */
+void GL_SetLegsVisible(int bVisible)
+{
+    if(!GhostLegs.bActive || !GhostLegs.pLegsDisplay)
+    {
+        GhostLegs.bVisible = 0;
+        return;
     }
+    
+    bVisible = bVisible ? 1 : 0;
+    if(GhostLegs.bVisible == bVisible)
+        return;
+    
+    if(bVisible)
+        GhostLegs.pLegsDisplay->ObFlags &= ~ObFlag_NotVis;
+    else
+        GhostLegs.pLegsDisplay->ObFlags |= ObFlag_NotVis;
+    
+    GhostLegs.bVisible = bVisible;
+}
+
+/* ================================================================
+   Has the Player Model Changed Since the Legs Were Cloned?
+   ================================================================ */
+int GL_LegsNeedRebuild(void)
+{
+    if(!GhostLegs.bActive || !Player)
+        return 0;
+    
+    return Player->ObShape != GhostLegs.iBuiltShape ||
+           Player->HModelControlBlock != GhostLegs.pSourceHModel;
 }
 
 /* ================================================================
@@ -122,10 +235,10 @@ int GL_ShouldShowLegs(PLAYER_STATUS* pPlayerStatus)
     if(GhostLegs.iLastPlayerHealth == -1)
         GhostLegs.iLastPlayerHealth = iCurrentHealth;
     
-    // If player just died, destroy legs immediately
+    // If player just died, hide legs immediately (kept for respawn)
     if(iCurrentHealth <= 0 && GhostLegs.iLastPlayerHealth > 0)
     {
-        GL_DestroyLegs();
+        GL_SetLegsVisible(0);
     }
     
     GhostLegs.iLastPlayerHealth = iCurrentHealth;
@@ -135,8 +248,10 @@ int GL_ShouldShowLegs(PLAYER_STATUS* pPlayerStatus)
     if(MultiplayerObservedPlayer)
         return 0;
     
-    // Check if looking down enough to see legs
-    if(HeadOrientation.EulerX < 3072) // ~270 degrees (looking forward)
+    // Check if looking down enough to see legs; once shown, the view
+    // has to come back past the lower threshold before they hide
+    int iThreshold = GhostLegs.bVisible ? GL_HIDE_PITCH : GL_SHOW_PITCH;
+    if(HeadOrientation.EulerX < iThreshold)
         return 0;
     
     return 1;
@@ -160,7 +275,7 @@ void GL_CreateLegs(void)
     
     // Copy player model/shape
     GhostLegs.pLegsDisplay->ObShape = iPlayerModel;
-    GhostLegs.pLegsDisplay->ObFlags &= ~ObFlag_NotVis; // Make visible
+    GhostLegs.pLegsDisplay->ObFlags |= ObFlag_NotVis; // Hidden until GL_SetLegsVisible
     
     // Create strategy block for legs
     GhostLegs.pLegsStrategy = CreateStrategyBlock();
@@ -185,6 +300,9 @@ void GL_CreateLegs(void)
         
         // Find torso joint to hide (JKDF2's AmputateJoint(2))
         GL_FindAndHideTorso();
+        
+        // Look up swing joints once instead of every pulse
+        GL_ResolveLegJoints();
     }
     
     // Set physics flags (like JKDF2's SetPhysicsFlags)
@@ -198,6 +316,11 @@ void GL_CreateLegs(void)
     AddToActiveBlockList(GhostLegs.pLegsDisplay);
     
     GhostLegs.bActive = 1;
+    GhostLegs.bVisible = 0;
+    GhostLegs.iAppliedSwing[0] = 0;
+    GhostLegs.iAppliedSwing[1] = 0;
+    GhostLegs.iBuiltShape = iPlayerModel;
+    GhostLegs.pSourceHModel = Player->HModelControlBlock;
     
     #ifdef _DEBUG
     textprint("First-person legs created\n");
@@ -205,81 +328,200 @@ void GL_CreateLegs(void)
 }
 
 /* ================================================================
-   Find and Hide Torso (JKDF2's AmputateJoint(2) equivalent)
+   Section Hide Mask Cache
    ================================================================ */
-void GL_FindAndHideTorso(void)
+typedef struct GL_HIDE_MASK_ENTRY
 {
-    if(!GhostLegs.pLegsDisplay || !GhostLegs.pLegsDisplay->HModelControlBlock)
+    int bUsed;
+    int iShape;
+    const void* pRules;
+    GL_HIDE_MASK Mask;
+} GL_HIDE_MASK_ENTRY;
+
+static GL_HIDE_MASK_ENTRY HideMaskCache[GL_HIDE_MASK_CACHE];
+static int iHideMaskNextSlot = 0;
+
+void GL_HideMaskAddSection(GL_HIDE_MASK* pMask, const SECTION_DATA* pSection)
+{
+    if(!pSection)
         return;
     
-    HMODELCONTROLLER* pHModel = GhostLegs.pLegsDisplay->HModelControlBlock;
-    SECTION_DATA* pSectionData = pHModel->section_data;
+    if(pSection->idx < 0 || pSection->idx >= GL_MAX_SECTIONS)
+    {
+        #ifdef _DEBUG
+        textprint("Hide mask: section %s index %d out of range\n",
+                 pSection->name ? pSection->name : "?", pSection->idx);
+        #endif
+        return;
+    }
     
+    pMask->aBits[pSection->idx >> 5] |= 1u << (pSection->idx & 31);
+}
+
+void GL_HideMaskAddNamed(GL_HIDE_MASK* pMask, HMODELCONTROLLER* pHModel,
+                         const char* const* ppNames, int iMaxNames)
+{
+    for(int i = 0; i < iMaxNames && ppNames[i]; i++)
+    {
+        GL_HideMaskAddSection(pMask, GetThisSectionData(pHModel->section_data, ppNames[i]));
+    }
+}
+
+const GL_HIDE_MASK* GL_GetHideMask(int iShape, const void* pRules,
+                                   HMODELCONTROLLER* pHModel, GL_HIDE_MASK_BUILDER pfnBuild)
+{
+    for(int i = 0; i < GL_HIDE_MASK_CACHE; i++)
+    {
+        GL_HIDE_MASK_ENTRY* pEntry = &HideMaskCache[i];
+        if(pEntry->bUsed && pEntry->iShape == iShape && pEntry->pRules == pRules)
+            return &pEntry->Mask;
+    }
+    
+    // Miss: build into the next slot (oldest entry is replaced when full)
+    GL_HIDE_MASK_ENTRY* pEntry = &HideMaskCache[iHideMaskNextSlot];
+    iHideMaskNextSlot = (iHideMaskNextSlot + 1) % GL_HIDE_MASK_CACHE;
+    
+    memset(pEntry, 0, sizeof(GL_HIDE_MASK_ENTRY));
+    pEntry->iShape = iShape;
+    pEntry->pRules = pRules;
+    pEntry->Mask.iTorsoIndex = -1;
+    pfnBuild(pHModel, &pEntry->Mask, pRules);
+    pEntry->bUsed = 1;
+    
+    return &pEntry->Mask;
+}
+
+void GL_ApplyHideMask(HMODELCONTROLLER* pHModel, const GL_HIDE_MASK* pMask)
+{
+    for(SECTION_DATA* pSection = pHModel->section_data; pSection; pSection = pSection->next)
+    {
+        int idx = pSection->idx;
+        if(idx >= 0 && idx < GL_MAX_SECTIONS &&
+           (pMask->aBits[idx >> 5] & (1u << (idx & 31))))
+        {
+            pSection->flags |= SECTION_HIDDEN;
+        }
+    }
+}
+
+// Call when shapes are reloaded (level change)
+void GL_FlushHideMasks(void)
+{
+    memset(HideMaskCache, 0, sizeof(HideMaskCache));
+    iHideMaskNextSlot = 0;
+}
+
+/* ================================================================
+   Upper Body Hide Rules
+   ================================================================ */
+// Parts to hide (only leave legs visible)
+static const char* const UpperBodyParts[] = {
+    "head", "neck", "helmet",
+    "arm_left", "arm_right", "shoulder_left", "shoulder_right",
+    "hand_left", "hand_right",
+    "weapon", "item",
+    NULL
+};
+
+static void GL_BuildUpperBodyHideMask(HMODELCONTROLLER* pHModel, GL_HIDE_MASK* pMask,
+                                      const void* pRules)
+{
     // Look for torso section (equivalent to joint 2 in JKDF2)
-    while(pSectionData)
+    for(SECTION_DATA* pSectionData = pHModel->section_data; pSectionData; pSectionData = pSectionData->next)
     {
-        // Check section name for torso
         if(pSectionData->name && 
            (strstr(pSectionData->name, "torso") || 
             strstr(pSectionData->name, "chest") ||
             strstr(pSectionData->name, "spine")))
         {
-            GhostLegs.iTorsoJointIndex = pSectionData->idx;
-            
-            // Hide it (AvP equivalent of AmputateJoint)
-            pSectionData->flags |= SECTION_HIDDEN;
-            
-            #ifdef _DEBUG
-            textprint("Hidden torso joint: %s (index %d)\n", 
-                     pSectionData->name, pSectionData->idx);
-            #endif
+            pMask->iTorsoIndex = pSectionData->idx;
+            GL_HideMaskAddSection(pMask, pSectionData);
             break;
         }
-        
-        pSectionData = pSectionData->next;
     }
     
     // Also hide arms and head
-    GL_HideUpperBodyParts();
+    GL_HideMaskAddNamed(pMask, pHModel, UpperBodyParts, GL_MAX_SECTIONS);
 }
 
 /* ================================================================
-   Hide Upper Body Parts
+   Find and Hide Torso (JKDF2's AmputateJoint(2) equivalent)
    ================================================================ */
-void GL_HideUpperBodyParts(void)
+void GL_FindAndHideTorso(void)
 {
     if(!GhostLegs.pLegsDisplay || !GhostLegs.pLegsDisplay->HModelControlBlock)
         return;
     
     HMODELCONTROLLER* pHModel = GhostLegs.pLegsDisplay->HModelControlBlock;
     
-    // Parts to hide (only leave legs visible)
-    const char* partsToHide[] = {
-        "head", "neck", "helmet",
-        "arm_left", "arm_right", "shoulder_left", "shoulder_right",
-        "hand_left", "hand_right",
-        "weapon", "item",
-        NULL
-    };
+    // Name matching only runs the first time this shape is seen
+    const GL_HIDE_MASK* pMask = GL_GetHideMask(GhostLegs.pLegsDisplay->ObShape, UpperBodyParts,
+                                               pHModel, GL_BuildUpperBodyHideMask);
     
-    for(int i = 0; partsToHide[i]; i++)
-    {
-        SECTION_DATA* pSection = GetThisSectionData(pHModel->section_data, partsToHide[i]);
-        if(pSection)
-        {
-            pSection->flags |= SECTION_HIDDEN;
-        }
-    }
+    // Hide it (AvP equivalent of AmputateJoint)
+    GL_ApplyHideMask(pHModel, pMask);
+    GhostLegs.iTorsoJointIndex = pMask->iTorsoIndex;
+    
+    #ifdef _DEBUG
+    textprint("Hidden torso joint index %d\n", GhostLegs.iTorsoJointIndex);
+    #endif
 }
 
 /* ================================================================
-   Update Legs Position (JKDF2's SetThingVel/Look equivalent)
+   Resolve Swing Joint Handles
+   ================================================================ */
+void GL_ResolveLegJoints(void)
+{
+    GhostLegs.pSwingSections[0] = NULL;
+    GhostLegs.pSwingSections[1] = NULL;
+    GhostLegs.pResolvedHModel = NULL;
+    
+    if(!GhostLegs.pLegsDisplay || !GhostLegs.pLegsDisplay->HModelControlBlock)
+        return;
+    
+    HMODELCONTROLLER* pHModel = GhostLegs.pLegsDisplay->HModelControlBlock;
+    
+    GhostLegs.pSwingSections[0] = GetThisSectionData(pHModel->section_data, "leg_left");
+    GhostLegs.pSwingSections[1] = GetThisSectionData(pHModel->section_data, "leg_right");
+    GhostLegs.pResolvedHModel = pHModel;
+}
+
+/* ================================================================
+   Update Legs Position (pulse)
    ================================================================ */
 void GL_UpdateLegsPosition(void)
 {
     if(!GhostLegs.bActive || !GhostLegs.pLegsDisplay || !Player)
         return;
     
+    // Handle crouching (like JKDF2's IsThingCrouching check)
+    PLAYER_STATUS* pPlayerStatus = (PLAYER_STATUS*)Player->ObStrategyBlock->SBdataptr;
+    if(pPlayerStatus && pPlayerStatus->ShapeState == PMph_Crouching)
+        GhostLegs.CurrPose.iCrouchDrop = 40 * ONE_FIXED;
+    else
+        GhostLegs.CurrPose.iCrouchDrop = 0;
+}
+
+/* ================================================================
+   Place Legs for Drawing (JKDF2's SetThingVel/Look equivalent)
+   Called every frame with how far (0..ONE_FIXED) we are between the
+   previous and latest pulse. The block is attached to the view, so it
+   follows the player's current transform; the pulse-driven parts of
+   the pose are interpolated on top.
+   ================================================================ */
+static int GL_Lerp(int iFrom, int iTo, int iAlpha)
+{
+    return iFrom + MUL_FIXED(iTo - iFrom, iAlpha);
+}
+
+void GL_RenderLegs(int iAlpha)
+{
+    if(!GhostLegs.bActive || !GhostLegs.pLegsDisplay || !Player)
+        return;
+    
+    const GL_LEGS_POSE* pPrev = &GhostLegs.PrevPose;
+    const GL_LEGS_POSE* pCurr = &GhostLegs.CurrPose;
+    
     // Get player position and orientation
     VECTORCH vPlayerPos = Player->ObWorld;
     MATRIXCH mPlayerOrientation = Player->ObMat;
@@ -289,6 +531,9 @@ void GL_UpdateLegsPosition(void)
     RotateVectorByMatrix(&vLegsPos, &mPlayerOrientation, &vLegsPos);
     vLegsPos = AddVectors(&vPlayerPos, &vLegsPos);
     
+    // Adjust legs for crouching
+    vLegsPos.vz -= GL_Lerp(pPrev->iCrouchDrop, pCurr->iCrouchDrop, iAlpha);
+    
     // Set legs position
     GhostLegs.pLegsDisplay->ObWorld = vLegsPos;
     
@@ -305,12 +550,19 @@ void GL_UpdateLegsPosition(void)
         GhostLegs.pLegsDisplay->ObVel = pDyn->LinVelocity;
     }
     
-    // Handle crouching (like JKDF2's IsThingCrouching check)
-    PLAYER_STATUS* pPlayerStatus = (PLAYER_STATUS*)Player->ObStrategyBlock->SBdataptr;
-    if(pPlayerStatus && pPlayerStatus->ShapeState == PMph_Crouching)
+    // Leg swing: replace what was applied last frame with the
+    // interpolated value
+    for(int i = 0; i < 2; i++)
     {
-        // Adjust legs for crouching
-        GhostLegs.pLegsDisplay->ObWorld.vz -= 40 * ONE_FIXED;
+        SECTION_DATA* pLeg = GhostLegs.pSwingSections[i];
+        if(!pLeg)
+            continue;
+        
+        int iSwing = GL_Lerp(pPrev->iSwing[i], pCurr->iSwing[i], iAlpha);
+        
+        // Note: This is simplified - real implementation would modify joint matrices
+        pLeg->World_Offset.vy += iSwing - GhostLegs.iAppliedSwing[i];
+        GhostLegs.iAppliedSwing[i] = iSwing;
     }
 }
 
@@ -347,33 +599,25 @@ void GL_AnimateLegSwing(int iSpeed)
     if(!GhostLegs.pLegsDisplay || !GhostLegs.pLegsDisplay->HModelControlBlock)
         return;
     
-    static int iSwingPhase = 0;
-    iSwingPhase += iSpeed / 1000;
-    
-    // Apply swing to leg joints
-    HMODELCONTROLLER* pHModel = GhostLegs.pLegsDisplay->HModelControlBlock;
+    GhostLegs.iSwingPhase += iSpeed / 1000;
     
-    // Find leg joints
-    const char* legJoints[] = {"leg_left", "leg_right", NULL};
+    // Rebuild handles only if the model was swapped
+    if(GhostLegs.pResolvedHModel != GhostLegs.pLegsDisplay->HModelControlBlock)
+        GL_ResolveLegJoints();
     
-    for(int i = 0; legJoints[i]; i++)
+    // Swing for each leg joint; GL_RenderLegs applies it to the model
+    for(int i = 0; i < 2; i++)
     {
-        SECTION_DATA* pLeg = GetThisSectionData(pHModel->section_data, legJoints[i]);
-        if(pLeg)
-        {
-            // Calculate swing amount
-            int iSwing = GetSin((iSwingPhase + (i * 32768)) & 65535);
-            iSwing = MUL_FIXED(iSwing, iSpeed / 5000);
-            
-            // Apply rotation to leg
-            // Note: This is simplified - real implementation would modify joint matrices
-            pLeg->World_Offset.vy += iSwing;
-        }
+        // Calculate swing amount
+        int iSwing = GetSin((GhostLegs.iSwingPhase + (i * 32768)) & 65535);
+        GhostLegs.CurrPose.iSwing[i] = MUL_FIXED(iSwing, iSpeed / 5000);
     }
 }
 
 /* ================================================================
    Destroy Legs (JKDF2's DestroyThing equivalent)
+   Only for model changes and GL_ShutdownSystem; use GL_SetLegsVisible
+   to hide them during play.
    ================================================================ */
 void GL_DestroyLegs(void)
 {
@@ -404,13 +648,32 @@ void GL_DestroyLegs(void)
     GhostLegs.pLegsDisplay = NULL;
     GhostLegs.pLegsStrategy = NULL;
     GhostLegs.bActive = 0;
+    GhostLegs.bVisible = 0;
     GhostLegs.iTorsoJointIndex = -1;
+    GhostLegs.iBuiltShape = 0;
+    GhostLegs.pSourceHModel = NULL;
+    GhostLegs.pSwingSections[0] = NULL;
+    GhostLegs.pSwingSections[1] = NULL;
+    GhostLegs.pResolvedHModel = NULL;
     
     #ifdef _DEBUG
     textprint("First-person legs destroyed\n");
     #endif
 }
 
+/* ================================================================
+   Shutdown (level unload); frees the persistent legs blocks
+   ================================================================ */
+void GL_ShutdownSystem(void)
+{
+    GL_DestroyLegs();
+    GL_FlushHideMasks();
+    GL_ShutdownNPCLegs();
+    GL_ShutdownFootsteps();
+    GLW_Shutdown();
+    GhostLegs.bInitialized = 0;
+}
+
 /* ================================================================
    Console Commands (for testing)
    ================================================================ */
@@ -420,7 +683,7 @@ void GL_Toggle(void)
     
     if(!g_iFirstPersonLegsEnabled)
     {
-        GL_DestroyLegs();
+        GL_SetLegsVisible(0);
     }
     
     textprint("First-person legs: %s\n", 
@@ -432,6 +695,7 @@ void GL_Debug(void)
     textprint("=== First-Person Legs Debug ===\n");
     textprint("Enabled: %d\n", g_iFirstPersonLegsEnabled);
     textprint("Active: %d\n", GhostLegs.bActive);
+    textprint("Visible: %d\n", GhostLegs.bVisible);
     textprint("Initialized: %d\n", GhostLegs.bInitialized);
     textprint("Torso Joint Index: %d\n", GhostLegs.iTorsoJointIndex);
     
@@ -0,0 +1,76 @@
+/* ================================================================
+   File: ghost_legs.h
+   JKDF2-style first-person legs for AvP Classic
+   ================================================================ */
+
+#ifndef GHOST_LEGS_H
+#define GHOST_LEGS_H
+
+/* ================================================================
+   Public Interface (ghost_legs.c)
+   ================================================================ */
+void GL_InitSystem(void);
+void GL_ShutdownSystem(void);
+void GL_PulseSystem(void);
+void GL_SetLegsVisible(int bVisible);
+void GL_Toggle(void);
+void GL_Debug(void);
+
+/* ================================================================
+   NPC Creature Legs (ghost_legs_creatures.c)
+   GL_NPCLegsTouch from AlienBehaviour()/PredatorBehaviour() each
+   update, GL_NPCLegsRelease when the NPC is destroyed, and
+   GL_UpdateNPCLegs once per frame after the behaviours have run.
+   ================================================================ */
+void GL_NPCLegsTouch(STRATEGYBLOCK* pSB);
+void GL_NPCLegsRelease(STRATEGYBLOCK* pSB);
+void GL_UpdateNPCLegs(void);
+void GL_ShutdownNPCLegs(void);
+
+/* ================================================================
+   Footsteps (ghost_legs_footsteps.c)
+   The legs queue each foot that touches down; GL_FlushFootsteps plays
+   the queued steps once per frame. Sources are GL_FOOTSTEP_PLAYER or
+   GL_FOOTSTEP_NPC(slot); pBody is skipped by the surface probe.
+   ================================================================ */
+#define GL_FOOTSTEP_PLAYER          0
+#define GL_FOOTSTEP_NPC(iSlot)      (1 + (iSlot))
+
+void GL_QueueFootstep(int iSource, int iSpecies, int iLeg,
+                      const VECTORCH* pFoot, DISPLAYBLOCK* pBody);
+void GL_FlushFootsteps(void);
+void GL_ShutdownFootsteps(void);
+void GL_FootstepDebug(void);
+
+/* ================================================================
+   Section Hide Masks
+   The set of sections to hide depends only on the model shape and the
+   rules used to pick them, so it is built once per (shape, rules) pair
+   into a bitmask indexed by SECTION_DATA::idx and cached. Applying it
+   to a fresh clone is then a single pass with no name lookups.
+   ================================================================ */
+#define GL_MAX_SECTIONS     256
+#define GL_HIDE_MASK_WORDS  (GL_MAX_SECTIONS / 32)
+#define GL_HIDE_MASK_CACHE  32      // Distinct (shape, rules) pairs kept
+
+typedef struct GL_HIDE_MASK
+{
+    unsigned int aBits[GL_HIDE_MASK_WORDS];
+    int iTorsoIndex;                // First torso section found (-1 if none)
+} GL_HIDE_MASK;
+
+// Fills pMask for pHModel; pRules identifies the rule set
+typedef void (*GL_HIDE_MASK_BUILDER)(HMODELCONTROLLER* pHModel, GL_HIDE_MASK* pMask,
+                                     const void* pRules);
+
+const GL_HIDE_MASK* GL_GetHideMask(int iShape, const void* pRules,
+                                   HMODELCONTROLLER* pHModel, GL_HIDE_MASK_BUILDER pfnBuild);
+void GL_ApplyHideMask(HMODELCONTROLLER* pHModel, const GL_HIDE_MASK* pMask);
+void GL_FlushHideMasks(void);
+
+// Helpers for builders
+void GL_HideMaskAddSection(GL_HIDE_MASK* pMask, const SECTION_DATA* pSection);
+void GL_HideMaskAddNamed(GL_HIDE_MASK* pMask, HMODELCONTROLLER* pHModel,
+                         const char* const* ppNames, int iMaxNames);
+
+#endif // GHOST_LEGS_H
@@ -10,24 +10,46 @@
 #include "gamedef.h"
 #include "dynblock.h"
 #include "weapons.h"
+#include "ghost_legs.h"
+#include "ghost_legs_walk.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* ================================================================
    Creature-Specific Leg Definitions
+   Loaded from GL_CREATURE_CONFIG_FILE at startup and compiled into the
+   flat tables below; the built-in definitions further down are used
+   when the file is missing or fails validation.
    ================================================================ */
+#define GL_CREATURE_CONFIG_FILE "creature_legs.txt"
+
+#define GL_MAX_LEGS             6       // iLegPhases etc. are sized for this
+#define GL_MAX_LEG_JOINTS       24      // Longest legs list per creature
+#define GL_MAX_CREATURE_CONFIGS 16
+#define GL_MAX_JOINT_NAMES      512     // All lists of all creatures
+#define GL_JOINT_NAME_POOL      8192    // Characters for those names
+#define GL_MAX_CREATURE_NAME    32
+#define GL_MAX_OWN_MATERIALS    16      // Sections whose material the legs change
+
 typedef struct CREATURE_LEG_CONFIG
 {
+    char szName[GL_MAX_CREATURE_NAME]; // Section name in the config file
+    
     // Basic settings
     VECTORCH vOffset;                // Position offset
     VECTORCH vLegOffsetLeft;         // Left leg position offset
     VECTORCH vLegOffsetRight;        // Right leg position offset
     int iLegCount;                   // Number of legs (2, 4, 6)
     
-    // Joint names to hide (creature-specific)
-    const char** pJointsToHide;
+    // Joint names to hide (creature-specific); a run of the shared name table
+    const char* const* pJointsToHide;
     int iNumJointsToHide;
     
-    // Joint names to keep visible (legs)
-    const char** pLegJoints;
+    // Joint names to keep visible (legs); a run of the shared name table
+    const char* const* pLegJoints;
     int iNumLegJoints;
     
     // Animation parameters
@@ -36,10 +58,53 @@ typedef struct CREATURE_LEG_CONFIG
     int bCanCrawlWalls;             // Wall-crawling ability
 } CREATURE_LEG_CONFIG;
 
+/* ================================================================
+   Compiled Creature Tables
+   Every joint name of every creature lives in one string pool, and the
+   per-creature lists are contiguous runs of apJointNames, so configs
+   are plain indices into packed arrays.
+   ================================================================ */
+typedef struct CREATURE_LEG_TABLES
+{
+    CREATURE_LEG_CONFIG aConfigs[GL_MAX_CREATURE_CONFIGS];
+    int iNumConfigs;
+    
+    const char* apJointNames[GL_MAX_JOINT_NAMES];
+    int iNumJointNames;
+    
+    char acNamePool[GL_JOINT_NAME_POOL];
+    int iNamePoolUsed;
+    
+    // Configs for AvP.PlayerType (I_Marine, I_Alien, I_Predator)
+    CREATURE_LEG_CONFIG* pSpeciesConfigs[3];
+    int bLoaded;
+    int bFromFile;
+} CREATURE_LEG_TABLES;
+
+static CREATURE_LEG_TABLES CreatureTables;
+
+/* ================================================================
+   Built-in Definitions (fallback)
+   ================================================================ */
+typedef struct CREATURE_LEG_SOURCE
+{
+    const char* pName;
+    VECTORCH vOffset;
+    VECTORCH vLegOffsetLeft;
+    VECTORCH vLegOffsetRight;
+    int iLegCount;
+    const char* const* ppJointsToHide;   // NULL-terminated
+    const char* const* ppExtraHide;      // NULL-terminated, optional
+    const char* const* ppLegJoints;      // NULL-terminated
+    int iSwingMultiplier;
+    int iStepHeight;
+    int bCanCrawlWalls;
+} CREATURE_LEG_SOURCE;
+
 /* ================================================================
    Marine Configuration (Human Biped)
    ================================================================ */
-static const char* MarineJointsToHide[] = {
+static const char* const MarineJointsToHide[] = {
     "torso", "chest", "spine1", "spine2",
     "neck", "head", "helmet",
     "shoulder_left", "shoulder_right",
@@ -49,31 +114,17 @@ static const char* MarineJointsToHide[] = {
     NULL
 };
 
-static const char* MarineLegJoints[] = {
+static const char* const MarineLegJoints[] = {
     "leg_left_upper", "leg_left_lower", "leg_left_foot",
     "leg_right_upper", "leg_right_lower", "leg_right_foot",
     "pelvis", "hip_left", "hip_right",
     NULL
 };
 
-static CREATURE_LEG_CONFIG MarineConfig = {
-    .vOffset = {0, -30 * ONE_FIXED, -60 * ONE_FIXED}, // Behind and below
-    .vLegOffsetLeft = {-20 * ONE_FIXED, 40 * ONE_FIXED, 0},
-    .vLegOffsetRight = {20 * ONE_FIXED, 40 * ONE_FIXED, 0},
-    .iLegCount = 2,
-    .pJointsToHide = MarineJointsToHide,
-    .iNumJointsToHide = 14,
-    .pLegJoints = MarineLegJoints,
-    .iNumLegJoints = 9,
-    .iSwingMultiplier = 12000,       // Moderate leg swing
-    .iStepHeight = 18 * ONE_FIXED,   // 18 unit step
-    .bCanCrawlWalls = 0
-};
-
 /* ================================================================
    Alien Configuration (Xenomorph - 6 legs)
    ================================================================ */
-static const char* AlienJointsToHide[] = {
+static const char* const AlienJointsToHide[] = {
     "torso", "chest", "spine", "spine1", "spine2", "spine3",
     "neck", "head", "jaw", "teeth",
     "arm_left", "arm_right", "claw_left", "claw_right",
@@ -81,7 +132,15 @@ static const char* AlienJointsToHide[] = {
     NULL
 };
 
-static const char* AlienLegJoints[] = {
+// Alien has special parts to hide
+static const char* const AlienSpecialParts[] = {
+    "inner_jaw", "tongue",
+    "acid_sac", "acid_drool",
+    "ovipositor", "egg_sac",
+    NULL
+};
+
+static const char* const AlienLegJoints[] = {
     // 6 legs: front, middle, back pairs
     "leg_front_left_upper", "leg_front_left_lower", "leg_front_left_foot",
     "leg_front_right_upper", "leg_front_right_lower", "leg_front_right_foot",
@@ -93,24 +152,10 @@ static const char* AlienLegJoints[] = {
     NULL
 };
 
-static CREATURE_LEG_CONFIG AlienConfig = {
-    .vOffset = {0, -40 * ONE_FIXED, -80 * ONE_FIXED}, // Lower for crouched stance
-    .vLegOffsetLeft = {-30 * ONE_FIXED, 60 * ONE_FIXED, -20 * ONE_FIXED},
-    .vLegOffsetRight = {30 * ONE_FIXED, 60 * ONE_FIXED, -20 * ONE_FIXED},
-    .iLegCount = 6,
-    .pJointsToHide = AlienJointsToHide,
-    .iNumJointsToHide = 17,
-    .pLegJoints = AlienLegJoints,
-    .iNumLegJoints = 20,
-    .iSwingMultiplier = 8000,        // Subtle leg swing (crouched)
-    .iStepHeight = 12 * ONE_FIXED,   // Lower step (crawls over)
-    .bCanCrawlWalls = 1
-};
-
 /* ================================================================
    Predator Configuration (Tall Biped)
    ================================================================ */
-static const char* PredatorJointsToHide[] = {
+static const char* const PredatorJointsToHide[] = {
     "torso", "chest", "spine", "spine1", "spine2",
     "neck", "head", "mask", "dreads",
     "shoulder_left", "shoulder_right",
@@ -122,7 +167,15 @@ static const char* PredatorJointsToHide[] = {
     NULL
 };
 
-static const char* PredatorLegJoints[] = {
+// Predator has equipment to hide
+static const char* const PredatorEquipment[] = {
+    "bio_mask", "laser_sight",
+    "cloak_generator", "energy_cells",
+    "medicomp", "self_destruct",
+    NULL
+};
+
+static const char* const PredatorLegJoints[] = {
     "leg_left_upper", "leg_left_lower", "leg_left_foot",
     "leg_right_upper", "leg_right_lower", "leg_right_foot",
     "pelvis", "hip_left", "hip_right",
@@ -131,20 +184,397 @@ static const char* PredatorLegJoints[] = {
     NULL
 };
 
-static CREATURE_LEG_CONFIG PredatorConfig = {
-    .vOffset = {0, -50 * ONE_FIXED, -100 * ONE_FIXED}, // Taller, further back
-    .vLegOffsetLeft = {-25 * ONE_FIXED, 50 * ONE_FIXED, 10 * ONE_FIXED},
-    .vLegOffsetRight = {25 * ONE_FIXED, 50 * ONE_FIXED, 10 * ONE_FIXED},
-    .iLegCount = 2,
-    .pJointsToHide = PredatorJointsToHide,
-    .iNumJointsToHide = 21,
-    .pLegJoints = PredatorLegJoints,
-    .iNumLegJoints = 13,
-    .iSwingMultiplier = 15000,       // Powerful leg swing
-    .iStepHeight = 24 * ONE_FIXED,   // High step
-    .bCanCrawlWalls = 0
+static const CREATURE_LEG_SOURCE BuiltinCreatures[] = {
+    {
+        .pName = "marine",
+        .vOffset = {0, -30 * ONE_FIXED, -60 * ONE_FIXED}, // Behind and below
+        .vLegOffsetLeft = {-20 * ONE_FIXED, 40 * ONE_FIXED, 0},
+        .vLegOffsetRight = {20 * ONE_FIXED, 40 * ONE_FIXED, 0},
+        .iLegCount = 2,
+        .ppJointsToHide = MarineJointsToHide,
+        .ppLegJoints = MarineLegJoints,
+        .iSwingMultiplier = 12000,       // Moderate leg swing
+        .iStepHeight = 18 * ONE_FIXED,   // 18 unit step
+        .bCanCrawlWalls = 0
+    },
+    {
+        .pName = "alien",
+        .vOffset = {0, -40 * ONE_FIXED, -80 * ONE_FIXED}, // Lower for crouched stance
+        .vLegOffsetLeft = {-30 * ONE_FIXED, 60 * ONE_FIXED, -20 * ONE_FIXED},
+        .vLegOffsetRight = {30 * ONE_FIXED, 60 * ONE_FIXED, -20 * ONE_FIXED},
+        .iLegCount = 6,
+        .ppJointsToHide = AlienJointsToHide,
+        .ppExtraHide = AlienSpecialParts,
+        .ppLegJoints = AlienLegJoints,
+        .iSwingMultiplier = 8000,        // Subtle leg swing (crouched)
+        .iStepHeight = 12 * ONE_FIXED,   // Lower step (crawls over)
+        .bCanCrawlWalls = 1
+    },
+    {
+        .pName = "predator",
+        .vOffset = {0, -50 * ONE_FIXED, -100 * ONE_FIXED}, // Taller, further back
+        .vLegOffsetLeft = {-25 * ONE_FIXED, 50 * ONE_FIXED, 10 * ONE_FIXED},
+        .vLegOffsetRight = {25 * ONE_FIXED, 50 * ONE_FIXED, 10 * ONE_FIXED},
+        .iLegCount = 2,
+        .ppJointsToHide = PredatorJointsToHide,
+        .ppExtraHide = PredatorEquipment,
+        .ppLegJoints = PredatorLegJoints,
+        .iSwingMultiplier = 15000,       // Powerful leg swing
+        .iStepHeight = 24 * ONE_FIXED,   // High step
+        .bCanCrawlWalls = 0
+    }
 };
 
+/* ================================================================
+   Table Building
+   ================================================================ */
+static void GL_ResetCreatureTables(void)
+{
+    memset(&CreatureTables, 0, sizeof(CREATURE_LEG_TABLES));
+}
+
+// Append a name to the shared table; returns 0 when a table is full
+static int GL_AddJointName(const char* pName)
+{
+    int iLength = (int)strlen(pName) + 1;
+    
+    if(CreatureTables.iNumJointNames >= GL_MAX_JOINT_NAMES ||
+       CreatureTables.iNamePoolUsed + iLength > GL_JOINT_NAME_POOL)
+        return 0;
+    
+    char* pCopy = &CreatureTables.acNamePool[CreatureTables.iNamePoolUsed];
+    memcpy(pCopy, pName, iLength);
+    CreatureTables.iNamePoolUsed += iLength;
+    
+    CreatureTables.apJointNames[CreatureTables.iNumJointNames++] = pCopy;
+    return 1;
+}
+
+static int GL_AddJointList(const char* const* ppNames)
+{
+    for(int i = 0; ppNames && ppNames[i]; i++)
+    {
+        if(!GL_AddJointName(ppNames[i]))
+            return 0;
+    }
+    return 1;
+}
+
+static CREATURE_LEG_CONFIG* GL_FindConfigByName(const char* pName)
+{
+    for(int i = 0; i < CreatureTables.iNumConfigs; i++)
+    {
+        if(!strcmp(CreatureTables.aConfigs[i].szName, pName))
+            return &CreatureTables.aConfigs[i];
+    }
+    return NULL;
+}
+
+// Checks shared by built-in and file definitions; returns an error or NULL
+static const char* GL_ValidateCreatureConfig(const CREATURE_LEG_CONFIG* pConfig)
+{
+    if(pConfig->iLegCount < 2 || pConfig->iLegCount > GL_MAX_LEGS || (pConfig->iLegCount & 1))
+        return "leg_count must be 2, 4 or 6";
+    if(pConfig->iNumLegJoints < pConfig->iLegCount * 3)
+        return "legs list needs upper, lower and foot joints for every leg";
+    if(pConfig->iNumLegJoints > GL_MAX_LEG_JOINTS)
+        return "legs list is too long";
+    if(pConfig->iNumJointsToHide > GL_MAX_SECTIONS)
+        return "hide list is too long";
+    if(pConfig->iSwingMultiplier < 0 || pConfig->iStepHeight < 0)
+        return "swing and step_height must not be negative";
+    return NULL;
+}
+
+// Point configs at their name runs and the species table at its entries.
+// Only done once all names are in, so the runs are final.
+static const char* GL_FinishCreatureTables(void)
+{
+    static const char* const SpeciesNames[3] = {"marine", "alien", "predator"};
+    
+    for(int i = 0; i < 3; i++)
+    {
+        CreatureTables.pSpeciesConfigs[i] = GL_FindConfigByName(SpeciesNames[i]);
+        if(!CreatureTables.pSpeciesConfigs[i])
+            return "marine, alien and predator must all be defined";
+    }
+    
+    for(int i = 0; i < CreatureTables.iNumConfigs; i++)
+    {
+        static char szError[128];
+        const char* pError = GL_ValidateCreatureConfig(&CreatureTables.aConfigs[i]);
+        if(pError)
+        {
+            sprintf(szError, "[%s] %s", CreatureTables.aConfigs[i].szName, pError);
+            return szError;
+        }
+    }
+    
+    CreatureTables.bLoaded = 1;
+    return NULL;
+}
+
+static void GL_CompileBuiltinCreatures(void)
+{
+    GL_ResetCreatureTables();
+    
+    for(int i = 0; i < (int)(sizeof(BuiltinCreatures) / sizeof(BuiltinCreatures[0])); i++)
+    {
+        const CREATURE_LEG_SOURCE* pSource = &BuiltinCreatures[i];
+        CREATURE_LEG_CONFIG* pConfig = &CreatureTables.aConfigs[CreatureTables.iNumConfigs++];
+        
+        strncpy(pConfig->szName, pSource->pName, GL_MAX_CREATURE_NAME - 1);
+        pConfig->vOffset = pSource->vOffset;
+        pConfig->vLegOffsetLeft = pSource->vLegOffsetLeft;
+        pConfig->vLegOffsetRight = pSource->vLegOffsetRight;
+        pConfig->iLegCount = pSource->iLegCount;
+        pConfig->iSwingMultiplier = pSource->iSwingMultiplier;
+        pConfig->iStepHeight = pSource->iStepHeight;
+        pConfig->bCanCrawlWalls = pSource->bCanCrawlWalls;
+        
+        // Counts come from the lists themselves
+        int iFirst = CreatureTables.iNumJointNames;
+        GL_AddJointList(pSource->ppJointsToHide);
+        GL_AddJointList(pSource->ppExtraHide);
+        pConfig->pJointsToHide = &CreatureTables.apJointNames[iFirst];
+        pConfig->iNumJointsToHide = CreatureTables.iNumJointNames - iFirst;
+        
+        iFirst = CreatureTables.iNumJointNames;
+        GL_AddJointList(pSource->ppLegJoints);
+        pConfig->pLegJoints = &CreatureTables.apJointNames[iFirst];
+        pConfig->iNumLegJoints = CreatureTables.iNumJointNames - iFirst;
+    }
+    
+    GL_FinishCreatureTables();
+}
+
+/* ================================================================
+   Config File Parsing
+
+   # comment
+   [alien]
+   offset = 0 -40 -80              # x y z in world units
+   leg_offset_left = -30 60 -20
+   leg_offset_right = 30 60 -20
+   leg_count = 6
+   swing = 8000                    # raw phase multiplier
+   step_height = 12                # world units
+   crawl_walls = 1
+   hide = torso chest spine ...
+   legs = leg_front_left_upper ...
+
+   Unlisted values default to zero; hide and legs may appear once per
+   creature. Any error rejects the whole file.
+   ================================================================ */
+static int GL_ParseFixed(const char* pText, int* pOut)
+{
+    char* pEnd;
+    double dValue = strtod(pText, &pEnd) * ONE_FIXED;
+    if(pEnd == pText || *pEnd)
+        return 0;
+    // Also false for NaN
+    if(!(dValue >= INT_MIN && dValue <= INT_MAX))
+        return 0;
+    *pOut = (int)dValue;
+    return 1;
+}
+
+static int GL_ParseVector(char* pText, VECTORCH* pOut)
+{
+    char* pX = strtok(pText, " \t");
+    char* pY = strtok(NULL, " \t");
+    char* pZ = strtok(NULL, " \t");
+    
+    return pX && pY && pZ && !strtok(NULL, " \t") &&
+           GL_ParseFixed(pX, &pOut->vx) &&
+           GL_ParseFixed(pY, &pOut->vy) &&
+           GL_ParseFixed(pZ, &pOut->vz);
+}
+
+static int GL_ParseInt(const char* pText, int* pOut)
+{
+    char* pEnd;
+    long lValue = strtol(pText, &pEnd, 10);
+    if(pEnd == pText || *pEnd)
+        return 0;
+    *pOut = (int)lValue;
+    return 1;
+}
+
+// Adds a whitespace separated list; run start and length go to the outputs
+static int GL_ParseJointList(char* pText, const char* const** pppRun, int* piCount)
+{
+    int iFirst = CreatureTables.iNumJointNames;
+    
+    for(char* pName = strtok(pText, " \t"); pName; pName = strtok(NULL, " \t"))
+    {
+        if(!GL_AddJointName(pName))
+            return 0;
+    }
+    
+    *pppRun = &CreatureTables.apJointNames[iFirst];
+    *piCount = CreatureTables.iNumJointNames - iFirst;
+    return *piCount > 0;
+}
+
+static char* GL_TrimText(char* pText)
+{
+    while(*pText == ' ' || *pText == '\t')
+        pText++;
+    
+    char* pEnd = pText + strlen(pText);
+    while(pEnd > pText && (pEnd[-1] == ' ' || pEnd[-1] == '\t' || pEnd[-1] == '\r' || pEnd[-1] == '\n'))
+        *--pEnd = 0;
+    
+    return pText;
+}
+
+// Returns NULL on success, otherwise the error (line number in *piLine)
+static const char* GL_ParseCreatureFile(FILE* pFile, int* piLine)
+{
+    CREATURE_LEG_CONFIG* pConfig = NULL;
+    char acLine[1024];
+    
+    GL_ResetCreatureTables();
+    *piLine = 0;
+    
+    while(fgets(acLine, sizeof(acLine), pFile))
+    {
+        (*piLine)++;
+        
+        char* pComment = strchr(acLine, '#');
+        if(pComment)
+            *pComment = 0;
+        
+        char* pText = GL_TrimText(acLine);
+        if(!*pText)
+            continue;
+        
+        if(*pText == '[')
+        {
+            char* pClose = strchr(pText, ']');
+            if(!pClose || pClose[1])
+                return "malformed section header";
+            *pClose = 0;
+            
+            char* pName = GL_TrimText(pText + 1);
+            if(!*pName || strlen(pName) >= GL_MAX_CREATURE_NAME)
+                return "bad creature name";
+            if(GL_FindConfigByName(pName))
+                return "duplicate creature";
+            if(CreatureTables.iNumConfigs >= GL_MAX_CREATURE_CONFIGS)
+                return "too many creatures";
+            
+            pConfig = &CreatureTables.aConfigs[CreatureTables.iNumConfigs++];
+            strcpy(pConfig->szName, pName);
+            continue;
+        }
+        
+        char* pEquals = strchr(pText, '=');
+        if(!pEquals)
+            return "expected key = value";
+        if(!pConfig)
+            return "value outside of a [creature] section";
+        
+        *pEquals = 0;
+        char* pKey = GL_TrimText(pText);
+        char* pValue = GL_TrimText(pEquals + 1);
+        int bOk;
+        
+        if(!strcmp(pKey, "offset"))
+            bOk = GL_ParseVector(pValue, &pConfig->vOffset);
+        else if(!strcmp(pKey, "leg_offset_left"))
+            bOk = GL_ParseVector(pValue, &pConfig->vLegOffsetLeft);
+        else if(!strcmp(pKey, "leg_offset_right"))
+            bOk = GL_ParseVector(pValue, &pConfig->vLegOffsetRight);
+        else if(!strcmp(pKey, "leg_count"))
+            bOk = GL_ParseInt(pValue, &pConfig->iLegCount);
+        else if(!strcmp(pKey, "swing"))
+            bOk = GL_ParseInt(pValue, &pConfig->iSwingMultiplier);
+        else if(!strcmp(pKey, "step_height"))
+            bOk = GL_ParseFixed(pValue, &pConfig->iStepHeight);
+        else if(!strcmp(pKey, "crawl_walls"))
+            bOk = GL_ParseInt(pValue, &pConfig->bCanCrawlWalls) &&
+                  (pConfig->bCanCrawlWalls == 0 || pConfig->bCanCrawlWalls == 1);
+        else if(!strcmp(pKey, "hide"))
+        {
+            if(pConfig->pJointsToHide)
+                return "hide listed twice";
+            bOk = GL_ParseJointList(pValue, &pConfig->pJointsToHide, &pConfig->iNumJointsToHide);
+        }
+        else if(!strcmp(pKey, "legs"))
+        {
+            if(pConfig->pLegJoints)
+                return "legs listed twice";
+            bOk = GL_ParseJointList(pValue, &pConfig->pLegJoints, &pConfig->iNumLegJoints);
+        }
+        else
+            return "unknown key";
+        
+        if(!bOk)
+            return "invalid value (or name tables full)";
+    }
+    
+    return GL_FinishCreatureTables();
+}
+
+/* ================================================================
+   Load Creature Configs (startup)
+   ================================================================ */
+void GL_LoadCreatureConfigs(void)
+{
+    FILE* pFile = fopen(GL_CREATURE_CONFIG_FILE, "r");
+    if(pFile)
+    {
+        int iLine;
+        const char* pError = GL_ParseCreatureFile(pFile, &iLine);
+        fclose(pFile);
+        
+        if(!pError)
+        {
+            CreatureTables.bFromFile = 1;
+            return;
+        }
+        
+        textprint("%s:%d: %s - using built-in creature legs\n",
+            GL_CREATURE_CONFIG_FILE, iLine, pError);
+    }
+    
+    GL_CompileBuiltinCreatures();
+}
+
+// Config for a creature by name (e.g. for NPC legs), or NULL
+CREATURE_LEG_CONFIG* GL_FindCreatureConfig(const char* pName)
+{
+    if(!CreatureTables.bLoaded)
+        GL_LoadCreatureConfigs();
+    return GL_FindConfigByName(pName);
+}
+
+/* ================================================================
+   Wall-Crawling Surface Frame
+   The axes of the surface the alien clings to only change with the
+   gravity direction, so they are rebuilt while it changes (blending
+   between floor, wall and ceiling) and reused otherwise. Each frame
+   then only folds the facing on the surface into them.
+   ================================================================ */
+#define GL_WALL_BLEND_TIME      (ONE_FIXED / 4)
+#define GL_WALL_GRIP            5       // Feet sink this far into the surface
+
+typedef struct GL_SURFACE_FRAME
+{
+    VECTORCH vGravity;              // Gravity the axes were built for (blended)
+    VECTORCH vAxes[3];              // World directions of model x (right), y (down), z (forward)
+    VECTORCH vBlendFrom;
+    VECTORCH vBlendTo;              // Gravity direction being blended to
+    VECTORCH vBlendArc;             // Bends flips past 90 degrees around the body
+    int iBlendTime;                 // GL_WALL_BLEND_TIME once settled
+    int iFacingCos;                 // Kept while looking straight at the surface
+    int iFacingSin;
+    VECTORCH vRestFeet[GL_MAX_LEGS]; // Model axes, gripping the surface
+    CREATURE_LEG_CONFIG* pRestConfig; // Config vRestFeet were built for
+} GL_SURFACE_FRAME;
+
 /* ================================================================
    Enhanced Ghost Legs System with Creature Support
    ================================================================ */
@@ -160,15 +590,37 @@ typedef struct ENHANCED_GHOST_LEGS
     int bInitialized;
     
     // Animation state
-    int iLegPhases[6];              // Phase for each leg (0-65535)
-    int iSwingIntensity[6];         // Swing amount for each leg
-    VECTORCH vLegPositions[6];      // Current leg positions
-    VECTORCH vTargetLegPositions[6]; // Target leg positions
+    int iLegPhases[GL_MAX_LEGS];    // Swing phase of each leg (0-65535, 0 when planted)
+    int iSwingIntensity[GL_MAX_LEGS]; // Lift of each leg (0-ONE_FIXED)
+    VECTORCH vLegPositions[GL_MAX_LEGS]; // Feet as drawn, relative to Player->ObWorld
+    VECTORCH vTargetLegPositions[GL_MAX_LEGS]; // Feet from the planner / rest pose
+    
+    // Walk planner (ghost_legs_walk.cpp)
+    int iWalkSpecies;               // Species the planner was reset for (-1 = none)
+    CREATURE_LEG_CONFIG* pWalkConfig; // Config the hips were taken from
+    int bWalkDriven;                // Planner placed the feet this frame
+    int bAirborne;                  // Jumping or falling
+    int iPlantedThisUpdate;         // Bit per leg that touched down this frame
     
     // Wall-crawling state (Alien only)
     int bOnWall;
     VECTORCH vWallNormal;
     int iWallSurfaceType;
+    GL_SURFACE_FRAME SurfaceFrame;
+    
+    // Leg joints resolved once per cloned model (same order as
+    // pLegJoints, NULL where the model has no such section)
+    SECTION_DATA* pLegSections[GL_MAX_LEG_JOINTS];
+    int iNumLegSections;
+    HMODELCONTROLLER* pResolvedHModel;       // Model the table was built for
+    int iResolvedShape;
+    CREATURE_LEG_CONFIG* pResolvedConfig;
+    
+    // Material instances of the legs clone; the clone's sections point
+    // here instead of at the materials shared with the player model
+    MATERIAL aOwnMaterials[GL_MAX_OWN_MATERIALS];
+    int iNumOwnMaterials;
+    int iAppliedTranslucency;       // Last value pushed to ObFlags2 (-1 = none yet)
 } ENHANCED_GHOST_LEGS;
 
 static ENHANCED_GHOST_LEGS EnhancedLegs;
@@ -179,27 +631,22 @@ static int g_iCreatureLegsEnabled = 1;
    ================================================================ */
 CREATURE_LEG_CONFIG* GL_GetCreatureConfig(void)
 {
-    if(!Player || !Player->ObStrategyBlock)
-        return &MarineConfig; // Default
+    if(!CreatureTables.bLoaded)
+        GL_LoadCreatureConfigs();
     
-    PLAYER_STATUS* pStatus = (PLAYER_STATUS*)Player->ObStrategyBlock->SBdataptr;
+    if(!Player || !Player->ObStrategyBlock)
+        return CreatureTables.pSpeciesConfigs[I_Marine]; // Default
     
     switch(AvP.PlayerType)
     {
         case I_Marine:
-            EnhancedLegs.iCreatureType = I_Marine;
-            return &MarineConfig;
-            
         case I_Alien:
-            EnhancedLegs.iCreatureType = I_Alien;
-            return &AlienConfig;
-            
         case I_Predator:
-            EnhancedLegs.iCreatureType = I_Predator;
-            return &PredatorConfig;
+            EnhancedLegs.iCreatureType = AvP.PlayerType;
+            return CreatureTables.pSpeciesConfigs[AvP.PlayerType];
             
         default:
-            return &MarineConfig;
+            return CreatureTables.pSpeciesConfigs[I_Marine];
     }
 }
 
@@ -213,15 +660,19 @@ void GL_InitCreatureLegs(void)
     // Get current creature config
     EnhancedLegs.pCurrentConfig = GL_GetCreatureConfig();
     
-    // Initialize leg phases (staggered for natural gait)
-    for(int i = 0; i < 6; i++)
+    // All feet planted; the planner staggers them by gait group
+    for(int i = 0; i < GL_MAX_LEGS; i++)
     {
-        EnhancedLegs.iLegPhases[i] = (i * 65536) / EnhancedLegs.pCurrentConfig->iLegCount;
+        EnhancedLegs.iLegPhases[i] = 0;
         EnhancedLegs.iSwingIntensity[i] = 0;
         EnhancedLegs.vLegPositions[i] = SetVector(0, 0, 0);
         EnhancedLegs.vTargetLegPositions[i] = SetVector(0, 0, 0);
     }
     
+    // Planner is reset on the first animated frame
+    GLW_Init();
+    EnhancedLegs.iWalkSpecies = -1;
+    
     EnhancedLegs.bInitialized = 1;
     
     #ifdef _DEBUG
@@ -249,6 +700,7 @@ void GL_CreateCreatureLegs(void)
     // Copy player model
     EnhancedLegs.pLegsDisplay->ObShape = Player->ObShape;
     EnhancedLegs.pLegsDisplay->ObFlags &= ~ObFlag_NotVis;
+    EnhancedLegs.iAppliedTranslucency = -1;
     
     // Create strategy block
     EnhancedLegs.pLegsStrategy = CreateStrategyBlock();
@@ -274,6 +726,9 @@ void GL_CreateCreatureLegs(void)
         
         // Apply creature-specific materials/colors
         GL_ApplyCreatureMaterials();
+        
+        // Resolve leg joint names once for this clone
+        GL_ResolveCreatureJoints();
     }
     
     // Set flags
@@ -295,101 +750,122 @@ void GL_CreateCreatureLegs(void)
 }
 
 /* ================================================================
-   Hide Creature-Specific Joints
+   Destroy Creature Legs
+   Only on creature/model change or shutdown, never per frame
    ================================================================ */
-void GL_HideCreatureJoints(void)
+void GL_DestroyCreatureLegs(void)
 {
-    if(!EnhancedLegs.pLegsDisplay || !EnhancedLegs.pLegsDisplay->HModelControlBlock)
+    if(!EnhancedLegs.bActive)
         return;
     
-    HMODELCONTROLLER* pHModel = EnhancedLegs.pLegsDisplay->HModelControlBlock;
-    
-    // Hide joints from configuration
-    for(int i = 0; i < EnhancedLegs.pCurrentConfig->iNumJointsToHide; i++)
+    if(EnhancedLegs.pLegsDisplay)
     {
-        const char* jointName = EnhancedLegs.pCurrentConfig->pJointsToHide[i];
-        if(!jointName) break;
+        RemoveFromActiveBlockList(EnhancedLegs.pLegsDisplay);
         
-        SECTION_DATA* pSection = GetThisSectionData(pHModel->section_data, jointName);
-        if(pSection)
+        if(EnhancedLegs.pLegsDisplay->HModelControlBlock)
         {
-            pSection->flags |= SECTION_HIDDEN;
+            FreeHModel(EnhancedLegs.pLegsDisplay->HModelControlBlock);
         }
+        
+        FreeDisplayBlock(EnhancedLegs.pLegsDisplay);
     }
     
-    // Creature-specific special handling
-    switch(EnhancedLegs.iCreatureType)
+    if(EnhancedLegs.pLegsStrategy)
     {
-        case I_Alien:
-            GL_HideAlienSpecificParts(pHModel);
-            break;
-            
-        case I_Predator:
-            GL_HidePredatorSpecificParts(pHModel);
-            break;
+        FreeStrategyBlock(EnhancedLegs.pLegsStrategy);
     }
+    
+    EnhancedLegs.pLegsDisplay = NULL;
+    EnhancedLegs.pLegsStrategy = NULL;
+    EnhancedLegs.bActive = 0;
+    
+    // Handles pointed into the freed clone
+    memset(EnhancedLegs.pLegSections, 0, sizeof(EnhancedLegs.pLegSections));
+    EnhancedLegs.iNumLegSections = 0;
+    EnhancedLegs.pResolvedHModel = NULL;
+    EnhancedLegs.pResolvedConfig = NULL;
+    
+    // Only the freed clone used these
+    EnhancedLegs.iNumOwnMaterials = 0;
 }
 
 /* ================================================================
-   Alien-Specific Part Hiding
+   Resolve Leg Joint Handles
+   GetThisSectionData walks the section list comparing names, so it is
+   only called here; per-frame code indexes pLegSections instead.
    ================================================================ */
-void GL_HideAlienSpecificParts(HMODELCONTROLLER* pHModel)
+void GL_ResolveCreatureJoints(void)
 {
-    // Alien has special parts to hide
-    const char* alienSpecialParts[] = {
-        "inner_jaw", "tongue",
-        "acid_sac", "acid_drool",
-        "ovipositor", "egg_sac",
-        NULL
-    };
+    memset(EnhancedLegs.pLegSections, 0, sizeof(EnhancedLegs.pLegSections));
+    EnhancedLegs.iNumLegSections = 0;
+    EnhancedLegs.pResolvedHModel = NULL;
+    EnhancedLegs.pResolvedConfig = NULL;
+    
+    if(!EnhancedLegs.pLegsDisplay || !EnhancedLegs.pLegsDisplay->HModelControlBlock ||
+       !EnhancedLegs.pCurrentConfig)
+        return;
+    
+    HMODELCONTROLLER* pHModel = EnhancedLegs.pLegsDisplay->HModelControlBlock;
+    CREATURE_LEG_CONFIG* pConfig = EnhancedLegs.pCurrentConfig;
+    
+    int iCount = pConfig->iNumLegJoints;
+    if(iCount > GL_MAX_LEG_JOINTS)
+        iCount = GL_MAX_LEG_JOINTS;
     
-    for(int i = 0; alienSpecialParts[i]; i++)
+    int i;
+    for(i = 0; i < iCount && pConfig->pLegJoints[i]; i++)
     {
-        SECTION_DATA* pSection = GetThisSectionData(pHModel->section_data, alienSpecialParts[i]);
-        if(pSection)
-        {
-            pSection->flags |= SECTION_HIDDEN;
-        }
+        EnhancedLegs.pLegSections[i] = GetThisSectionData(pHModel->section_data, pConfig->pLegJoints[i]);
     }
     
-    // Make legs slightly transparent for wall-crawling effect
-    SECTION_DATA* pLegSection = GetThisSectionData(pHModel->section_data, "leg_front_left_upper");
-    if(pLegSection && pLegSection->material)
+    EnhancedLegs.iNumLegSections = i;
+    EnhancedLegs.pResolvedHModel = pHModel;
+    EnhancedLegs.iResolvedShape = EnhancedLegs.pLegsDisplay->ObShape;
+    EnhancedLegs.pResolvedConfig = pConfig;
+}
+
+/* Rebuild the joint table only if the model or creature changed */
+static void GL_ValidateCreatureJoints(void)
+{
+    if(!EnhancedLegs.pLegsDisplay)
+        return;
+    
+    if(EnhancedLegs.pResolvedHModel != EnhancedLegs.pLegsDisplay->HModelControlBlock ||
+       EnhancedLegs.iResolvedShape != EnhancedLegs.pLegsDisplay->ObShape ||
+       EnhancedLegs.pResolvedConfig != EnhancedLegs.pCurrentConfig)
     {
-        // Adjust material transparency
-        pLegSection->material->alpha = 0.9f;
+        GL_ResolveCreatureJoints();
     }
 }
 
 /* ================================================================
-   Predator-Specific Part Hiding
+   Creature-Specific Hide Rules
    ================================================================ */
-void GL_HidePredatorSpecificParts(HMODELCONTROLLER* pHModel)
+// pRules is the CREATURE_LEG_CONFIG the mask is cached under; its hide
+// list already includes the creature's special parts
+static void GL_BuildCreatureHideMask(HMODELCONTROLLER* pHModel, GL_HIDE_MASK* pMask,
+                                     const void* pRules)
 {
-    // Predator has equipment to hide
-    const char* predatorEquipment[] = {
-        "bio_mask", "laser_sight",
-        "cloak_generator", "energy_cells",
-        "medicomp", "self_destruct",
-        NULL
-    };
+    const CREATURE_LEG_CONFIG* pConfig = (const CREATURE_LEG_CONFIG*)pRules;
     
-    for(int i = 0; predatorEquipment[i]; i++)
-    {
-        SECTION_DATA* pSection = GetThisSectionData(pHModel->section_data, predatorEquipment[i]);
-        if(pSection)
-        {
-            pSection->flags |= SECTION_HIDDEN;
-        }
-    }
+    GL_HideMaskAddNamed(pMask, pHModel, pConfig->pJointsToHide, pConfig->iNumJointsToHide);
+}
+
+/* ================================================================
+   Hide Creature-Specific Joints
+   ================================================================ */
+void GL_HideCreatureJoints(void)
+{
+    if(!EnhancedLegs.pLegsDisplay || !EnhancedLegs.pLegsDisplay->HModelControlBlock)
+        return;
     
-    // Make Predator legs more metallic
-    SECTION_DATA* pLegSection = GetThisSectionData(pHModel->section_data, "leg_left_upper");
-    if(pLegSection && pLegSection->material)
-    {
-        // Adjust material for Predator look
-        pLegSection->material->shininess = 0.8f; // More shiny
-    }
+    HMODELCONTROLLER* pHModel = EnhancedLegs.pLegsDisplay->HModelControlBlock;
+    
+    // Names are only matched the first time this shape/creature is seen
+    const GL_HIDE_MASK* pMask = GL_GetHideMask(EnhancedLegs.pLegsDisplay->ObShape,
+                                               EnhancedLegs.pCurrentConfig,
+                                               pHModel, GL_BuildCreatureHideMask);
+    GL_ApplyHideMask(pHModel, pMask);
 }
 
 /* ================================================================
@@ -422,44 +898,78 @@ void GL_ApplyCreatureMaterials(void)
     }
 }
 
+/* ================================================================
+   Legs-Owned Materials
+   CloneHModel copies the section list but not the materials, so a
+   write through the clone would also change the player's third-person
+   model. Sections get their own copy the first time the legs change
+   them (once per clone, in GL_ApplyCreatureMaterials).
+   ================================================================ */
+static MATERIAL* GL_GetOwnMaterial(SECTION_DATA* pSection)
+{
+    if(!pSection || !pSection->material)
+        return NULL;
+    
+    MATERIAL* pFirst = &EnhancedLegs.aOwnMaterials[0];
+    if(pSection->material >= pFirst && pSection->material < pFirst + EnhancedLegs.iNumOwnMaterials)
+        return pSection->material;
+    
+    // Out of instances: leave the shared material alone
+    if(EnhancedLegs.iNumOwnMaterials >= GL_MAX_OWN_MATERIALS)
+        return NULL;
+    
+    MATERIAL* pOwn = &EnhancedLegs.aOwnMaterials[EnhancedLegs.iNumOwnMaterials++];
+    *pOwn = *pSection->material;
+    pSection->material = pOwn;
+    return pOwn;
+}
+
 /* ================================================================
    Creature-Specific Material Functions
    ================================================================ */
 void GL_ApplyMarineMaterials(HMODELCONTROLLER* pHModel)
 {
     // Marine legs: military boots, camo pants
-    SECTION_DATA* pLeg = GetThisSectionData(pHModel->section_data, "leg_left_upper");
-    if(pLeg && pLeg->material)
+    MATERIAL* pLeg = GL_GetOwnMaterial(GetThisSectionData(pHModel->section_data, "leg_left_upper"));
+    if(pLeg)
     {
         // Camo pattern for pants
-        pLeg->material->texture = "textures/marine_pants.cel";
-        pLeg->material->reflectivity = 0.1f; // Matte
+        pLeg->texture = "textures/marine_pants.cel";
+        pLeg->reflectivity = 0.1f; // Matte
     }
     
-    SECTION_DATA* pBoot = GetThisSectionData(pHModel->section_data, "leg_left_foot");
-    if(pBoot && pBoot->material)
+    MATERIAL* pBoot = GL_GetOwnMaterial(GetThisSectionData(pHModel->section_data, "leg_left_foot"));
+    if(pBoot)
     {
         // Boots texture
-        pBoot->material->texture = "textures/marine_boots.cel";
-        pBoot->material->bumpiness = 0.3f; // Slight bump for boot tread
+        pBoot->texture = "textures/marine_boots.cel";
+        pBoot->bumpiness = 0.3f; // Slight bump for boot tread
     }
 }
 
 void GL_ApplyAlienMaterials(HMODELCONTROLLER* pHModel)
 {
+    // Make legs slightly transparent for wall-crawling effect
+    MATERIAL* pLegMaterial = GL_GetOwnMaterial(GetThisSectionData(pHModel->section_data, "leg_front_left_upper"));
+    if(pLegMaterial)
+    {
+        // Adjust material transparency
+        pLegMaterial->alpha = 0.9f;
+    }
+    
     // Alien legs: chitinous, slimy
     for(int i = 0; i < 6; i++)
     {
         char legName[32];
         sprintf(legName, "leg_%d_upper", i);
         
-        SECTION_DATA* pLeg = GetThisSectionData(pHModel->section_data, legName);
-        if(pLeg && pLeg->material)
+        MATERIAL* pLeg = GL_GetOwnMaterial(GetThisSectionData(pHModel->section_data, legName));
+        if(pLeg)
         {
             // Alien chitin texture
-            pLeg->material->texture = "textures/alien_chitin.cel";
-            pLeg->material->shininess = 0.4f; // Slightly shiny
-            pLeg->material->specular = 0.2f;  // Wet look
+            pLeg->texture = "textures/alien_chitin.cel";
+            pLeg->shininess = 0.4f; // Slightly shiny
+            pLeg->specular = 0.2f;  // Wet look
         }
     }
 }
@@ -467,27 +977,111 @@ void GL_ApplyAlienMaterials(HMODELCONTROLLER* pHModel)
 void GL_ApplyPredatorMaterials(HMODELCONTROLLER* pHModel)
 {
     // Predator legs: metallic, high-tech
-    SECTION_DATA* pLeg = GetThisSectionData(pHModel->section_data, "leg_left_upper");
-    if(pLeg && pLeg->material)
+    MATERIAL* pLeg = GL_GetOwnMaterial(GetThisSectionData(pHModel->section_data, "leg_left_upper"));
+    if(pLeg)
     {
         // Predator armor texture
-        pLeg->material->texture = "textures/predator_armor.cel";
-        pLeg->material->shininess = 0.9f;     // Very shiny
-        pLeg->material->reflectivity = 0.3f;  // Slightly reflective
-        pLeg->material->specular = 0.5f;      // Strong highlights
+        pLeg->texture = "textures/predator_armor.cel";
+        pLeg->shininess = 0.9f;     // Very shiny
+        pLeg->reflectivity = 0.3f;  // Slightly reflective
+        pLeg->specular = 0.5f;      // Strong highlights
     }
     
-    SECTION_DATA* pBoot = GetThisSectionData(pHModel->section_data, "boot_left");
-    if(pBoot && pBoot->material)
+    MATERIAL* pBoot = GL_GetOwnMaterial(GetThisSectionData(pHModel->section_data, "boot_left"));
+    if(pBoot)
     {
         // High-tech boots
-        pBoot->material->texture = "textures/predator_boots.cel";
-        pBoot->material->emissive = 0.1f;     // Slight glow
+        pBoot->texture = "textures/predator_boots.cel";
+        pBoot->emissive = 0.1f;     // Slight glow
     }
 }
 
 /* ================================================================
-   Creature-Specific Leg Animation
+   Hip Layout
+   Hips in ONE_FIXED world units, body frame (vx right, vy forward,
+   vz up). Legs alternate left/right and each further pair sits 40
+   units behind the previous one.
+   ================================================================ */
+static void GL_GetHipOffsets(const CREATURE_LEG_CONFIG* pConfig, VECTORCH* pHips)
+{
+    for(int i = 0; i < pConfig->iLegCount; i++)
+    {
+        const VECTORCH* pSide = (i & 1) ? &pConfig->vLegOffsetRight : &pConfig->vLegOffsetLeft;
+        
+        pHips[i] = *pSide;
+        pHips[i].vy -= (i / 2) * 40 * ONE_FIXED;
+    }
+}
+
+// Foot section of leg i: the legs list is upper, lower, foot per leg
+static SECTION_DATA* GL_GetFootSection(int iLeg)
+{
+    int iJoint = iLeg * 3 + 2;
+    
+    if(iJoint >= EnhancedLegs.iNumLegSections)
+        return NULL;
+    return EnhancedLegs.pLegSections[iJoint];
+}
+
+/* ================================================================
+   Restart the Walk Planner
+   On creature change, and whenever the config was reloaded
+   ================================================================ */
+static void GL_ResetCreatureWalk(void)
+{
+    VECTORCH vHips[GL_MAX_LEGS];
+    
+    GL_GetHipOffsets(EnhancedLegs.pCurrentConfig, vHips);
+    GLW_ResetPlayer(EnhancedLegs.iCreatureType, vHips, EnhancedLegs.pCurrentConfig->iLegCount);
+    
+    EnhancedLegs.iWalkSpecies = EnhancedLegs.iCreatureType;
+    EnhancedLegs.pWalkConfig = EnhancedLegs.pCurrentConfig;
+}
+
+/* ================================================================
+   Rest Pose (planner not driving, e.g. wall crawling)
+   Feet straight below the hips, in world axes relative to the player
+   ================================================================ */
+
+// Feet below the hips in model axes (body frame vy forward -> vz,
+// vz up -> -vy), iGrip units further down
+static void GL_GetRestFeet(CREATURE_LEG_CONFIG* pConfig, int iGrip, VECTORCH* pFeet)
+{
+    VECTORCH vHips[GL_MAX_LEGS];
+    
+    GL_GetHipOffsets(pConfig, vHips);
+    
+    for(int i = 0; i < pConfig->iLegCount; i++)
+    {
+        pFeet[i].vx = vHips[i].vx >> 16;
+        pFeet[i].vy = -(vHips[i].vz >> 16) + iGrip;
+        pFeet[i].vz = vHips[i].vy >> 16;
+    }
+}
+
+static void GL_SetRestPose(void)
+{
+    VECTORCH vFeet[GL_MAX_LEGS];
+    int iLegCount = EnhancedLegs.pCurrentConfig->iLegCount;
+    
+    GL_GetRestFeet(EnhancedLegs.pCurrentConfig, 0, vFeet);
+    
+    for(int i = 0; i < iLegCount; i++)
+    {
+        // To world axes with the player's orientation
+        RotateVector(&vFeet[i], &Player->ObMat);
+        
+        EnhancedLegs.vTargetLegPositions[i] = vFeet[i];
+        EnhancedLegs.iLegPhases[i] = 0;
+        EnhancedLegs.iSwingIntensity[i] = 0;
+    }
+}
+
+/* ================================================================
+   Creature Leg Animation
+   One path for every creature: the walk planner (ghost_legs_walk.cpp)
+   places the feet on the level using the creature's gait, and the
+   creature's config only decides the extras (wall crawling, cloak).
    ================================================================ */
 void GL_AnimateCreatureLegs(void)
 {
@@ -500,270 +1094,609 @@ void GL_AnimateCreatureLegs(void)
     if(!pDyn)
         return;
     
-    // Get movement speed
-    int iSpeed = Approximate3dMagnitude(&pDyn->LinVelocity);
+    GL_ValidateCreatureJoints();
     
-    // Creature-specific animation
-    switch(EnhancedLegs.iCreatureType)
+    if(EnhancedLegs.iWalkSpecies != EnhancedLegs.iCreatureType ||
+       EnhancedLegs.pWalkConfig != EnhancedLegs.pCurrentConfig)
     {
-        case I_Marine:
-            GL_AnimateMarineLegs(iSpeed, pPlayerStatus);
-            break;
+        GL_ResetCreatureWalk();
+    }
+    
+    GLW_LEGS_OUTPUT Output;
+    if(GLW_UpdatePlayer(EnhancedLegs.iCreatureType, NormalFrameTime, &Output))
+    {
+        for(int i = 0; i < Output.iLegCount; i++)
+        {
+            GLW_LEG_STATE* pLeg = &Output.aLegs[i];
             
-        case I_Alien:
-            GL_AnimateAlienLegs(iSpeed, pPlayerStatus);
-            break;
+            EnhancedLegs.vTargetLegPositions[i] = pLeg->vFootOffset;
+            EnhancedLegs.iLegPhases[i] = pLeg->iSwingPhase;
             
-        case I_Predator:
-            GL_AnimatePredatorLegs(iSpeed, pPlayerStatus);
-            break;
+            // Lift curve of the swing (half a sine over the phase)
+            EnhancedLegs.iSwingIntensity[i] = pLeg->bPlanted ? 0 : GetSin(pLeg->iSwingPhase >> 5);
+        }
+        
+        EnhancedLegs.bWalkDriven = 1;
+        EnhancedLegs.bAirborne = Output.bAirborne;
+        EnhancedLegs.iPlantedThisUpdate = Output.iPlantedThisUpdate;
+        EnhancedLegs.bOnWall = 0;
+        
+        for(int i = 0; i < Output.iLegCount; i++)
+        {
+            if(Output.iPlantedThisUpdate & (1 << i))
+            {
+                VECTORCH vFoot = AddVectors(&Player->ObWorld, &Output.aLegs[i].vFootOffset);
+                GL_QueueFootstep(GL_FOOTSTEP_PLAYER, EnhancedLegs.iCreatureType, i, &vFoot, Player);
+            }
+        }
     }
+    else
+    {
+        // Planner does not handle this (wall crawling): ease into the rest pose
+        EnhancedLegs.bWalkDriven = 0;
+        EnhancedLegs.bAirborne = 0;
+        EnhancedLegs.iPlantedThisUpdate = 0;
+        
+        if(EnhancedLegs.pCurrentConfig->bCanCrawlWalls && !pDyn->UseStandardGravity)
+        {
+            GL_AdaptAlienToWalls();
+        }
+        else
+        {
+            GL_SetRestPose();
+            EnhancedLegs.bOnWall = 0;
+        }
+    }
+    
+    // Cloaking effect on legs (also fades them back in when it drops)
+    GL_ApplyPredatorCloakEffect();
     
     // Update leg positions on model
     GL_UpdateLegPositions();
 }
 
 /* ================================================================
-   Marine Leg Animation (Human Biped)
+   Alien Wall-Crawling Adaptation
+   Rest pose on the surface given by the gravity direction, using the
+   cached surface frame (see GL_SURFACE_FRAME)
    ================================================================ */
-void GL_AnimateMarineLegs(int iSpeed, PLAYER_STATUS* pStatus)
+
+// Axes with model y along pGravity; model z is world z (or x when
+// gravity is close to z) flattened onto the surface
+static void GL_BuildSurfaceFrame(GL_SURFACE_FRAME* pFrame)
 {
-    // Marine has standard human bipedal gait
+    VECTORCH* pAxes = pFrame->vAxes;
+    VECTORCH vRef = {0, 0, ONE_FIXED};
+    
+    if(abs(pFrame->vGravity.vz) > ONE_FIXED * 7 / 8)
+    {
+        vRef.vx = ONE_FIXED;
+        vRef.vz = 0;
+    }
     
-    // Update leg phases based on speed
-    int iPhaseIncrement = MUL_FIXED(iSpeed, EnhancedLegs.pCurrentConfig->iSwingMultiplier);
+    int iDot = DotProduct(&vRef, &pFrame->vGravity);
+    pAxes[2].vx = vRef.vx - MUL_FIXED(pFrame->vGravity.vx, iDot);
+    pAxes[2].vy = vRef.vy - MUL_FIXED(pFrame->vGravity.vy, iDot);
+    pAxes[2].vz = vRef.vz - MUL_FIXED(pFrame->vGravity.vz, iDot);
+    Normalise(&pAxes[2]);
     
-    // Left leg (phase 0)
-    EnhancedLegs.iLegPhases[0] = (EnhancedLegs.iLegPhases[0] + iPhaseIncrement) & 65535;
+    pAxes[1] = pFrame->vGravity;
+    CrossProduct(&pAxes[1], &pAxes[2], &pAxes[0]);
+}
+
+// Starts blending from the current gravity to pTarget
+static void GL_StartSurfaceBlend(GL_SURFACE_FRAME* pFrame, VECTORCH* pTarget)
+{
+    pFrame->vBlendFrom = pFrame->vGravity;
+    pFrame->vBlendTo = *pTarget;
+    pFrame->iBlendTime = 0;
     
-    // Right leg (180 degrees out of phase)
-    EnhancedLegs.iLegPhases[1] = (EnhancedLegs.iLegPhases[0] + 32768) & 65535;
+    // Past 90 degrees the straight blend passes close to zero, so it is
+    // bent towards the target side (or forward for an exact flip)
+    pFrame->vBlendArc.vx = 0;
+    pFrame->vBlendArc.vy = 0;
+    pFrame->vBlendArc.vz = 0;
     
-    // Calculate swing amounts
-    for(int i = 0; i < 2; i++)
+    int iDot = DotProduct(&pFrame->vBlendFrom, pTarget);
+    if(iDot < 0)
     {
-        int iPhase = EnhancedLegs.iLegPhases[i];
-        int iSwing = GetSin(MUL_FIXED(iPhase, 32768)); // -1 to 1
+        VECTORCH vArc;
+        vArc.vx = pTarget->vx - MUL_FIXED(pFrame->vBlendFrom.vx, iDot);
+        vArc.vy = pTarget->vy - MUL_FIXED(pFrame->vBlendFrom.vy, iDot);
+        vArc.vz = pTarget->vz - MUL_FIXED(pFrame->vBlendFrom.vz, iDot);
         
-        // Adjust swing based on crouching
-        if(pStatus->ShapeState == PMph_Crouching)
-        {
-            iSwing = MUL_FIXED(iSwing, ONE_FIXED / 2); // Smaller steps when crouched
-        }
+        if(Approximate3dMagnitude(&vArc) < ONE_FIXED / 16)
+            vArc = pFrame->vAxes[2];
+        
+        Normalise(&vArc);
+        pFrame->vBlendArc = vArc;
+    }
+}
+
+static void GL_AdvanceSurfaceBlend(GL_SURFACE_FRAME* pFrame)
+{
+    pFrame->iBlendTime += NormalFrameTime;
+    if(pFrame->iBlendTime > GL_WALL_BLEND_TIME)
+        pFrame->iBlendTime = GL_WALL_BLEND_TIME;
+    
+    int t = DIV_FIXED(pFrame->iBlendTime, GL_WALL_BLEND_TIME);
+    int iBend = MUL_FIXED(4 * t, ONE_FIXED - t);
+    VECTORCH* pFrom = &pFrame->vBlendFrom;
+    VECTORCH* pTo = &pFrame->vBlendTo;
+    VECTORCH* pArc = &pFrame->vBlendArc;
+    
+    pFrame->vGravity.vx = pFrom->vx + MUL_FIXED(pTo->vx - pFrom->vx, t) + MUL_FIXED(pArc->vx, iBend);
+    pFrame->vGravity.vy = pFrom->vy + MUL_FIXED(pTo->vy - pFrom->vy, t) + MUL_FIXED(pArc->vy, iBend);
+    pFrame->vGravity.vz = pFrom->vz + MUL_FIXED(pTo->vz - pFrom->vz, t) + MUL_FIXED(pArc->vz, iBend);
+    
+    if(t == ONE_FIXED)
+        pFrame->vGravity = *pTo;
+    else
+        Normalise(&pFrame->vGravity);
+    
+    GL_BuildSurfaceFrame(pFrame);
+}
+
+void GL_AdaptAlienToWalls(void)
+{
+    DYNAMICSBLOCK* pDyn = Player->ObStrategyBlock->DynPtr;
+    GL_SURFACE_FRAME* pFrame = &EnhancedLegs.SurfaceFrame;
+    CREATURE_LEG_CONFIG* pConfig = EnhancedLegs.pCurrentConfig;
+    
+    // Just left the floor: blend from it
+    if(!EnhancedLegs.bOnWall)
+    {
+        VECTORCH vFloor = {0, ONE_FIXED, 0};
         
-        EnhancedLegs.iSwingIntensity[i] = MUL_FIXED(iSwing, iSpeed / 5000);
+        pFrame->vGravity = vFloor;
+        pFrame->vBlendTo = vFloor;
+        pFrame->iBlendTime = GL_WALL_BLEND_TIME;
+        pFrame->iFacingCos = ONE_FIXED;
+        pFrame->iFacingSin = 0;
+        GL_BuildSurfaceFrame(pFrame);
         
-        // Calculate leg position
-        EnhancedLegs.vTargetLegPositions[i].vx = (i == 0) ? 
-            EnhancedLegs.pCurrentConfig->vLegOffsetLeft.vx :
-            EnhancedLegs.pCurrentConfig->vLegOffsetRight.vx;
+        EnhancedLegs.bOnWall = 1;
+    }
+    
+    if(pDyn->GravityDirection.vx != pFrame->vBlendTo.vx ||
+       pDyn->GravityDirection.vy != pFrame->vBlendTo.vy ||
+       pDyn->GravityDirection.vz != pFrame->vBlendTo.vz)
+    {
+        GL_StartSurfaceBlend(pFrame, &pDyn->GravityDirection);
+    }
+    
+    if(pFrame->iBlendTime < GL_WALL_BLEND_TIME)
+    {
+        GL_AdvanceSurfaceBlend(pFrame);
+    }
+    
+    if(pFrame->pRestConfig != pConfig)
+    {
+        GL_GetRestFeet(pConfig, GL_WALL_GRIP, pFrame->vRestFeet);
+        pFrame->pRestConfig = pConfig;
+    }
+    
+    EnhancedLegs.vWallNormal.vx = -pFrame->vGravity.vx;
+    EnhancedLegs.vWallNormal.vy = -pFrame->vGravity.vy;
+    EnhancedLegs.vWallNormal.vz = -pFrame->vGravity.vz;
+    
+    // Facing on the surface: the view direction in the frame's x/z plane
+    VECTORCH* pAxes = pFrame->vAxes;
+    VECTORCH vView;
+    vView.vx = Player->ObMat.mat31;
+    vView.vy = Player->ObMat.mat32;
+    vView.vz = Player->ObMat.mat33;
+    
+    VECTORCH vFacing;
+    vFacing.vx = DotProduct(&vView, &pAxes[0]);
+    vFacing.vy = 0;
+    vFacing.vz = DotProduct(&vView, &pAxes[2]);
+    
+    int iLength = Magnitude(&vFacing);
+    if(iLength > ONE_FIXED / 16)
+    {
+        pFrame->iFacingCos = DIV_FIXED(vFacing.vz, iLength);
+        pFrame->iFacingSin = DIV_FIXED(vFacing.vx, iLength);
+    }
+    
+    // Frame turned to the facing, then every foot in one pass
+    int c = pFrame->iFacingCos;
+    int s = pFrame->iFacingSin;
+    VECTORCH vRight, vForward;
+    vRight.vx = MUL_FIXED(pAxes[0].vx, c) - MUL_FIXED(pAxes[2].vx, s);
+    vRight.vy = MUL_FIXED(pAxes[0].vy, c) - MUL_FIXED(pAxes[2].vy, s);
+    vRight.vz = MUL_FIXED(pAxes[0].vz, c) - MUL_FIXED(pAxes[2].vz, s);
+    vForward.vx = MUL_FIXED(pAxes[0].vx, s) + MUL_FIXED(pAxes[2].vx, c);
+    vForward.vy = MUL_FIXED(pAxes[0].vy, s) + MUL_FIXED(pAxes[2].vy, c);
+    vForward.vz = MUL_FIXED(pAxes[0].vz, s) + MUL_FIXED(pAxes[2].vz, c);
+    
+    VECTORCH* pDown = &pAxes[1];
+    
+    for(int i = 0; i < pConfig->iLegCount; i++)
+    {
+        VECTORCH* pRest = &pFrame->vRestFeet[i];
+        VECTORCH* pTarget = &EnhancedLegs.vTargetLegPositions[i];
         
-        EnhancedLegs.vTargetLegPositions[i].vy = EnhancedLegs.pCurrentConfig->vLegOffsetLeft.vy;
-        EnhancedLegs.vTargetLegPositions[i].vz = MUL_FIXED(iSwing, 20 * ONE_FIXED);
+        pTarget->vx = MUL_FIXED(pRest->vx, vRight.vx) + MUL_FIXED(pRest->vy, pDown->vx) + MUL_FIXED(pRest->vz, vForward.vx);
+        pTarget->vy = MUL_FIXED(pRest->vx, vRight.vy) + MUL_FIXED(pRest->vy, pDown->vy) + MUL_FIXED(pRest->vz, vForward.vy);
+        pTarget->vz = MUL_FIXED(pRest->vx, vRight.vz) + MUL_FIXED(pRest->vy, pDown->vz) + MUL_FIXED(pRest->vz, vForward.vz);
+        EnhancedLegs.iLegPhases[i] = 0;
+        EnhancedLegs.iSwingIntensity[i] = 0;
     }
 }
 
 /* ================================================================
-   Alien Leg Animation (6-Leg Tripod Gait)
+   Predator Cloak Effect on Legs
+   The whole legs mesh fades through the display block's translucency
+   (ObFlags2, ONE_FIXED = opaque), the same per-object value cloaked
+   NPC predators are drawn with, so no section material is touched.
+   It is only written when the cloak effectiveness changes.
    ================================================================ */
-void GL_AnimateAlienLegs(int iSpeed, PLAYER_STATUS* pStatus)
+void GL_ApplyPredatorCloakEffect(void)
 {
-    // Alien uses tripod gait: 3 legs move, 3 legs planted
+    PLAYER_STATUS* pStatus = (PLAYER_STATUS*)Player->ObStrategyBlock->SBdataptr;
     
-    int iPhaseIncrement = MUL_FIXED(iSpeed, EnhancedLegs.pCurrentConfig->iSwingMultiplier);
+    if(!EnhancedLegs.pLegsDisplay)
+        return;
     
-    // Update all leg phases
-    for(int i = 0; i < 6; i++)
+    int iTranslucency = ONE_FIXED;
+    if(pStatus->ProcWalk.cloakOn && pStatus->ProcWalk.CloakingEffectiveness > 0)
     {
-        EnhancedLegs.iLegPhases[i] = (EnhancedLegs.iLegPhases[i] + iPhaseIncrement) & 65535;
-        
-        // Tripod groups:
-        // Group 1 (move together): legs 0, 3, 4
-        // Group 2 (move together): legs 1, 2, 5
-        int iGroupOffset = ((i == 0 || i == 3 || i == 4) ? 0 : 32768);
-        int iPhase = (EnhancedLegs.iLegPhases[i] + iGroupOffset) & 65535;
-        
-        int iSwing = GetSin(MUL_FIXED(iPhase, 32768));
-        
-        // Alien has lower, more subtle leg movement
-        EnhancedLegs.iSwingIntensity[i] = MUL_FIXED(iSwing, iSpeed / 8000);
-        
-        // Calculate leg position based on which leg it is
-        int iLegPair = i / 2; // 0=front, 1=middle, 2=back
-        int iLegSide = i % 2; // 0=left, 1=right
-        
-        EnhancedLegs.vTargetLegPositions[i].vx = (iLegSide == 0) ? 
-            -EnhancedLegs.pCurrentConfig->vLegOffsetLeft.vx :
-            EnhancedLegs.pCurrentConfig->vLegOffsetRight.vx;
-        
-        EnhancedLegs.vTargetLegPositions[i].vy = EnhancedLegs.pCurrentConfig->vLegOffsetLeft.vy - 
-                                               (iLegPair * 40 * ONE_FIXED);
-        
-        // Alien legs lift less, more forward motion
-        EnhancedLegs.vTargetLegPositions[i].vz = MUL_FIXED(iSwing, 15 * ONE_FIXED);
+        iTranslucency = ONE_FIXED - pStatus->ProcWalk.CloakingEffectiveness;
+        if(iTranslucency < 0)
+            iTranslucency = 0;
+    }
+    
+    if(iTranslucency == EnhancedLegs.iAppliedTranslucency)
+        return;
+    
+    EnhancedLegs.pLegsDisplay->ObFlags2 = iTranslucency;
+    EnhancedLegs.iAppliedTranslucency = iTranslucency;
+}
+
+/* ================================================================
+   Update Leg Positions on Model
+   ================================================================ */
+void GL_UpdateLegPositions(void)
+{
+    if(!EnhancedLegs.bActive || !EnhancedLegs.pLegsDisplay || 
+       !EnhancedLegs.pLegsDisplay->HModelControlBlock)
+        return;
+    
+    for(int i = 0; i < EnhancedLegs.pCurrentConfig->iLegCount; i++)
+    {
+        if(EnhancedLegs.bWalkDriven)
+        {
+            // Planted feet must not slide, so the planner's feet are used as is
+            EnhancedLegs.vLegPositions[i] = EnhancedLegs.vTargetLegPositions[i];
+        }
+        else
+        {
+            // Ease toward the rest pose
+            VECTORCH vDelta = SubtractVectors(&EnhancedLegs.vTargetLegPositions[i],
+                                             &EnhancedLegs.vLegPositions[i]);
+            
+            vDelta = MultiplyVector(&vDelta, ONE_FIXED / 10); // 10% per frame
+            EnhancedLegs.vLegPositions[i] = AddVectors(&EnhancedLegs.vLegPositions[i], &vDelta);
+        }
         
-        // Extra forward motion for alien stride
-        int iForward = GetSin(MUL_FIXED(iPhase, 16384));
-        EnhancedLegs.vTargetLegPositions[i].vy += MUL_FIXED(iForward, 10 * ONE_FIXED);
+        // Place the foot joint in the world
+        SECTION_DATA* pFoot = GL_GetFootSection(i);
+        if(pFoot)
+        {
+            pFoot->World_Offset = AddVectors(&Player->ObWorld, &EnhancedLegs.vLegPositions[i]);
+        }
     }
+}
+
+/* ================================================================
+   NPC Creature Legs
+   Procedural legs for NPC aliens and predators. Behaviours call
+   GL_NPCLegsTouch() from their update, and GL_UpdateNPCLegs() then
+   plans every touched creature in one batch, once per frame.
+   Per-creature state lives in parallel arrays indexed by pool slot;
+   the slots in use are kept packed in aActive so the batch walks them
+   linearly. Distance picks the LOD: full rate, a staggered reduced
+   rate, or off (the NPC keeps its canned animation).
+   ================================================================ */
+#define GL_MAX_NPC_LEGS         GLW_MAX_CREATURES
+#define GL_NPC_LOD_NEAR         15000   // Planned every frame
+#define GL_NPC_LOD_MID          40000   // Planned every GL_NPC_MID_INTERVAL frames
+#define GL_NPC_MID_INTERVAL     4
+#define GL_NPC_STALE_FRAMES     2       // Slot freed once its NPC stops updating
+
+enum
+{
+    GL_NPC_LOD_FULL,
+    GL_NPC_LOD_REDUCED,
+    GL_NPC_LOD_OFF
+};
+
+typedef struct GL_NPC_LEGS_POOL
+{
+    // Per slot
+    STRATEGYBLOCK* pOwner[GL_MAX_NPC_LEGS];
+    int iSpecies[GL_MAX_NPC_LEGS];
+    int iLastTouched[GL_MAX_NPC_LEGS];      // Frame of the last behaviour update
+    int iPendingTime[GL_MAX_NPC_LEGS];      // Time since the slot was last planned
+    int iLod[GL_MAX_NPC_LEGS];
+    int bDriven[GL_MAX_NPC_LEGS];           // Last plan placed the feet
+    HMODELCONTROLLER* pResolvedHModel[GL_MAX_NPC_LEGS];
+    int iLegCount[GL_MAX_NPC_LEGS];
+    SECTION_DATA* pFeet[GL_MAX_NPC_LEGS][GL_MAX_LEGS];
+    VECTORCH vFeet[GL_MAX_NPC_LEGS][GL_MAX_LEGS]; // World positions from the last plan
+    
+    // Slots in use (packed) and free
+    int aActive[GL_MAX_NPC_LEGS];
+    int iNumActive;
+    int aFree[GL_MAX_NPC_LEGS];
+    int iNumFree;
+    
+    int iFrame;
+    int iNumFull;                           // LOD counts of the last update
+    int iNumReduced;
+    int bInitialized;
+} GL_NPC_LEGS_POOL;
+
+static GL_NPC_LEGS_POOL NPCLegs;
+
+static void GL_InitNPCLegs(void)
+{
+    memset(&NPCLegs, 0, sizeof(GL_NPC_LEGS_POOL));
     
-    // Wall-crawling adaptation
-    if(pStatus->ShapeState == PMph_Crouching && EnhancedLegs.pCurrentConfig->bCanCrawlWalls)
+    // Popped from the end, so slot 0 is used first
+    for(int i = 0; i < GL_MAX_NPC_LEGS; i++)
     {
-        GL_AdaptAlienToWalls();
+        NPCLegs.aFree[i] = GL_MAX_NPC_LEGS - 1 - i;
     }
+    NPCLegs.iNumFree = GL_MAX_NPC_LEGS;
+    NPCLegs.bInitialized = 1;
+}
+
+// Species (AvP.PlayerType numbering) of an NPC, or -1 if it has no legs
+static int GL_GetNPCSpecies(STRATEGYBLOCK* pSB)
+{
+    switch(pSB->I_SBtype)
+    {
+        case I_BehaviourAlien:
+            return I_Alien;
+        case I_BehaviourPredator:
+            return I_Predator;
+        default:
+            return -1;
+    }
+}
+
+// Index into aActive, or -1
+static int GL_FindNPCLegs(STRATEGYBLOCK* pSB)
+{
+    for(int i = 0; i < NPCLegs.iNumActive; i++)
+    {
+        if(NPCLegs.pOwner[NPCLegs.aActive[i]] == pSB)
+            return i;
+    }
+    return -1;
+}
+
+static void GL_FreeNPCLegs(int iActiveIndex)
+{
+    int iSlot = NPCLegs.aActive[iActiveIndex];
+    
+    GLW_ReleaseCreature(iSlot);
+    NPCLegs.pOwner[iSlot] = NULL;
+    NPCLegs.pResolvedHModel[iSlot] = NULL;
+    
+    NPCLegs.aActive[iActiveIndex] = NPCLegs.aActive[--NPCLegs.iNumActive];
+    NPCLegs.aFree[NPCLegs.iNumFree++] = iSlot;
 }
 
 /* ================================================================
-   Alien Wall-Crawling Adaptation
+   Behaviour Hooks
+   Touch from AlienBehaviour()/PredatorBehaviour() every update, and
+   release when the NPC is destroyed. NPCs that stop updating without
+   a release are freed after GL_NPC_STALE_FRAMES.
    ================================================================ */
-void GL_AdaptAlienToWalls(void)
+void GL_NPCLegsTouch(STRATEGYBLOCK* pSB)
 {
-    // Check if alien is on a wall/ceiling
-    DYNAMICSBLOCK* pDyn = Player->ObStrategyBlock->DynPtr;
+    if(!g_iCreatureLegsEnabled || !pSB)
+        return;
+    
+    if(!NPCLegs.bInitialized)
+        GL_InitNPCLegs();
     
-    if(pDyn->UseStandardGravity == 0) // Alien wall-crawling mode
+    int iIndex = GL_FindNPCLegs(pSB);
+    if(iIndex < 0)
     {
-        EnhancedLegs.bOnWall = 1;
+        int iSpecies = GL_GetNPCSpecies(pSB);
         
-        // Adjust leg positions for wall orientation
-        VECTORCH vGravityDir = pDyn->GravityDirection;
+        // No legs for this NPC, or the pool is full (canned animation)
+        if(iSpecies < 0 || NPCLegs.iNumFree == 0)
+            return;
         
-        for(int i = 0; i < 6; i++)
-        {
-            // Rotate leg positions to match wall surface
-            RotateVectorToSurface(&EnhancedLegs.vTargetLegPositions[i], &vGravityDir);
-            
-            // Legs grip into wall slightly
-            EnhancedLegs.vTargetLegPositions[i].vz -= 5 * ONE_FIXED;
-        }
+        int iSlot = NPCLegs.aFree[--NPCLegs.iNumFree];
+        NPCLegs.pOwner[iSlot] = pSB;
+        NPCLegs.iSpecies[iSlot] = iSpecies;
+        NPCLegs.iPendingTime[iSlot] = 0;
+        NPCLegs.iLod[iSlot] = GL_NPC_LOD_OFF;    // Planted on the first plan
+        NPCLegs.bDriven[iSlot] = 0;
+        NPCLegs.pResolvedHModel[iSlot] = NULL;
+        
+        iIndex = NPCLegs.iNumActive;
+        NPCLegs.aActive[NPCLegs.iNumActive++] = iSlot;
     }
-    else
+    
+    NPCLegs.iLastTouched[NPCLegs.aActive[iIndex]] = NPCLegs.iFrame;
+}
+
+void GL_NPCLegsRelease(STRATEGYBLOCK* pSB)
+{
+    if(!NPCLegs.bInitialized)
+        return;
+    
+    int iIndex = GL_FindNPCLegs(pSB);
+    if(iIndex >= 0)
+        GL_FreeNPCLegs(iIndex);
+}
+
+void GL_ShutdownNPCLegs(void)
+{
+    while(NPCLegs.iNumActive > 0)
     {
-        EnhancedLegs.bOnWall = 0;
+        GL_FreeNPCLegs(NPCLegs.iNumActive - 1);
     }
+    NPCLegs.bInitialized = 0;
+}
+
+// Foot sections of a slot's model, resolved when the model changes
+static void GL_ResolveNPCFeet(int iSlot, HMODELCONTROLLER* pHModel)
+{
+    const CREATURE_LEG_CONFIG* pConfig = CreatureTables.pSpeciesConfigs[NPCLegs.iSpecies[iSlot]];
+    
+    NPCLegs.iLegCount[iSlot] = pConfig->iLegCount;
+    for(int i = 0; i < pConfig->iLegCount; i++)
+    {
+        int iJoint = i * 3 + 2;
+        NPCLegs.pFeet[iSlot][i] = (iJoint < pConfig->iNumLegJoints) ?
+            GetThisSectionData(pHModel->section_data, pConfig->pLegJoints[iJoint]) : NULL;
+    }
+    NPCLegs.pResolvedHModel[iSlot] = pHModel;
+}
+
+static void GL_ResetNPCWalk(int iSlot, DISPLAYBLOCK* pDisplay)
+{
+    const CREATURE_LEG_CONFIG* pConfig = CreatureTables.pSpeciesConfigs[NPCLegs.iSpecies[iSlot]];
+    VECTORCH vHips[GL_MAX_LEGS];
+    
+    GL_GetHipOffsets(pConfig, vHips);
+    GLW_ResetCreature(iSlot, pDisplay, NPCLegs.iSpecies[iSlot], vHips, pConfig->iLegCount);
+    NPCLegs.bDriven[iSlot] = 0;
 }
 
 /* ================================================================
-   Predator Leg Animation (Powerful Stride)
+   Batch Update (once per frame, after the NPC behaviours)
    ================================================================ */
-void GL_AnimatePredatorLegs(int iSpeed, PLAYER_STATUS* pStatus)
+void GL_UpdateNPCLegs(void)
 {
-    // Predator has powerful, deliberate strides
+    static GLW_CREATURE_UPDATE Updates[GL_MAX_NPC_LEGS];
+    static GLW_LEGS_OUTPUT Outputs[GL_MAX_NPC_LEGS];
     
-    int iPhaseIncrement = MUL_FIXED(iSpeed, EnhancedLegs.pCurrentConfig->iSwingMultiplier);
+    if(!NPCLegs.bInitialized || !Player)
+        return;
     
-    // Update leg phases
-    EnhancedLegs.iLegPhases[0] = (EnhancedLegs.iLegPhases[0] + iPhaseIncrement) & 65535;
-    EnhancedLegs.iLegPhases[1] = (EnhancedLegs.iLegPhases[0] + 49152) & 65535; // 270° offset
+    if(!CreatureTables.bLoaded)
+        GL_LoadCreatureConfigs();
     
-    for(int i = 0; i < 2; i++)
+    int iNumUpdates = 0;
+    NPCLegs.iNumFull = 0;
+    NPCLegs.iNumReduced = 0;
+    
+    // Pick LODs and collect the slots to plan this frame
+    for(int k = 0; k < NPCLegs.iNumActive; )
     {
-        int iPhase = EnhancedLegs.iLegPhases[i];
+        int iSlot = NPCLegs.aActive[k];
         
-        // Predator has higher knee lift
-        int iSwing;
-        if(iPhase < 16384) // First quarter: fast lift
+        if(NPCLegs.iFrame - NPCLegs.iLastTouched[iSlot] > GL_NPC_STALE_FRAMES)
         {
-            iSwing = DIV_FIXED(iPhase * 4, 16384);
+            GL_FreeNPCLegs(k);  // Moves the last active slot into k
+            continue;
         }
-        else if(iPhase < 49152) // Middle half: hold high
+        k++;
+        
+        DISPLAYBLOCK* pDisplay = NPCLegs.pOwner[iSlot]->SBdptr;
+        NPCLegs.iPendingTime[iSlot] += NormalFrameTime;
+        
+        // Not drawn this frame: nothing to place
+        if(!pDisplay || !pDisplay->HModelControlBlock)
         {
-            iSwing = ONE_FIXED;
+            NPCLegs.iLod[iSlot] = GL_NPC_LOD_OFF;
+            continue;
         }
-        else // Last quarter: fast drop
+        
+        VECTORCH vToPlayer = SubtractVectors(&pDisplay->ObWorld, &Player->ObWorld);
+        int iDistance = Approximate3dMagnitude(&vToPlayer);
+        int iLod = (iDistance < GL_NPC_LOD_NEAR) ? GL_NPC_LOD_FULL :
+                   (iDistance < GL_NPC_LOD_MID) ? GL_NPC_LOD_REDUCED : GL_NPC_LOD_OFF;
+        
+        if(iLod == GL_NPC_LOD_OFF)
         {
-            iSwing = DIV_FIXED((65536 - iPhase) * 4, 16384);
+            NPCLegs.iLod[iSlot] = GL_NPC_LOD_OFF;
+            continue;
         }
         
-        EnhancedLegs.iSwingIntensity[i] = MUL_FIXED(iSwing, iSpeed / 4000);
-        
-        // Calculate leg position
-        EnhancedLegs.vTargetLegPositions[i].vx = (i == 0) ? 
-            EnhancedLegs.pCurrentConfig->vLegOffsetLeft.vx :
-            EnhancedLegs.pCurrentConfig->vLegOffsetRight.vx;
+        // New, back in range or remodelled: plant the feet where it is now
+        if(NPCLegs.iLod[iSlot] == GL_NPC_LOD_OFF ||
+           NPCLegs.pResolvedHModel[iSlot] != pDisplay->HModelControlBlock)
+        {
+            GL_ResolveNPCFeet(iSlot, pDisplay->HModelControlBlock);
+            GL_ResetNPCWalk(iSlot, pDisplay);
+            NPCLegs.iPendingTime[iSlot] = NormalFrameTime;
+        }
+        NPCLegs.iLod[iSlot] = iLod;
         
-        EnhancedLegs.vTargetLegPositions[i].vy = EnhancedLegs.pCurrentConfig->vLegOffsetLeft.vy;
+        if(iLod == GL_NPC_LOD_FULL)
+        {
+            NPCLegs.iNumFull++;
+        }
+        else
+        {
+            NPCLegs.iNumReduced++;
+            
+            // Staggered by slot so reduced creatures spread over the frames
+            if((NPCLegs.iFrame + iSlot) % GL_NPC_MID_INTERVAL)
+                continue;
+        }
         
-        // Higher lift for predator
-        EnhancedLegs.vTargetLegPositions[i].vz = MUL_FIXED(iSwing, 30 * ONE_FIXED);
+        Updates[iNumUpdates].iSlot = iSlot;
+        Updates[iNumUpdates].iDeltaTime = NPCLegs.iPendingTime[iSlot];
+        NPCLegs.iPendingTime[iSlot] = 0;
+        iNumUpdates++;
     }
     
-    // Cloaking effect on legs
-    if(pStatus->ProcWalk.cloakOn)
-    {
-        GL_ApplyPredatorCloakEffect();
-    }
-}
-
-/* ================================================================
-   Predator Cloak Effect on Legs
-   ================================================================ */
-void GL_ApplyPredatorCloakEffect(void)
-{
-    PLAYER_STATUS* pStatus = (PLAYER_STATUS*)Player->ObStrategyBlock->SBdataptr;
+    GLW_UpdateCreatures(Updates, iNumUpdates, Outputs);
     
-    if(pStatus->ProcWalk.CloakingEffectiveness > 0)
+    // Keep the planned feet in world space and queue their footsteps
+    for(int i = 0; i < iNumUpdates; i++)
     {
-        // Make legs partially transparent when cloaked
-        if(EnhancedLegs.pLegsDisplay && EnhancedLegs.pLegsDisplay->HModelControlBlock)
+        int iSlot = Updates[i].iSlot;
+        DISPLAYBLOCK* pDisplay = NPCLegs.pOwner[iSlot]->SBdptr;
+        int iLegCount = Outputs[i].iLegCount;
+        
+        NPCLegs.bDriven[iSlot] = (iLegCount > 0);
+        if(iLegCount > NPCLegs.iLegCount[iSlot])
+            iLegCount = NPCLegs.iLegCount[iSlot];
+        
+        for(int l = 0; l < iLegCount; l++)
         {
-            HMODELCONTROLLER* pHModel = EnhancedLegs.pLegsDisplay->HModelControlBlock;
+            NPCLegs.vFeet[iSlot][l] = AddVectors(&pDisplay->ObWorld, &Outputs[i].aLegs[l].vFootOffset);
             
-            // Find leg materials and adjust alpha
-            for(int i = 0; i < EnhancedLegs.pCurrentConfig->iNumLegJoints; i++)
+            if(Outputs[i].iPlantedThisUpdate & (1 << l))
             {
-                const char* jointName = EnhancedLegs.pCurrentConfig->pLegJoints[i];
-                if(!jointName) break;
-                
-                SECTION_DATA* pSection = GetThisSectionData(pHModel->section_data, jointName);
-                if(pSection && pSection->material)
-                {
-                    // Reduce alpha based on cloak effectiveness
-                    float fAlpha = 1.0f - (pStatus->ProcWalk.CloakingEffectiveness / 65536.0f);
-                    pSection->material->alpha = fAlpha;
-                }
+                GL_QueueFootstep(GL_FOOTSTEP_NPC(iSlot), NPCLegs.iSpecies[iSlot], l,
+                                 &NPCLegs.vFeet[iSlot][l], pDisplay);
             }
         }
     }
-}
-
-/* ================================================================
-   Update Leg Positions on Model
-   ================================================================ */
-void GL_UpdateLegPositions(void)
-{
-    if(!EnhancedLegs.bActive || !EnhancedLegs.pLegsDisplay || 
-       !EnhancedLegs.pLegsDisplay->HModelControlBlock)
-        return;
     
-    HMODELCONTROLLER* pHModel = EnhancedLegs.pLegsDisplay->HModelControlBlock;
-    
-    // Smoothly interpolate leg positions
-    for(int i = 0; i < EnhancedLegs.pCurrentConfig->iLegCount; i++)
+    // Every slot in range places its feet each frame, planned or not, so
+    // planted feet stay put between reduced-rate plans
+    for(int k = 0; k < NPCLegs.iNumActive; k++)
     {
-        // Interpolate toward target position
-        VECTORCH vDelta = SubtractVectors(&EnhancedLegs.vTargetLegPositions[i],
-                                         &EnhancedLegs.vLegPositions[i]);
+        int iSlot = NPCLegs.aActive[k];
         
-        vDelta = MultiplyVector(&vDelta, ONE_FIXED / 10); // 10% per frame
-        EnhancedLegs.vLegPositions[i] = AddVectors(&EnhancedLegs.vLegPositions[i], &vDelta);
+        if(NPCLegs.iLod[iSlot] == GL_NPC_LOD_OFF || !NPCLegs.bDriven[iSlot])
+            continue;
         
-        // Apply to leg joint if found
-        if(i < EnhancedLegs.pCurrentConfig->iNumLegJoints)
+        for(int l = 0; l < NPCLegs.iLegCount[iSlot]; l++)
         {
-            const char* jointName = EnhancedLegs.pCurrentConfig->pLegJoints[i];
-            if(jointName)
+            SECTION_DATA* pFoot = NPCLegs.pFeet[iSlot][l];
+            if(pFoot)
             {
-                SECTION_DATA* pSection = GetThisSectionData(pHModel->section_data, jointName);
-                if(pSection)
-                {
-                    // Apply position offset to joint
-                    pSection->World_Offset = EnhancedLegs.vLegPositions[i];
-                }
+                pFoot->World_Offset = NPCLegs.vFeet[iSlot][l];
             }
         }
     }
+    
+    NPCLegs.iFrame++;
 }
 
 /* ================================================================
@@ -778,6 +1711,10 @@ void GL_CreatureDebug(void)
     textprint("Leg Count: %d\n", EnhancedLegs.pCurrentConfig->iLegCount);
     textprint("Active: %d\n", EnhancedLegs.bActive);
     textprint("On Wall: %d\n", EnhancedLegs.bOnWall);
+    textprint("Planner: %d  Airborne: %d\n", EnhancedLegs.bWalkDriven, EnhancedLegs.bAirborne);
+    textprint("NPC legs: %d active (%d full, %d reduced)\n",
+        NPCLegs.iNumActive, NPCLegs.iNumFull, NPCLegs.iNumReduced);
+    GL_FootstepDebug();
     
     textprint("\nLeg Phases:\n");
     for(int i = 0; i < EnhancedLegs.pCurrentConfig->iLegCount; i++)
@@ -791,9 +1728,9 @@ void GL_CreatureDebug(void)
     for(int i = 0; i < EnhancedLegs.pCurrentConfig->iLegCount; i++)
     {
         textprint("  Leg %d: (%d, %d, %d)\n", i,
-            EnhancedLegs.vTargetLegPositions[i].vx >> 16,
-            EnhancedLegs.vTargetLegPositions[i].vy >> 16,
-            EnhancedLegs.vTargetLegPositions[i].vz >> 16);
+            EnhancedLegs.vTargetLegPositions[i].vx,
+            EnhancedLegs.vTargetLegPositions[i].vy,
+            EnhancedLegs.vTargetLegPositions[i].vz);
     }
 }
 
@@ -0,0 +1,356 @@
+/* ================================================================
+   File: ghost_legs_footsteps.c
+   Footstep audio for the player's and NPCs' procedural legs
+   ================================================================ */
+
+#include "3dc.h"
+#include "inline.h"
+#include "module.h"
+#include "gamedef.h"
+#include "dynblock.h"
+#include "los.h"
+#include "psnd.h"
+#include "bh_types.h"
+#include "ghost_legs.h"
+#include "ghost_legs_walk.h"
+
+#include <string.h>
+
+/* ================================================================
+   Footstep Scheduler
+   The legs queue a plant event with the foot's world position each
+   time a foot touches down. Once per frame GL_FlushFootsteps():
+   - merges plants of one body that land close together in time and
+     space (an alien's tripod is one step, not three),
+   - keeps the closest steps when more are queued than there are
+     voices, stealing the voice of a farther step if needed,
+   - picks the sample for the surface under the foot.
+   Voice handles live in a fixed pool; the sound system clears a
+   handle when its sample ends.
+   ================================================================ */
+#define GL_FOOTSTEP_QUEUE           32
+#define GL_FOOTSTEP_VOICES          6
+#define GL_FOOTSTEP_SOURCES         (1 + GLW_MAX_CREATURES)   // Player, then NPC slots
+#define GL_FOOTSTEP_COALESCE_TIME   (ONE_FIXED / 20)    // 50 ms
+#define GL_FOOTSTEP_COALESCE_DIST   1000                // World units between merged feet
+#define GL_FOOTSTEP_MAX_DIST        30000               // Not queued beyond this
+#define GL_FOOTSTEP_PROBE_HEIGHT    200                 // Surface probe starts above the foot
+#define GL_FOOTSTEP_PROBE_DEPTH     500
+#define GL_FOOTSTEP_VOLUME          96
+#define GL_FOOTSTEP_MERGE_VOLUME    12                  // Added per merged foot
+#define GL_FOOTSTEP_MAX_VOLUME      127
+
+enum
+{
+    GL_SURFACE_DEFAULT,         // Level geometry
+    GL_SURFACE_METAL,           // Doors, lifts, platforms and other objects
+    GL_NUM_SURFACES
+};
+
+typedef struct GL_FOOTSTEP_EVENT
+{
+    VECTORCH vPosition;
+    DISPLAYBLOCK* pBody;        // Ignored by the surface probe
+    int iSource;
+    int iSpecies;
+    int iLeg;                   // First foot of the step
+    int iMerged;                // Further feet merged into it
+    int iDistance;              // From the player
+} GL_FOOTSTEP_EVENT;
+
+typedef struct GL_FOOTSTEP_VOICE
+{
+    int iHandle;                // SOUND_NOACTIVEINDEX while free
+    int iDistance;
+} GL_FOOTSTEP_VOICE;
+
+typedef struct GL_FOOTSTEP_SCHEDULER
+{
+    GL_FOOTSTEP_EVENT aQueue[GL_FOOTSTEP_QUEUE];
+    int iNumQueued;
+    
+    GL_FOOTSTEP_VOICE aVoices[GL_FOOTSTEP_VOICES];
+    
+    // Last step played per source, for merging across frames
+    int iLastTime[GL_FOOTSTEP_SOURCES];
+    VECTORCH vLastPosition[GL_FOOTSTEP_SOURCES];
+    
+    int iTime;
+    int iNumPlayed;             // Totals since the level started
+    int iNumMerged;
+    int iNumDropped;
+    int bInitialized;
+} GL_FOOTSTEP_SCHEDULER;
+
+static GL_FOOTSTEP_SCHEDULER Footsteps;
+
+// Per species (AvP.PlayerType) and surface; the alien has a sample per
+// leg pair (front, middle, back), the others use the first entry.
+// SID_NOSOUND falls back to the default surface.
+static const int FootstepSamples[3][GL_NUM_SURFACES][3] =
+{
+    // Marine
+    {
+        {SID_MARINE_FOOTSTEP, SID_MARINE_FOOTSTEP, SID_MARINE_FOOTSTEP},
+        {SID_MARINE_FOOTSTEP_METAL, SID_MARINE_FOOTSTEP_METAL, SID_MARINE_FOOTSTEP_METAL}
+    },
+    // Alien
+    {
+        {SID_ALIEN_FOOTSTEP_FRONT, SID_ALIEN_FOOTSTEP_MID, SID_ALIEN_FOOTSTEP_BACK},
+        {SID_ALIEN_FOOTSTEP_METAL, SID_ALIEN_FOOTSTEP_METAL, SID_ALIEN_FOOTSTEP_METAL}
+    },
+    // Predator
+    {
+        {SID_PREDATOR_FOOTSTEP, SID_PREDATOR_FOOTSTEP, SID_PREDATOR_FOOTSTEP},
+        {SID_PREDATOR_FOOTSTEP_METAL, SID_PREDATOR_FOOTSTEP_METAL, SID_PREDATOR_FOOTSTEP_METAL}
+    }
+};
+
+static void GL_InitFootsteps(void)
+{
+    memset(&Footsteps, 0, sizeof(GL_FOOTSTEP_SCHEDULER));
+    
+    for(int i = 0; i < GL_FOOTSTEP_VOICES; i++)
+    {
+        Footsteps.aVoices[i].iHandle = SOUND_NOACTIVEINDEX;
+    }
+    
+    // Nothing to merge with yet
+    for(int i = 0; i < GL_FOOTSTEP_SOURCES; i++)
+    {
+        Footsteps.iLastTime[i] = -GL_FOOTSTEP_COALESCE_TIME;
+    }
+    Footsteps.bInitialized = 1;
+}
+
+static int GL_FootstepsClose(VECTORCH* pA, VECTORCH* pB)
+{
+    VECTORCH vDelta = SubtractVectors(pA, pB);
+    return Approximate3dMagnitude(&vDelta) < GL_FOOTSTEP_COALESCE_DIST;
+}
+
+/* ================================================================
+   Queue
+   ================================================================ */
+void GL_QueueFootstep(int iSource, int iSpecies, int iLeg,
+                      const VECTORCH* pFoot, DISPLAYBLOCK* pBody)
+{
+    if(!Player || iSource < 0 || iSource >= GL_FOOTSTEP_SOURCES ||
+       iSpecies < I_Marine || iSpecies > I_Predator)
+        return;
+    
+    if(!Footsteps.bInitialized)
+        GL_InitFootsteps();
+    
+    VECTORCH vFoot = *pFoot;
+    VECTORCH vToPlayer = SubtractVectors(&vFoot, &Player->ObWorld);
+    int iDistance = Approximate3dMagnitude(&vToPlayer);
+    
+    if(iDistance > GL_FOOTSTEP_MAX_DIST)
+        return;
+    
+    // Same body just played a step here
+    if(Footsteps.iTime - Footsteps.iLastTime[iSource] < GL_FOOTSTEP_COALESCE_TIME &&
+       GL_FootstepsClose(&vFoot, &Footsteps.vLastPosition[iSource]))
+    {
+        Footsteps.iNumMerged++;
+        return;
+    }
+    
+    // Same body already queued a step here
+    for(int i = 0; i < Footsteps.iNumQueued; i++)
+    {
+        GL_FOOTSTEP_EVENT* pEvent = &Footsteps.aQueue[i];
+        
+        if(pEvent->iSource == iSource && GL_FootstepsClose(&vFoot, &pEvent->vPosition))
+        {
+            pEvent->iMerged++;
+            Footsteps.iNumMerged++;
+            return;
+        }
+    }
+    
+    GL_FOOTSTEP_EVENT* pEvent;
+    if(Footsteps.iNumQueued < GL_FOOTSTEP_QUEUE)
+    {
+        pEvent = &Footsteps.aQueue[Footsteps.iNumQueued++];
+    }
+    else
+    {
+        // Full: replace the farthest step if this one is closer
+        pEvent = &Footsteps.aQueue[0];
+        for(int i = 1; i < GL_FOOTSTEP_QUEUE; i++)
+        {
+            if(Footsteps.aQueue[i].iDistance > pEvent->iDistance)
+                pEvent = &Footsteps.aQueue[i];
+        }
+        
+        Footsteps.iNumDropped++;
+        if(pEvent->iDistance <= iDistance)
+            return;
+    }
+    
+    pEvent->vPosition = vFoot;
+    pEvent->pBody = pBody;
+    pEvent->iSource = iSource;
+    pEvent->iSpecies = iSpecies;
+    pEvent->iLeg = iLeg;
+    pEvent->iMerged = 0;
+    pEvent->iDistance = iDistance;
+}
+
+/* ================================================================
+   Surface Under a Foot
+   AvP's collision polygons carry no material, so the surface is told
+   from what a short downward probe under the foot hits.
+   ================================================================ */
+static int GL_GetFootstepSurface(const GL_FOOTSTEP_EVENT* pEvent)
+{
+    VECTORCH vSource = pEvent->vPosition;
+    VECTORCH vDown = {0, ONE_FIXED, 0};     // World +y is down
+    
+    vSource.vy -= GL_FOOTSTEP_PROBE_HEIGHT;
+    
+    FindPolygonInLineOfSight(&vDown, &vSource, 0, pEvent->pBody);
+    
+    if(!LOS_ObjectHitPtr || LOS_Lambda > GL_FOOTSTEP_PROBE_HEIGHT + GL_FOOTSTEP_PROBE_DEPTH)
+        return GL_SURFACE_DEFAULT;
+    
+    // Level geometry has no strategy block
+    STRATEGYBLOCK* pSB = LOS_ObjectHitPtr->ObStrategyBlock;
+    if(!pSB)
+        return GL_SURFACE_DEFAULT;
+    
+    switch(pSB->I_SBtype)
+    {
+        case I_BehaviourProximityDoor:
+        case I_BehaviourLiftDoor:
+        case I_BehaviourSwitchDoor:
+        case I_BehaviourPlatform:
+        case I_BehaviourInanimateObject:
+            return GL_SURFACE_METAL;
+        default:
+            return GL_SURFACE_DEFAULT;
+    }
+}
+
+/* ================================================================
+   Voices
+   ================================================================ */
+
+// Free voice, or the farthest one playing a step farther than
+// iDistance (stopped), or NULL
+static GL_FOOTSTEP_VOICE* GL_GetFootstepVoice(int iDistance)
+{
+    GL_FOOTSTEP_VOICE* pFarthest = NULL;
+    
+    for(int i = 0; i < GL_FOOTSTEP_VOICES; i++)
+    {
+        GL_FOOTSTEP_VOICE* pVoice = &Footsteps.aVoices[i];
+        
+        if(pVoice->iHandle == SOUND_NOACTIVEINDEX)
+            return pVoice;
+        
+        if(!pFarthest || pVoice->iDistance > pFarthest->iDistance)
+            pFarthest = pVoice;
+    }
+    
+    if(pFarthest->iDistance <= iDistance)
+        return NULL;
+    
+    Sound_Stop(pFarthest->iHandle);
+    pFarthest->iHandle = SOUND_NOACTIVEINDEX;
+    return pFarthest;
+}
+
+static void GL_PlayFootstep(const GL_FOOTSTEP_EVENT* pEvent, GL_FOOTSTEP_VOICE* pVoice)
+{
+    int iSurface = GL_GetFootstepSurface(pEvent);
+    int iPair = (pEvent->iLeg >> 1) % 3;
+    int iSound = FootstepSamples[pEvent->iSpecies][iSurface][iPair];
+    
+    if(iSound == SID_NOSOUND)
+        iSound = FootstepSamples[pEvent->iSpecies][GL_SURFACE_DEFAULT][iPair];
+    
+    int iVolume = GL_FOOTSTEP_VOLUME + pEvent->iMerged * GL_FOOTSTEP_MERGE_VOLUME;
+    if(iVolume > GL_FOOTSTEP_MAX_VOLUME)
+        iVolume = GL_FOOTSTEP_MAX_VOLUME;
+    
+    VECTORCH vPosition = pEvent->vPosition;
+    Sound_Play(iSound, "dve", &vPosition, iVolume, &pVoice->iHandle);
+    pVoice->iDistance = pEvent->iDistance;
+    
+    Footsteps.iLastTime[pEvent->iSource] = Footsteps.iTime;
+    Footsteps.vLastPosition[pEvent->iSource] = pEvent->vPosition;
+}
+
+/* ================================================================
+   Flush (once per frame)
+   ================================================================ */
+void GL_FlushFootsteps(void)
+{
+    if(!Footsteps.bInitialized)
+        return;
+    
+    Footsteps.iTime += NormalFrameTime;
+    
+    // Closest first (insertion sort, the queue is short)
+    for(int i = 1; i < Footsteps.iNumQueued; i++)
+    {
+        GL_FOOTSTEP_EVENT Event = Footsteps.aQueue[i];
+        int j = i - 1;
+        
+        while(j >= 0 && Footsteps.aQueue[j].iDistance > Event.iDistance)
+        {
+            Footsteps.aQueue[j + 1] = Footsteps.aQueue[j];
+            j--;
+        }
+        Footsteps.aQueue[j + 1] = Event;
+    }
+    
+    for(int i = 0; i < Footsteps.iNumQueued; i++)
+    {
+        GL_FOOTSTEP_VOICE* pVoice = GL_GetFootstepVoice(Footsteps.aQueue[i].iDistance);
+        
+        // Every voice plays a closer step, and so would the rest
+        if(!pVoice)
+        {
+            Footsteps.iNumDropped += Footsteps.iNumQueued - i;
+            break;
+        }
+        
+        GL_PlayFootstep(&Footsteps.aQueue[i], pVoice);
+        Footsteps.iNumPlayed++;
+    }
+    
+    Footsteps.iNumQueued = 0;
+}
+
+void GL_ShutdownFootsteps(void)
+{
+    if(!Footsteps.bInitialized)
+        return;
+    
+    for(int i = 0; i < GL_FOOTSTEP_VOICES; i++)
+    {
+        if(Footsteps.aVoices[i].iHandle != SOUND_NOACTIVEINDEX)
+            Sound_Stop(Footsteps.aVoices[i].iHandle);
+    }
+    
+    Footsteps.bInitialized = 0;
+}
+
+void GL_FootstepDebug(void)
+{
+    int iBusy = 0;
+    
+    for(int i = 0; i < GL_FOOTSTEP_VOICES; i++)
+    {
+        if(Footsteps.aVoices[i].iHandle != SOUND_NOACTIVEINDEX)
+            iBusy++;
+    }
+    
+    textprint("Footsteps: %d/%d voices, %d played, %d merged, %d dropped\n",
+        iBusy, GL_FOOTSTEP_VOICES, Footsteps.iNumPlayed,
+        Footsteps.iNumMerged, Footsteps.iNumDropped);
+}
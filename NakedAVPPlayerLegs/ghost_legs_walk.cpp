@@ -0,0 +1,413 @@
+// ================================================================
+// File: ghost_legs_walk.cpp
+// Drives the AvP creature legs from the procedural walk core
+// (FixedWalkSystem), so feet are planted on the level geometry instead
+// of swinging on a fixed sine: the player's first-person legs, and a
+// pool of GLW_MAX_CREATURES NPC bodies updated in batches.
+//
+// The planner runs in 16.16 fixed point in a local frame:
+//
+//   walk X = world vx, walk Y = world vz (forward), walk Z = -world vy (up)
+//   1 walk unit = WorldPerWalkUnit world units, origin = Anchor (a recent
+//   player position)
+//
+// 16.16 only covers +-32768 walk units, so the frame is re-anchored on
+// the player whenever the body drifts RebaseDistance away from the
+// anchor. Terrain comes from a downward line-of-sight probe against the
+// level and the module system (AvPTerrainQuery). Every body has its own
+// frame, planner and probe cache.
+// ================================================================
+
+#define PWS_USE_ENGINE_SINE
+#define PROCEDURAL_WALK_NO_EXAMPLE
+#include "procedural_footsystem.cpp"
+
+extern "C"
+{
+#include "3dc.h"
+#include "inline.h"
+#include "module.h"
+#include "dynblock.h"
+#include "los.h"
+#include "ghost_legs_walk.h"
+}
+
+namespace
+{
+    const int WorldPerWalkUnit = 10;
+    const int RebaseDistance = 1000;       // Walk units from the anchor
+    const int TeleportDistance = 5000;     // World units moved in one update
+    const int ProbeDepth = 3000;           // World units below the body centre
+    const int WalkableNormalUp = 45875;    // ~0.7 ONE_FIXED (45 degree slope)
+    const int ModuleProbeLift = 50;        // Look for a module just above a hit
+
+    // Per-species gait; hip positions come from the creature config
+    struct SpeciesGait
+    {
+        const char* ParameterSet;          // Section in GLW_PARAMS_FILE
+        int Groups[GLW_MAX_LEGS];          // Legs of one group swing together
+        int TuckHeight;                    // Walk units below the hips in the air
+    };
+
+    // Indexed by AvP.PlayerType (I_Marine, I_Alien, I_Predator)
+    const SpeciesGait GaitTable[3] =
+    {
+        { "marine",   { 0, 1 },             60 },
+        { "alien",    { 0, 1, 1, 0, 0, 1 }, 30 },  // Tripod: FL, MR, BL / FR, ML, BR
+        { "predator", { 0, 1 },             70 },
+    };
+
+    Fixed16 WorldToWalk(int world)
+    {
+        return Fixed16::FromRaw(int32_t((int64_t(world) * Fixed16::One) / WorldPerWalkUnit));
+    }
+
+    int WalkToWorld(Fixed16 walk)
+    {
+        return int((int64_t(walk.Raw()) * WorldPerWalkUnit + Fixed16::One / 2) >> 16);
+    }
+
+    FixedVector3 ToLocal(const VECTORCH& world, const VECTORCH& anchor)
+    {
+        return FixedVector3(WorldToWalk(world.vx - anchor.vx),
+                            WorldToWalk(world.vz - anchor.vz),
+                            WorldToWalk(anchor.vy - world.vy));
+    }
+
+    VECTORCH ToWorld(const FixedVector3& local, const VECTORCH& anchor)
+    {
+        VECTORCH world;
+        world.vx = anchor.vx + WalkToWorld(local.X);
+        world.vy = anchor.vy - WalkToWorld(local.Z);
+        world.vz = anchor.vz + WalkToWorld(local.Y);
+        return world;
+    }
+
+    // Engine yaw (4096 per turn, clockwise from above) to walk turns
+    Fixed16 FacingTurns(const DISPLAYBLOCK* pBlock)
+    {
+        return Fixed16::FromRaw(-((pBlock->ObEuler.EulerY & 4095) << 4));
+    }
+
+    // ITerrainQuery on the level geometry around one body. One probe
+    // answers height, normal and walkability for a spot, and the last one
+    // is reused, since the core asks for the same spot several times in a
+    // row.
+    class AvPTerrainQuery : public FixedTerrainQuery
+    {
+        struct Probe
+        {
+            int X, Z;
+            bool bHit;
+            VECTORCH Point;
+            VECTORCH Normal;
+        };
+
+        const VECTORCH* Anchor;
+        DISPLAYBLOCK* const* Body;
+        mutable Probe LastProbe{};
+        mutable bool bLastProbeValid = false;
+
+    public:
+        AvPTerrainQuery(const VECTORCH* anchor, DISPLAYBLOCK* const* body) : Anchor(anchor), Body(body) {}
+
+        // Doors and lifts move, so probes are only reused within an update
+        void Invalidate() { bLastProbeValid = false; }
+
+        FixedVector3 GetSurfaceNormal(const FixedVector3& position) const override
+        {
+            const Probe& probe = Cast(position);
+            if (!probe.bHit)
+                return FixedVector3(Fixed16(), Fixed16(), Fixed16::FromInt(1));
+
+            return FixedVector3(Fixed16::FromRaw(probe.Normal.vx),
+                                Fixed16::FromRaw(probe.Normal.vz),
+                                Fixed16::FromRaw(-probe.Normal.vy));
+        }
+
+        // Nothing below: keep the height the core asked about
+        Fixed16 GetSurfaceHeight(const FixedVector3& position) const override
+        {
+            const Probe& probe = Cast(position);
+            if (!probe.bHit)
+                return position.Z;
+
+            return WorldToWalk(Anchor->vy - probe.Point.vy);
+        }
+
+        bool IsWalkable(const FixedVector3& position) const override
+        {
+            const Probe& probe = Cast(position);
+            if (!probe.bHit || -probe.Normal.vy < WalkableNormalUp)
+                return false;
+
+            VECTORCH above = probe.Point;
+            above.vy -= ModuleProbeLift;
+            return ModuleFromPosition(&above, nullptr) != nullptr;
+        }
+
+    private:
+        // Straight down from body height at the spot's x/z, ignoring the body
+        const Probe& Cast(const FixedVector3& position) const
+        {
+            VECTORCH world = ToWorld(position, *Anchor);
+            if (bLastProbeValid && LastProbe.X == world.vx && LastProbe.Z == world.vz)
+                return LastProbe;
+
+            VECTORCH source = { world.vx, (*Body)->ObWorld.vy, world.vz };
+            VECTORCH down = { 0, ONE_FIXED, 0 };
+            FindPolygonInLineOfSight(&down, &source, 0, *Body);
+
+            LastProbe.X = world.vx;
+            LastProbe.Z = world.vz;
+            LastProbe.bHit = LOS_ObjectHitPtr && LOS_Lambda <= ProbeDepth;
+            if (LastProbe.bHit)
+            {
+                LastProbe.Point = LOS_Point;
+                LastProbe.Normal = LOS_ObjectNormal;
+            }
+            bLastProbeValid = true;
+            return LastProbe;
+        }
+    };
+
+    // Planner state of one body; kept in fixed slots and reused, so the
+    // planner and probe cache are only allocated the first time
+    struct CreatureWalk
+    {
+        std::shared_ptr<AvPTerrainQuery> Terrain;
+        std::unique_ptr<FixedWalkSystem> Walk;
+        DISPLAYBLOCK* Body = nullptr;
+        VECTORCH Anchor{};
+        VECTORCH LastWorld{};
+        int Species = -1;
+        bool bWasMoving[GLW_MAX_LEGS] = {};
+        bool bWasAirborne = false;
+    };
+
+    bool bInitialized = false;
+    WalkParameterLibrary Library;
+    CreatureWalk PlayerLegs;
+    CreatureWalk Creatures[GLW_MAX_CREATURES];
+    int ParamsPollTime = 0;
+
+    // Re-anchor the local frame on the body and plant the feet there
+    void PlaceAtBody(CreatureWalk& legs)
+    {
+        legs.Anchor = legs.Body->ObWorld;
+        legs.LastWorld = legs.Body->ObWorld;
+        legs.Walk->SetFacing(FacingTurns(legs.Body));
+        legs.Walk->Teleport(FixedVector3());
+        legs.Walk->PlantFeetUnderHips(true);
+
+        for (bool& bMoving : legs.bWasMoving)
+            bMoving = false;
+        legs.bWasAirborne = false;
+    }
+
+    // Hot-reload the parameter file about once a second (the player and
+    // the NPC batch both advance this clock, so polls may come sooner)
+    void PollParameters(int deltaTime)
+    {
+        ParamsPollTime += deltaTime;
+        if (ParamsPollTime < ONE_FIXED)
+            return;
+
+        ParamsPollTime = 0;
+        if (Library.PollForChanges())
+            Library.ReclaimRetired();   // Single threaded: no reader is mid-update
+    }
+
+    void ReleaseBody(CreatureWalk& legs)
+    {
+        legs.Species = -1;
+        legs.Body = nullptr;
+    }
+
+    void ResetBody(CreatureWalk& legs, DISPLAYBLOCK* pBody, int species,
+                   const VECTORCH* pHipOffsets, int legCount)
+    {
+        if (!bInitialized)
+            GLW_Init();
+
+        ReleaseBody(legs);
+        if (!pBody || species < 0 || species >= 3 || legCount < 1)
+            return;
+        if (legCount > GLW_MAX_LEGS)
+            legCount = GLW_MAX_LEGS;
+
+        legs.Body = pBody;
+        if (!legs.Terrain)
+            legs.Terrain = std::make_shared<AvPTerrainQuery>(&legs.Anchor, &legs.Body);
+        if (!legs.Walk)
+            legs.Walk.reset(new FixedWalkSystem(legs.Terrain));
+
+        const SpeciesGait& gait = GaitTable[species];
+        legs.Walk->SetParameterSet(Library.Find(gait.ParameterSet));
+        legs.Walk->SetTuckHeight(Fixed16::FromInt(gait.TuckHeight));
+
+        // Config offsets are already ONE_FIXED, so only the unit scale applies
+        std::vector<FixedVector3> hips;
+        std::vector<int> groups;
+        for (int i = 0; i < legCount; i++)
+        {
+            hips.push_back(FixedVector3(Fixed16::FromRaw(pHipOffsets[i].vx / WorldPerWalkUnit),
+                                        Fixed16::FromRaw(pHipOffsets[i].vy / WorldPerWalkUnit),
+                                        Fixed16::FromRaw(pHipOffsets[i].vz / WorldPerWalkUnit)));
+            groups.push_back(gait.Groups[i]);
+        }
+        legs.Walk->SetLegLayout(hips, groups);
+
+        legs.Species = species;
+        legs.Terrain->Invalidate();
+        PlaceAtBody(legs);
+    }
+
+    // One planner step for a body; false when the planner does not drive it
+    bool UpdateBody(CreatureWalk& legs, int deltaTime, GLW_LEGS_OUTPUT* pOut)
+    {
+        DISPLAYBLOCK* pBody = legs.Body;
+        if (legs.Species < 0 || !pBody || !pBody->ObStrategyBlock)
+            return false;
+
+        // Wall crawling: the core only knows one "up", the caller poses the legs
+        DYNAMICSBLOCK* pDyn = pBody->ObStrategyBlock->DynPtr;
+        if (!pDyn || !pDyn->UseStandardGravity)
+            return false;
+
+        legs.Terrain->Invalidate();
+
+        // Respawns and teleports restart the gait where the body now is
+        VECTORCH moved = SubtractVectors(&pBody->ObWorld, &legs.LastWorld);
+        if (Approximate3dMagnitude(&moved) > TeleportDistance)
+            PlaceAtBody(legs);
+        legs.LastWorld = pBody->ObWorld;
+
+        // Keep the local coordinates well inside the 16.16 range
+        FixedVector3 body = ToLocal(pBody->ObWorld, legs.Anchor);
+        Fixed16 limit = Fixed16::FromInt(RebaseDistance);
+        if (body.X > limit || -body.X > limit || body.Y > limit || -body.Y > limit ||
+            body.Z > limit || -body.Z > limit)
+        {
+            legs.Walk->Rebase(FixedVector3() - body);
+            legs.Anchor = pBody->ObWorld;
+            body = FixedVector3();
+        }
+
+        FixedVector3 velocity(WorldToWalk(pDyn->LinVelocity.vx),
+                              WorldToWalk(pDyn->LinVelocity.vz),
+                              WorldToWalk(-pDyn->LinVelocity.vy));
+
+        legs.Walk->SetFacing(FacingTurns(pBody));
+        legs.Walk->SetAirborne(!pDyn->IsInContactWithFloor);
+        legs.Walk->UpdateTracked(Fixed16::FromRaw(deltaTime), body, velocity);
+
+        const std::vector<FixedLeg>& walkLegs = legs.Walk->GetLegs();
+        bool bAirborne = legs.Walk->IsAirborne();
+        bool bLanded = legs.bWasAirborne && !bAirborne;
+        legs.bWasAirborne = bAirborne;
+
+        pOut->iLegCount = std::min(int(walkLegs.size()), GLW_MAX_LEGS);
+        pOut->iPlantedThisUpdate = 0;
+        pOut->bAirborne = bAirborne;
+
+        for (int i = 0; i < pOut->iLegCount; i++)
+        {
+            const FixedLeg& leg = walkLegs[i];
+            GLW_LEG_STATE& state = pOut->aLegs[i];
+
+            VECTORCH foot = ToWorld(leg.Foot.CurrentPosition, legs.Anchor);
+            state.vFootOffset = SubtractVectors(&foot, &pBody->ObWorld);
+            state.iSwingPhase = leg.bIsMoving ? std::min(std::max(leg.Foot.Phase.Raw(), 0), 65535) : 0;
+            state.bPlanted = leg.Foot.bIsPlanted;
+
+            // Touch-down: a swing ended, or every foot on landing from a jump
+            if ((legs.bWasMoving[i] && leg.Foot.bIsPlanted) || bLanded)
+                pOut->iPlantedThisUpdate |= 1 << i;
+            legs.bWasMoving[i] = leg.bIsMoving;
+        }
+
+        return true;
+    }
+}
+
+void GLW_Init(void)
+{
+    if (bInitialized)
+        return;
+
+    // Missing sets fall back to the core's defaults
+    if (!Library.LoadFromFile(GLW_PARAMS_FILE))
+        textprint("%s - using default walk parameters\n", Library.GetLastError().c_str());
+
+    ParamsPollTime = 0;
+    bInitialized = true;
+}
+
+void GLW_Shutdown(void)
+{
+    PlayerLegs.Walk.reset();
+    PlayerLegs.Terrain.reset();
+    ReleaseBody(PlayerLegs);
+
+    for (CreatureWalk& legs : Creatures)
+    {
+        legs.Walk.reset();
+        legs.Terrain.reset();
+        ReleaseBody(legs);
+    }
+
+    Library.ReclaimRetired();
+}
+
+// Player
+
+void GLW_ResetPlayer(int iSpecies, const VECTORCH* pHipOffsets, int iLegCount)
+{
+    ResetBody(PlayerLegs, Player, iSpecies, pHipOffsets, iLegCount);
+}
+
+int GLW_UpdatePlayer(int iSpecies, int iDeltaTime, GLW_LEGS_OUTPUT* pOut)
+{
+    if (PlayerLegs.Species != iSpecies || PlayerLegs.Body != Player)
+        return 0;
+
+    PollParameters(iDeltaTime);
+    return UpdateBody(PlayerLegs, iDeltaTime, pOut) ? 1 : 0;
+}
+
+// NPC pool
+
+void GLW_ResetCreature(int iSlot, DISPLAYBLOCK* pBody, int iSpecies,
+                       const VECTORCH* pHipOffsets, int iLegCount)
+{
+    if (iSlot < 0 || iSlot >= GLW_MAX_CREATURES)
+        return;
+    ResetBody(Creatures[iSlot], pBody, iSpecies, pHipOffsets, iLegCount);
+}
+
+void GLW_ReleaseCreature(int iSlot)
+{
+    if (iSlot < 0 || iSlot >= GLW_MAX_CREATURES)
+        return;
+    ReleaseBody(Creatures[iSlot]);
+}
+
+void GLW_UpdateCreatures(const GLW_CREATURE_UPDATE* pUpdates, int iCount, GLW_LEGS_OUTPUT* pOutputs)
+{
+    if (iCount > 0)
+        PollParameters(pUpdates[0].iDeltaTime);
+
+    for (int i = 0; i < iCount; i++)
+    {
+        const GLW_CREATURE_UPDATE& update = pUpdates[i];
+        GLW_LEGS_OUTPUT* pOut = &pOutputs[i];
+
+        pOut->iLegCount = 0;
+        if (update.iSlot < 0 || update.iSlot >= GLW_MAX_CREATURES)
+            continue;
+
+        if (!UpdateBody(Creatures[update.iSlot], update.iDeltaTime, pOut))
+            pOut->iLegCount = 0;
+    }
+}
@@ -0,0 +1,69 @@
+/* ================================================================
+   File: ghost_legs_walk.h
+   Bridge from the AvP ghost legs to the procedural walk core
+   (ghost_legs_walk.cpp). Include after 3dc.h.
+   ================================================================ */
+
+#ifndef GHOST_LEGS_WALK_H
+#define GHOST_LEGS_WALK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GLW_MAX_LEGS        6
+#define GLW_MAX_CREATURES   64      // NPC bodies planned at once
+#define GLW_PARAMS_FILE     "walk_params.txt"
+
+typedef struct GLW_LEG_STATE
+{
+    VECTORCH vFootOffset;           // Foot relative to the body's ObWorld (world axes)
+    int iSwingPhase;                // 0-65535 through a swing, 0 while planted
+    int bPlanted;
+} GLW_LEG_STATE;
+
+typedef struct GLW_LEGS_OUTPUT
+{
+    int iLegCount;
+    GLW_LEG_STATE aLegs[GLW_MAX_LEGS];
+    int iPlantedThisUpdate;         // Bit per leg that touched down this update
+    int bAirborne;
+} GLW_LEGS_OUTPUT;
+
+typedef struct GLW_CREATURE_UPDATE
+{
+    int iSlot;                      // 0 .. GLW_MAX_CREATURES-1
+    int iDeltaTime;                 // Time since this body was last planned
+} GLW_CREATURE_UPDATE;
+
+/* ================================================================
+   Interface
+   Hip offsets are ONE_FIXED world units in the body frame: vx right,
+   vy forward, vz up (as in creature_legs.txt).
+   ================================================================ */
+void GLW_Init(void);
+void GLW_Shutdown(void);
+void GLW_ResetPlayer(int iSpecies, const VECTORCH* pHipOffsets, int iLegCount);
+
+// Plans the player's feet for iDeltaTime (ONE_FIXED seconds). Returns 0
+// when the planner does not drive the legs (not reset, wall crawling);
+// pOut is left untouched then.
+int GLW_UpdatePlayer(int iSpecies, int iDeltaTime, GLW_LEGS_OUTPUT* pOut);
+
+/* ================================================================
+   NPC Pool
+   Slots are owned by the caller (ghost_legs_creatures.c). A slot keeps
+   its planner between uses; reset it when it gets a new body. Outputs
+   are relative to the body's ObWorld, and iLegCount is 0 for bodies
+   the planner did not drive this time.
+   ================================================================ */
+void GLW_ResetCreature(int iSlot, DISPLAYBLOCK* pBody, int iSpecies,
+                       const VECTORCH* pHipOffsets, int iLegCount);
+void GLW_ReleaseCreature(int iSlot);
+void GLW_UpdateCreatures(const GLW_CREATURE_UPDATE* pUpdates, int iCount, GLW_LEGS_OUTPUT* pOutputs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GHOST_LEGS_WALK_H
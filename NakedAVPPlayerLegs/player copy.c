@@ -64,49 +64,7 @@ void MaintainPlayer(void)
    ================================================================ */
 void PlayCreatureFootstepSounds(void)
 {
-    if(!EnhancedLegs.bActive)
-        return;
-    
-    // Check for foot plants (when leg phase resets)
-    static int lastLegPhases[6] = {0};
-    
-    for(int i = 0; i < EnhancedLegs.pCurrentConfig->iLegCount; i++)
-    {
-        // Check if leg just planted (phase wrapped around)
-        if(EnhancedLegs.iLegPhases[i] < lastLegPhases[i])
-        {
-            // Foot planted - play sound
-            PlayCreatureFootstep(i);
-        }
-        
-        lastLegPhases[i] = EnhancedLegs.iLegPhases[i];
-    }
-}
-
-void PlayCreatureFootstep(int legIndex)
-{
-    VECTORCH soundPos = Player->ObWorld;
-    
-    // Adjust position based on which leg
-    switch(EnhancedLegs.iCreatureType)
-    {
-        case I_Marine:
-            Sound_Play(SID_MARINE_FOOTSTEP, "d", &soundPos);
-            break;
-            
-        case I_Alien:
-            // Alien has different footstep sounds
-            switch(legIndex % 3)
-            {
-                case 0: Sound_Play(SID_ALIEN_FOOTSTEP_FRONT, "d", &soundPos); break;
-                case 1: Sound_Play(SID_ALIEN_FOOTSTEP_MID, "d", &soundPos); break;
-                case 2: Sound_Play(SID_ALIEN_FOOTSTEP_BACK, "d", &soundPos); break;
-            }
-            break;
-            
-        case I_Predator:
-            // Predator has heavy, metallic footsteps
-            Sound_Play(SID_PREDATOR_FOOTSTEP, "d", &soundPos);
-            break;
-    }
+    // Plants are queued by the player's and NPCs' legs; play them once
+    // per frame, after GL_UpdateNPCLegs()
+    GL_FlushFootsteps();
 }
\ No newline at end of file
@@ -29,8 +29,8 @@ void PlayerIsDead(DAMAGE_PROFILE* damage,int multiplier,VECTORCH* incoming)
 {
     // ... existing death code ...
     
-    // Destroy legs when player dies
-    GL_DestroyLegs();
+    // Hide legs when player dies (the blocks are kept for respawn)
+    GL_SetLegsVisible(0);
     
     // ... rest of existing code ...
 }
\ No newline at end of file
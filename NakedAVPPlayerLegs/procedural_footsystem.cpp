@@ -3,102 +3,400 @@
 #include <vector>
 #include <cmath>
 #include <memory>
+#include <algorithm>
+
+#include "procedural_walk_numeric.h"
+#include "procedural_walk_params.h"
+#include "procedural_walk_profiler.h"
+
+// The walk core is templated on a numeric policy from
+// procedural_walk_numeric.h. The float build keeps the original names
+// (FVector3, ProceduralWalkSystem, ...); the 16.16 build for AvP uses the
+// Fixed* aliases at the end of the core.
 
 // Vector3 class for position/movement
-struct FVector3
+template <typename Math>
+struct TVector3
 {
-    float X, Y, Z;
+    using Scalar = typename Math::Scalar;
+    
+    Scalar X, Y, Z;
+    
+    TVector3(Scalar x = Scalar(), Scalar y = Scalar(), Scalar z = Scalar()) : X(x), Y(y), Z(z) {}
     
-    FVector3(float x = 0, float y = 0, float z = 0) : X(x), Y(y), Z(z) {}
+    TVector3 operator+(const TVector3& other) const {
+        return TVector3(X + other.X, Y + other.Y, Z + other.Z);
+    }
     
-    FVector3 operator+(const FVector3& other) const {
-        return FVector3(X + other.X, Y + other.Y, Z + other.Z);
+    TVector3 operator-(const TVector3& other) const {
+        return TVector3(X - other.X, Y - other.Y, Z - other.Z);
     }
     
-    FVector3 operator-(const FVector3& other) const {
-        return FVector3(X - other.X, Y - other.Y, Z - other.Z);
+    TVector3 operator*(Scalar scalar) const {
+        return TVector3(X * scalar, Y * scalar, Z * scalar);
     }
     
-    FVector3 operator*(float scalar) const {
-        return FVector3(X * scalar, Y * scalar, Z * scalar);
+    Scalar Length() const {
+        return Math::Length3(X, Y, Z);
     }
     
-    float Length() const {
-        return std::sqrt(X*X + Y*Y + Z*Z);
+    Scalar Dot(const TVector3& other) const {
+        return X * other.X + Y * other.Y + Z * other.Z;
     }
     
-    FVector3 Normalized() const {
-        float len = Length();
-        if (len > 0.0001f)
-            return *this * (1.0f / len);
+    TVector3 Normalized() const {
+        Scalar len = Length();
+        if (len > Math::FromFloat(0.0001f))
+            return *this * (Math::FromInt(1) / len);
         return *this;
     }
 };
 
 // Foot data structure
-struct FootData
+template <typename Math>
+struct TFootData
 {
-    FVector3 CurrentPosition;      // Current world position
-    FVector3 TargetPosition;       // Target placement position
-    FVector3 PreviousPosition;     // Previous frame position
-    FVector3 SwingOffset;          // Lift during swing phase
-    float Phase = 0.0f;           // 0-1 cycle phase
-    float Weight = 0.0f;          // IK weight/blend
+    using Scalar = typename Math::Scalar;
+    
+    TVector3<Math> CurrentPosition;      // Current world position
+    TVector3<Math> TargetPosition;       // Target placement position
+    TVector3<Math> PreviousPosition;     // Previous frame position
+    TVector3<Math> SwingOffset;          // Lift during swing phase
+    Scalar Phase{};               // 0-1 cycle phase
+    Scalar Weight{};              // IK weight/blend
     bool bIsPlanted = true;       // Is foot planted on ground?
-    float TimeSinceLift = 0.0f;   // Time since lifted
+    Scalar TimeSinceLift{};       // Time since lifted
 };
 
 // Leg structure
-struct Leg
+template <typename Math>
+struct TLeg
 {
-    FootData Foot;
-    FVector3 HipOffset;           // Local offset from pelvis
-    float LegLength = 100.0f;     // Length from hip to foot
+    TFootData<Math> Foot;
+    TVector3<Math> HipOffset;     // Local offset from pelvis
+    typename Math::Scalar LegLength = Math::FromFloat(100.0f); // Length from hip to foot
     bool bIsMoving = false;
+    int Group = 0;                // Legs in different groups never swing at once
+    int LastTurn = -1;            // Group turn this leg last stepped in
 };
 
 // Terrain query interface
-class ITerrainQuery
+template <typename Math>
+class TTerrainQuery
 {
 public:
-    virtual ~ITerrainQuery() = default;
-    virtual FVector3 GetSurfaceNormal(const FVector3& position) const = 0;
-    virtual float GetSurfaceHeight(const FVector3& position) const = 0;
-    virtual bool IsWalkable(const FVector3& position) const = 0;
+    virtual ~TTerrainQuery() = default;
+    virtual TVector3<Math> GetSurfaceNormal(const TVector3<Math>& position) const = 0;
+    virtual typename Math::Scalar GetSurfaceHeight(const TVector3<Math>& position) const = 0;
+    virtual bool IsWalkable(const TVector3<Math>& position) const = 0;
+};
+
+// Predicts where the body will be a short time ahead, so feet can be
+// planted where the body is going rather than where it is heading now
+template <typename Math>
+class TTrajectoryPredictor
+{
+    using Scalar = typename Math::Scalar;
+    using Vector = TVector3<Math>;
+    
+    static constexpr Scalar Num(float value) { return Math::FromFloat(value); }
+
+public:
+    static constexpr int HistorySize = 8;    // Velocity samples kept for the fit
+    
+    Scalar MaxAcceleration = Num(2000.0f);   // Clamp on the fitted acceleration (u/s^2)
+    Scalar WaypointReachRadius = Num(20.0f); // Distance at which a waypoint counts as reached
+    Scalar RestSpeed = Num(1.0f);            // Below this speed the body counts as standing (u/s)
+    Scalar MinAcceleration = Num(0.01f);     // Below this the fit counts as no acceleration (u/s^2)
+
+private:
+    // Velocity history ring buffer. Samples are stamped with their age
+    // rather than an absolute time so a 16.16 build never overflows.
+    Scalar SampleAges[HistorySize] = {};
+    Vector SampleVelocities[HistorySize];
+    int SampleCount = 0;
+    int SampleHead = 0;
+    
+    // Latest body state
+    Vector Position;
+    Vector Velocity;
+    Vector Acceleration;
+    
+    // Intended path from AI/navigation (overrides extrapolation when set)
+    std::vector<Vector> PathWaypoints;
+    size_t PathIndex = 0;
+    Scalar PathSpeed{};
+
+public:
+    void Reset(const Vector& position)
+    {
+        SampleCount = 0;
+        SampleHead = 0;
+        Position = position;
+        Velocity = Vector();
+        Acceleration = Vector();
+    }
+    
+    // Record the body state for this frame and refit acceleration
+    void AddSample(Scalar deltaTime, const Vector& position, const Vector& velocity)
+    {
+        Position = position;
+        Velocity = velocity;
+        
+        for (int i = 0; i < SampleCount; i++)
+            SampleAges[i] += deltaTime;
+        
+        SampleAges[SampleHead] = Scalar();
+        SampleVelocities[SampleHead] = velocity;
+        SampleHead = (SampleHead + 1) % HistorySize;
+        SampleCount = std::min(SampleCount + 1, HistorySize);
+        
+        FitAcceleration();
+        AdvancePath();
+    }
+    
+    // Follow an explicit path instead of extrapolating velocity history
+    void SetIntendedPath(const std::vector<Vector>& waypoints, Scalar speed)
+    {
+        PathWaypoints = waypoints;
+        PathIndex = 0;
+        PathSpeed = std::max(Scalar(), speed);
+        AdvancePath();
+    }
+    
+    void ClearIntendedPath()
+    {
+        PathWaypoints.clear();
+        PathIndex = 0;
+        PathSpeed = Scalar();
+    }
+    
+    bool HasIntendedPath() const { return PathIndex < PathWaypoints.size(); }
+    
+    // Body position 'time' seconds from now
+    Vector PredictPosition(Scalar time) const
+    {
+        if (HasIntendedPath())
+        {
+            Vector position, direction;
+            SamplePath(PathSpeed * time, position, direction);
+            return position;
+        }
+        
+        Scalar t = StopTime(time);
+        return Position + Velocity * t + Acceleration * (Num(0.5f) * t * t);
+    }
+    
+    // Body velocity 'time' seconds from now
+    Vector PredictVelocity(Scalar time) const
+    {
+        if (HasIntendedPath())
+        {
+            Vector position, direction;
+            if (!SamplePath(PathSpeed * time, position, direction))
+                return Vector();
+            return direction * PathSpeed;
+        }
+        
+        Scalar t = StopTime(time);
+        if (t < time)
+            return Vector(); // Body has come to rest by then
+        return Velocity + Acceleration * t;
+    }
+    
+    const Vector& GetAcceleration() const { return Acceleration; }
+    
+    // Shift the stored positions when the owner moves its origin
+    void Rebase(const Vector& offset)
+    {
+        Position = Position + offset;
+        for (Vector& waypoint : PathWaypoints)
+            waypoint = waypoint + offset;
+    }
+
+private:
+    // Least-squares slope of velocity over the history window
+    void FitAcceleration()
+    {
+        Acceleration = Vector();
+        if (SampleCount < 2)
+            return;
+        
+        Scalar count = Math::FromInt(SampleCount);
+        Scalar meanAge{};
+        Vector meanVelocity;
+        for (int i = 0; i < SampleCount; i++)
+        {
+            meanAge += SampleAges[i];
+            meanVelocity = meanVelocity + SampleVelocities[i];
+        }
+        meanAge = meanAge / count;
+        meanVelocity = meanVelocity * (Math::FromInt(1) / count);
+        
+        // Time runs opposite to age
+        Scalar timeVariance{};
+        Vector covariance;
+        for (int i = 0; i < SampleCount; i++)
+        {
+            Scalar dt = meanAge - SampleAges[i];
+            timeVariance += dt * dt;
+            covariance = covariance + (SampleVelocities[i] - meanVelocity) * dt;
+        }
+        
+        if (timeVariance <= Math::Tiny())
+            return;
+        
+        Acceleration = covariance * (Math::FromInt(1) / timeVariance);
+        
+        Scalar magnitude = Acceleration.Length();
+        if (magnitude > MaxAcceleration)
+            Acceleration = Acceleration * (MaxAcceleration / magnitude);
+    }
+    
+    // When decelerating, extrapolation stops at the moment velocity reaches
+    // zero instead of reversing the body back along its path. A body that
+    // has already stopped stays put: the fit still holds the deceleration
+    // that stopped it, which would otherwise carry it backwards.
+    Scalar StopTime(Scalar time) const
+    {
+        if (Velocity.Length() <= RestSpeed)
+            return Scalar();
+        
+        // Speed along the unit direction of the acceleration rather than
+        // V.A / A.A: walking speed times acceleration is far outside the
+        // 16.16 range, and the wrapped product flips sign
+        Scalar accel = Acceleration.Length();
+        if (accel <= MinAcceleration)
+            return time;
+        
+        Vector direction(Acceleration.X / accel, Acceleration.Y / accel, Acceleration.Z / accel);
+        Scalar closing = Velocity.Dot(direction);
+        if (closing >= Scalar())
+            return time;
+        
+        Scalar timeToStop = -closing / accel;
+        return std::min(time, timeToStop);
+    }
+    
+    // Drop waypoints the body has already reached
+    void AdvancePath()
+    {
+        while (PathIndex < PathWaypoints.size())
+        {
+            Vector delta = PathWaypoints[PathIndex] - Position;
+            delta.Z = Scalar();
+            if (delta.Length() > WaypointReachRadius)
+                break;
+            PathIndex++;
+        }
+    }
+    
+    // Walk 'distance' along the remaining path; returns false past its end
+    bool SamplePath(Scalar distance, Vector& outPosition, Vector& outDirection) const
+    {
+        Vector from = Position;
+        for (size_t i = PathIndex; i < PathWaypoints.size(); i++)
+        {
+            Vector segment = PathWaypoints[i] - from;
+            Scalar length = segment.Length();
+            if (length > Num(0.0001f))
+            {
+                outDirection = segment * (Math::FromInt(1) / length);
+                if (distance <= length)
+                {
+                    outPosition = from + outDirection * distance;
+                    return true;
+                }
+                distance -= length;
+            }
+            from = PathWaypoints[i];
+        }
+        
+        outPosition = from;
+        return false;
+    }
 };
 
 // Main procedural walk system
-class ProceduralWalkSystem
+template <typename Math>
+class TProceduralWalkSystem
 {
+public:
+    using Scalar = typename Math::Scalar;
+    using Vector = TVector3<Math>;
+    using LegType = TLeg<Math>;
+    using TerrainQueryType = TTerrainQuery<Math>;
+
 private:
+    static constexpr Scalar Num(float value) { return Math::FromFloat(value); }
+    
+    // WalkParameters converted to this build's scalar type. Refreshed only
+    // when the set publishes new values or the override changes, so the
+    // per-stage reads stay conversion free in the fixed point build.
+    struct ScalarParameters
+    {
+        Scalar MoveSpeed;
+        Scalar StrideLengthMultiplier;
+        Scalar LiftHeightMultiplier;
+        Scalar StepHeight;
+        Scalar BalanceThreshold;
+        Scalar ReplanTolerance;
+    };
+    
     // Character properties
-    FVector3 CharacterPosition;
-    FVector3 CharacterVelocity;
-    FVector3 CharacterAcceleration;
-    float CharacterHeight = 180.0f;
-    float CharacterRadius = 30.0f;
-    
-    // System parameters
-    float MoveSpeed = 150.0f;         // Units per second
-    float StrideLengthMultiplier = 0.5f;
-    float LiftHeightMultiplier = 1.0f;
-    float StepHeight = 15.0f;        // Max step height
-    float BalanceThreshold = 5.0f;   // Balance correction threshold
+    Vector CharacterPosition;
+    Vector CharacterVelocity;
+    Vector CharacterAcceleration;
+    Scalar CharacterHeight = Num(180.0f);
+    Scalar CharacterRadius = Num(30.0f);
+    
+    // System parameters: a shared archetype set, unless this instance was
+    // given its own values through the per-instance setters
+    const WalkParameterSet* ParameterSet = &WalkParameterSet::Default();
+    std::unique_ptr<WalkParameters> ParameterOverride;
+    
+    mutable ScalarParameters CachedParams{};
+    mutable const WalkParameterSet* CachedSet = nullptr;
+    mutable unsigned CachedGeneration = 0;
+    mutable bool CachedOverride = false;
     
     // Legs
-    std::vector<Leg> Legs;
-    FVector3 PelvisOffset;           // Pelvis offset from character center
+    std::vector<LegType> Legs;
+    Vector PelvisOffset;             // Pelvis offset from character center
+    
+    // Custom leg layout (empty = default four legs)
+    std::vector<Vector> LayoutHipOffsets;
+    std::vector<int> LayoutGroups;
+    
+    // Gait groups take turns: a turn starts when no leg is swinging, and
+    // each leg of the active group steps at most once per turn
+    bool bMultipleGroups = false;
+    int ActiveGroup = 0;
+    int GroupTurn = 0;
+    
+    // Body heading; hip offsets are given in the body frame
+    Scalar FacingSin{};
+    Scalar FacingCos = Math::FromInt(1);
+    
+    // No ground contact (jumping, falling): feet tuck under the hips
+    bool bAirborne = false;
+    Scalar TuckHeight = Num(30.0f);
     
     // State
-    float GaitCycleTime = 0.0f;
-    float TimeSinceLastStep = 0.0f;
-    float StrideDuration = 0.0f;
+    Scalar GaitCycleTime{};
+    Scalar TimeSinceLastStep{};
+    Scalar StrideDuration{};
     
-    // External dependencies
-    std::shared_ptr<ITerrainQuery> TerrainQuery;
+    // Trajectory prediction
+    TTrajectoryPredictor<Math> Trajectory;
+    int StepCount = 0;               // Steps started since creation
+    int ReplanCount = 0;             // Mid-swing re-targets since creation
     
+    // External dependencies
+    std::shared_ptr<TerrainQueryType> TerrainQuery;
+
 public:
-    ProceduralWalkSystem(std::shared_ptr<ITerrainQuery> terrainQuery)
+    TProceduralWalkSystem(std::shared_ptr<TerrainQueryType> terrainQuery)
         : TerrainQuery(terrainQuery)
     {
         InitializeLegs();
@@ -109,15 +407,34 @@ public:
     void InitializeLegs()
     {
         Legs.clear();
+        bMultipleGroups = false;
+        ActiveGroup = 0;
+        GroupTurn = 0;
+        
+        if (!LayoutHipOffsets.empty())
+        {
+            for (size_t i = 0; i < LayoutHipOffsets.size(); i++)
+            {
+                LegType leg;
+                leg.HipOffset = LayoutHipOffsets[i];
+                leg.Group = i < LayoutGroups.size() ? LayoutGroups[i] : 0;
+                Legs.push_back(leg);
+                bMultipleGroups = bMultipleGroups || leg.Group != Legs.front().Group;
+            }
+            ActiveGroup = Legs.front().Group;
+            PlantFeetUnderHips(false);
+            return;
+        }
         
         // Create 2 legs (simplified - actual would have 4 for quadruped)
-        Leg frontLeft, frontRight, backLeft, backRight;
+        LegType frontLeft, frontRight, backLeft, backRight;
         
         // Configure leg offsets (relative to character center)
-        frontLeft.HipOffset = FVector3(-CharacterRadius, CharacterRadius * 0.5f, 0);
-        frontRight.HipOffset = FVector3(CharacterRadius, CharacterRadius * 0.5f, 0);
-        backLeft.HipOffset = FVector3(-CharacterRadius, -CharacterRadius * 0.5f, 0);
-        backRight.HipOffset = FVector3(CharacterRadius, -CharacterRadius * 0.5f, 0);
+        Scalar halfRadius = CharacterRadius * Num(0.5f);
+        frontLeft.HipOffset = Vector(-CharacterRadius, halfRadius, Scalar());
+        frontRight.HipOffset = Vector(CharacterRadius, halfRadius, Scalar());
+        backLeft.HipOffset = Vector(-CharacterRadius, -halfRadius, Scalar());
+        backRight.HipOffset = Vector(CharacterRadius, -halfRadius, Scalar());
         
         Legs.push_back(frontLeft);
         Legs.push_back(frontRight);
@@ -125,126 +442,345 @@ public:
         Legs.push_back(backRight);
         
         // Initialize foot positions
+        PlantFeetUnderHips(false);
+    }
+    
+    // Replace the default four legs; hip offsets are in the body frame
+    // (X right, Y forward). Legs with different group numbers never swing
+    // at the same time (biped: 0/1, hexapod tripod: 0/1/1/0/0/1).
+    void SetLegLayout(const std::vector<Vector>& hipOffsets, const std::vector<int>& groups)
+    {
+        LayoutHipOffsets = hipOffsets;
+        LayoutGroups = groups;
+        InitializeLegs();
+    }
+    
+    // Body heading in turns, counter-clockwise seen from above
+    void SetFacing(Scalar turns)
+    {
+        FacingSin = Math::SinTurns(turns);
+        FacingCos = Math::CosTurns(turns);
+    }
+    
+    // Hip offset rotated to the current heading
+    Vector HipWorldOffset(const LegType& leg) const
+    {
+        return Vector(leg.HipOffset.X * FacingCos - leg.HipOffset.Y * FacingSin,
+                      leg.HipOffset.X * FacingSin + leg.HipOffset.Y * FacingCos,
+                      leg.HipOffset.Z);
+    }
+    
+    // Put every foot straight below its hip, optionally on the terrain
+    void PlantFeetUnderHips(bool bProjectToTerrain)
+    {
         for (auto& leg : Legs)
         {
-            leg.Foot.CurrentPosition = CharacterPosition + leg.HipOffset;
-            leg.Foot.TargetPosition = leg.Foot.CurrentPosition;
-            leg.Foot.PreviousPosition = leg.Foot.CurrentPosition;
+            Vector foot = CharacterPosition + HipWorldOffset(leg);
+            if (bProjectToTerrain)
+                foot.Z = QuerySurfaceHeight(foot);
+            
+            leg.Foot.CurrentPosition = foot;
+            leg.Foot.TargetPosition = foot;
+            leg.Foot.PreviousPosition = foot;
+            leg.Foot.SwingOffset = Vector();
+            leg.Foot.bIsPlanted = true;
+            leg.Foot.Phase = Scalar();
+            leg.Foot.TimeSinceLift = Scalar();
+            leg.bIsMoving = false;
+        }
+    }
+    
+    // Ground contact from the host's physics. Leaving the ground tucks
+    // the feet; landing plants them under the hips on the terrain.
+    void SetAirborne(bool airborne)
+    {
+        if (airborne == bAirborne)
+            return;
+        
+        bAirborne = airborne;
+        if (!bAirborne)
+            PlantFeetUnderHips(true);
+    }
+    
+    bool IsAirborne() const { return bAirborne; }
+    void SetTuckHeight(Scalar height) { TuckHeight = height; }
+    
+    // Move the coordinate origin by 'offset' without disturbing the gait
+    // (keeps a 16.16 build's coordinates small around a moving body)
+    void Rebase(const Vector& offset)
+    {
+        CharacterPosition = CharacterPosition + offset;
+        Trajectory.Rebase(offset);
+        for (auto& leg : Legs)
+        {
+            leg.Foot.CurrentPosition = leg.Foot.CurrentPosition + offset;
+            leg.Foot.TargetPosition = leg.Foot.TargetPosition + offset;
+            leg.Foot.PreviousPosition = leg.Foot.PreviousPosition + offset;
         }
     }
     
     // Update the walk system
-    void Update(float deltaTime, const FVector3& targetVelocity)
+    void Update(Scalar deltaTime, const Vector& targetVelocity)
     {
         // Update character state
         CharacterVelocity = targetVelocity;
         CharacterPosition = CharacterPosition + CharacterVelocity * deltaTime;
         
+        Advance(deltaTime);
+    }
+    
+    // Update with a body moved by the host's own physics
+    void UpdateTracked(Scalar deltaTime, const Vector& position, const Vector& velocity)
+    {
+        CharacterVelocity = velocity;
+        CharacterPosition = position;
+        
+        Advance(deltaTime);
+    }
+
+private:
+    void Advance(Scalar deltaTime)
+    {
+        PWS_PROFILE_SCOPE(WalkProfileStage::Update);
+        
         // Update gait timing
         GaitCycleTime += deltaTime;
         TimeSinceLastStep += deltaTime;
         
+        // Feed the trajectory fit
+        Trajectory.AddSample(deltaTime, CharacterPosition, CharacterVelocity);
+        CharacterAcceleration = Trajectory.GetAcceleration();
+        
+        if (bAirborne)
+        {
+            TuckFeet();
+            return;
+        }
+        
         // Calculate adaptive stride duration based on speed
-        CalculateStrideDuration();
+        {
+            PWS_PROFILE_SCOPE(WalkProfileStage::StrideDuration);
+            CalculateStrideDuration();
+        }
         
         // Predict foot placement positions
-        PredictFootPlacement();
+        {
+            PWS_PROFILE_SCOPE(WalkProfileStage::FootPlacement);
+            PredictFootPlacement();
+        }
         
         // Update each leg's movement
-        for (auto& leg : Legs)
         {
-            UpdateLegMovement(leg, deltaTime);
+            PWS_PROFILE_SCOPE(WalkProfileStage::LegMovement);
+            for (auto& leg : Legs)
+            {
+                UpdateLegMovement(leg, deltaTime);
+            }
         }
         
         // Balance pelvis based on foot positions
-        UpdatePelvisBalance();
+        {
+            PWS_PROFILE_SCOPE(WalkProfileStage::PelvisBalance);
+            UpdatePelvisBalance();
+        }
         
         // Apply terrain adaptation
-        AdaptToTerrain();
+        {
+            PWS_PROFILE_SCOPE(WalkProfileStage::TerrainAdapt);
+            AdaptToTerrain();
+        }
+    }
+    
+    // In the air the feet hang below the hips and nothing is planned
+    void TuckFeet()
+    {
+        for (auto& leg : Legs)
+        {
+            Vector foot = CharacterPosition + HipWorldOffset(leg);
+            foot.Z = foot.Z - TuckHeight;
+            
+            leg.Foot.CurrentPosition = foot;
+            leg.Foot.TargetPosition = foot;
+            leg.Foot.PreviousPosition = foot;
+            leg.Foot.bIsPlanted = false;
+            leg.Foot.Phase = Scalar();
+            leg.bIsMoving = false;
+        }
+    }
+
+public:
+    // Terrain access goes through these so every query is instrumented
+    Scalar QuerySurfaceHeight(const Vector& position) const
+    {
+        PWS_PROFILE_SCOPE(WalkProfileStage::TerrainHeight);
+        return TerrainQuery->GetSurfaceHeight(position);
+    }
+    
+    Vector QuerySurfaceNormal(const Vector& position) const
+    {
+        PWS_PROFILE_SCOPE(WalkProfileStage::TerrainNormal);
+        return TerrainQuery->GetSurfaceNormal(position);
+    }
+    
+    bool QueryWalkable(const Vector& position) const
+    {
+        PWS_PROFILE_SCOPE(WalkProfileStage::TerrainWalkable);
+        return TerrainQuery->IsWalkable(position);
     }
     
     // Calculate stride duration based on speed
     void CalculateStrideDuration()
     {
-        float speed = CharacterVelocity.Length();
-        if (speed < 0.1f) speed = 0.1f;
+        Scalar speed = CharacterVelocity.Length();
+        if (speed < Num(0.1f)) speed = Num(0.1f);
         
         // Base duration with speed inverse relationship
-        float baseDuration = 0.5f; // Base stride duration in seconds
-        StrideDuration = baseDuration * (MoveSpeed / speed) * StrideLengthMultiplier;
-        StrideDuration = std::max(0.1f, std::min(StrideDuration, 2.0f));
+        const ScalarParameters& params = Params();
+        Scalar baseDuration = Num(0.5f); // Base stride duration in seconds
+        StrideDuration = baseDuration * (params.MoveSpeed / speed) * params.StrideLengthMultiplier;
+        StrideDuration = std::max(Num(0.1f), std::min(StrideDuration, Num(2.0f)));
     }
     
     // Predict where feet should be placed
     void PredictFootPlacement()
     {
+        const ScalarParameters& params = Params();
+        Scalar stepThreshold = params.MoveSpeed * StrideDuration * Num(0.1f);
+        
+        if (bMultipleGroups)
+            StartGroupTurn(stepThreshold);
+        
         for (auto& leg : Legs)
         {
-            // Calculate ideal foot position based on velocity
-            FVector3 hipWorldPos = CharacterPosition + leg.HipOffset + PelvisOffset;
-            
-            // Predict future position (one stride ahead)
-            float predictionTime = StrideDuration * 0.5f;
-            FVector3 predictedPosition = hipWorldPos + CharacterVelocity * predictionTime;
-            
-            // Project to terrain
-            predictedPosition.Z = TerrainQuery->GetSurfaceHeight(predictedPosition);
-            
-            // Get surface normal for orientation
-            FVector3 surfaceNormal = TerrainQuery->GetSurfaceNormal(predictedPosition);
-            
-            // Adjust foot orientation to match surface
-            FVector3 footForward = CharacterVelocity.Normalized();
-            FVector3 footRight = FVector3(0, 0, 1).Normalized(); // Simplified
+            if (leg.bIsMoving)
+            {
+                // Course-correct a swing only when the body has diverged
+                // from the trajectory the target was planned against
+                Scalar remaining = std::max(Scalar(), StrideDuration - leg.Foot.TimeSinceLift);
+                Vector landing = PredictLanding(leg, remaining);
+                Vector drift = leg.Foot.TargetPosition - landing;
+                drift.Z = Scalar();
+                
+                if (drift.Length() > params.ReplanTolerance)
+                {
+                    landing.Z = QuerySurfaceHeight(landing);
+                    leg.Foot.TargetPosition = landing;
+                    ReplanCount++;
+                }
+                continue;
+            }
             
-            // If foot needs to move and is not currently moving
-            float distanceToTarget = (leg.Foot.CurrentPosition - predictedPosition).Length();
-            if (distanceToTarget > (MoveSpeed * StrideDuration * 0.1f) && !leg.bIsMoving)
+            if (WantsStep(leg, stepThreshold) && CanLift(leg))
             {
+                // The foot lifts now and plants one stride from now
+                Vector predictedPosition = PredictLanding(leg, StrideDuration);
+                
+                // Project to terrain
+                predictedPosition.Z = QuerySurfaceHeight(predictedPosition);
+                
                 leg.Foot.TargetPosition = predictedPosition;
                 leg.Foot.bIsPlanted = false;
                 leg.bIsMoving = true;
-                leg.Foot.Phase = 0.0f;
-                leg.Foot.TimeSinceLift = 0.0f;
+                leg.Foot.Phase = Scalar();
+                leg.Foot.TimeSinceLift = Scalar();
+                leg.LastTurn = GroupTurn;
+                StepCount++;
             }
         }
     }
     
+    // Step once the planted foot has fallen too far from the hip
+    bool WantsStep(const LegType& leg, Scalar stepThreshold) const
+    {
+        Vector hipWorldPos = CharacterPosition + HipWorldOffset(leg) + PelvisOffset;
+        Vector offset = leg.Foot.CurrentPosition - hipWorldPos;
+        offset.Z = Scalar();
+        return offset.Length() > stepThreshold;
+    }
+    
+    // With every foot down, hand the turn to a group with a leg that wants
+    // to step, preferring any group other than the one that just stepped
+    void StartGroupTurn(Scalar stepThreshold)
+    {
+        int nextGroup = ActiveGroup;
+        bool bAnyWants = false;
+        for (const auto& leg : Legs)
+        {
+            if (leg.bIsMoving)
+                return;
+            if (WantsStep(leg, stepThreshold) && (!bAnyWants || nextGroup == ActiveGroup))
+            {
+                nextGroup = leg.Group;
+                bAnyWants = true;
+            }
+        }
+        
+        if (bAnyWants)
+        {
+            ActiveGroup = nextGroup;
+            GroupTurn++;
+        }
+    }
+    
+    // Legs of a single group step freely; otherwise only the active group
+    // lifts, once per leg per turn
+    bool CanLift(const LegType& leg) const
+    {
+        if (!bMultipleGroups)
+            return true;
+        return leg.Group == ActiveGroup && leg.LastTurn != GroupTurn;
+    }
+    
+    // Landing spot for a foot planted 'plantTime' seconds from now: half a
+    // stance ahead of where the hip will be at that moment, so the body
+    // passes over the foot during the following support phase
+    Vector PredictLanding(const LegType& leg, Scalar plantTime) const
+    {
+        Vector bodyAtPlant = Trajectory.PredictPosition(plantTime);
+        Vector velocityAtPlant = Trajectory.PredictVelocity(plantTime);
+        
+        Vector landing = bodyAtPlant + HipWorldOffset(leg) + PelvisOffset
+                       + velocityAtPlant * (StrideDuration * Num(0.5f));
+        landing.Z = leg.Foot.CurrentPosition.Z;
+        return landing;
+    }
+    
     // Update individual leg movement
-    void UpdateLegMovement(Leg& leg, float deltaTime)
+    void UpdateLegMovement(LegType& leg, Scalar deltaTime)
     {
         if (leg.bIsMoving)
         {
             leg.Foot.TimeSinceLift += deltaTime;
             leg.Foot.Phase = leg.Foot.TimeSinceLift / StrideDuration;
             
-            if (leg.Foot.Phase >= 1.0f)
+            if (leg.Foot.Phase >= Math::FromInt(1))
             {
                 // Foot planting
                 leg.Foot.CurrentPosition = leg.Foot.TargetPosition;
                 leg.Foot.bIsPlanted = true;
                 leg.bIsMoving = false;
-                leg.Foot.Phase = 0.0f;
+                leg.Foot.Phase = Scalar();
             }
             else
             {
                 // Swing phase - calculate parabolic path
-                FVector3 startPos = leg.Foot.PreviousPosition;
-                FVector3 endPos = leg.Foot.TargetPosition;
+                Vector startPos = leg.Foot.PreviousPosition;
+                Vector endPos = leg.Foot.TargetPosition;
                 
                 // Calculate lift height based on obstacle height
-                float obstacleHeight = CalculateObstacleHeight(startPos, endPos);
-                float maxLiftHeight = StepHeight * LiftHeightMultiplier + obstacleHeight;
+                Scalar obstacleHeight = CalculateObstacleHeight(startPos, endPos);
+                const ScalarParameters& params = Params();
+                Scalar maxLiftHeight = params.StepHeight * params.LiftHeightMultiplier + obstacleHeight;
                 
                 // Parabolic swing trajectory
-                float t = leg.Foot.Phase;
-                FVector3 linear = startPos + (endPos - startPos) * t;
+                Scalar t = leg.Foot.Phase;
+                Vector linear = startPos + (endPos - startPos) * t;
                 
-                // Sine-based lift curve
-                float lift = std::sin(t * 3.14159f) * maxLiftHeight;
+                // Sine-based lift curve (half a turn over the swing)
+                Scalar lift = Math::SinTurns(t * Num(0.5f)) * maxLiftHeight;
                 
                 // Apply lift
-                leg.Foot.SwingOffset = FVector3(0, 0, lift);
+                leg.Foot.SwingOffset = Vector(Scalar(), Scalar(), lift);
                 leg.Foot.CurrentPosition = linear + leg.Foot.SwingOffset;
             }
         }
@@ -259,27 +795,27 @@ public:
     }
     
     // Calculate height of obstacles between start and end positions
-    float CalculateObstacleHeight(const FVector3& start, const FVector3& end)
+    Scalar CalculateObstacleHeight(const Vector& start, const Vector& end)
     {
         // Sample points along the path
         int samples = 5;
-        float maxHeight = 0.0f;
+        Scalar maxHeight{};
         
         for (int i = 1; i < samples - 1; i++)
         {
-            float t = float(i) / float(samples);
-            FVector3 samplePoint = start + (end - start) * t;
+            Scalar t = Math::FromInt(i) / Math::FromInt(samples);
+            Vector samplePoint = start + (end - start) * t;
             
             // Get terrain height at sample point
-            float terrainHeight = TerrainQuery->GetSurfaceHeight(samplePoint);
-            float lineHeight = start.Z + (end.Z - start.Z) * t;
+            Scalar terrainHeight = QuerySurfaceHeight(samplePoint);
+            Scalar lineHeight = start.Z + (end.Z - start.Z) * t;
             
-            float obstacle = terrainHeight - lineHeight;
+            Scalar obstacle = terrainHeight - lineHeight;
             if (obstacle > maxHeight)
                 maxHeight = obstacle;
         }
         
-        return std::max(0.0f, maxHeight - StepHeight * 0.5f);
+        return std::max(Scalar(), maxHeight - Params().StepHeight * Num(0.5f));
     }
     
     // Adjust pelvis based on foot positions for balance
@@ -288,7 +824,7 @@ public:
         if (Legs.empty()) return;
         
         // Calculate average foot height
-        float totalHeight = 0.0f;
+        Scalar totalHeight{};
         int plantedCount = 0;
         
         for (const auto& leg : Legs)
@@ -302,19 +838,19 @@ public:
         
         if (plantedCount > 0)
         {
-            float averageHeight = totalHeight / plantedCount;
-            float targetPelvisZ = averageHeight + CharacterHeight * 0.5f;
+            Scalar averageHeight = totalHeight / Math::FromInt(plantedCount);
+            Scalar targetPelvisZ = averageHeight + CharacterHeight * Num(0.5f);
             
             // Smoothly adjust pelvis height
-            float currentPelvisZ = PelvisOffset.Z;
-            float deltaZ = targetPelvisZ - currentPelvisZ;
+            Scalar currentPelvisZ = PelvisOffset.Z;
+            Scalar deltaZ = targetPelvisZ - currentPelvisZ;
             
             // Apply with smoothing
-            PelvisOffset.Z += deltaZ * 0.1f; // Smoothing factor
+            PelvisOffset.Z += deltaZ * Num(0.1f); // Smoothing factor
         }
         
         // Lateral balance (side-to-side)
-        FVector3 balanceOffset = FVector3(0, 0, 0);
+        Vector balanceOffset = Vector();
         
         // Simplified balance calculation
         // In full implementation, would calculate center of mass vs support polygon
@@ -328,9 +864,9 @@ public:
             if (leg.Foot.bIsPlanted)
             {
                 // Sample terrain under foot
-                FVector3 footPos = leg.Foot.CurrentPosition;
-                float terrainHeight = TerrainQuery->GetSurfaceHeight(footPos);
-                FVector3 surfaceNormal = TerrainQuery->GetSurfaceNormal(footPos);
+                Vector footPos = leg.Foot.CurrentPosition;
+                Scalar terrainHeight = QuerySurfaceHeight(footPos);
+                Vector surfaceNormal = QuerySurfaceNormal(footPos);
                 
                 // Adjust foot position to terrain
                 footPos.Z = terrainHeight;
@@ -343,44 +879,128 @@ public:
         }
     }
     
+    // Place the character without walking there (spawn, respawn, teleport)
+    void Teleport(const Vector& position)
+    {
+        CharacterPosition = position;
+        CharacterVelocity = Vector();
+        CharacterAcceleration = Vector();
+        Trajectory.Reset(position);
+        InitializeLegs();
+    }
+    
     // Getters for animation system
-    const std::vector<Leg>& GetLegs() const { return Legs; }
-    const FVector3& GetPelvisOffset() const { return PelvisOffset; }
-    float GetStrideDuration() const { return StrideDuration; }
+    const std::vector<LegType>& GetLegs() const { return Legs; }
+    const Vector& GetPosition() const { return CharacterPosition; }
+    const Vector& GetVelocity() const { return CharacterVelocity; }
+    const Vector& GetPelvisOffset() const { return PelvisOffset; }
+    Scalar GetStrideDuration() const { return StrideDuration; }
+    const Vector& GetAcceleration() const { return CharacterAcceleration; }
+    int GetStepCount() const { return StepCount; }
+    int GetReplanCount() const { return ReplanCount; }
+    
+    // Intended path from AI/navigation; feet are planned along it instead
+    // of extrapolating the velocity history
+    void SetIntendedPath(const std::vector<Vector>& waypoints, Scalar speed) {
+        Trajectory.SetIntendedPath(waypoints, speed);
+    }
+    void ClearIntendedPath() { Trajectory.ClearIntendedPath(); }
     
-    // Setters for runtime customization
-    void SetMoveSpeed(float speed) { MoveSpeed = speed; }
-    void SetStrideLengthMultiplier(float multiplier) { 
-        StrideLengthMultiplier = std::max(0.1f, std::min(multiplier, 3.0f));
+    // Parameters in effect for this instance
+    const WalkParameters& GetParameters() const {
+        return ParameterOverride ? *ParameterOverride : ParameterSet->Acquire();
     }
-    void SetLiftHeightMultiplier(float multiplier) { 
-        LiftHeightMultiplier = std::max(0.1f, std::min(multiplier, 3.0f));
+    
+    // Share an archetype's parameters; later publishes to the set are
+    // picked up on the next update. Drops any per-instance override.
+    void SetParameterSet(const WalkParameterSet* set) {
+        ParameterSet = set ? set : &WalkParameterSet::Default();
+        ParameterOverride.reset();
+        CachedSet = nullptr;
     }
+    const WalkParameterSet* GetParameterSet() const { return ParameterSet; }
+    bool HasParameterOverride() const { return ParameterOverride != nullptr; }
     
+    // Setters for runtime customization (give this instance its own copy
+    // of the parameters, detached from its archetype set)
+    void SetMoveSpeed(float speed) { MutableParameters().MoveSpeed = speed; }
+    void SetStrideLengthMultiplier(float multiplier) {
+        MutableParameters().StrideLengthMultiplier = std::max(0.1f, std::min(multiplier, 3.0f));
+    }
+    void SetLiftHeightMultiplier(float multiplier) {
+        MutableParameters().LiftHeightMultiplier = std::max(0.1f, std::min(multiplier, 3.0f));
+    }
+
+private:
+    WalkParameters& MutableParameters() {
+        if (!ParameterOverride)
+            ParameterOverride.reset(new WalkParameters(ParameterSet->Acquire()));
+        CachedOverride = false;
+        return *ParameterOverride;
+    }
+    
+    // Current parameters in scalar form
+    const ScalarParameters& Params() const
+    {
+        if (ParameterOverride)
+        {
+            if (!CachedOverride)
+            {
+                ConvertParameters(*ParameterOverride);
+                CachedOverride = true;
+            }
+            return CachedParams;
+        }
+        
+        // The generation is read before the values: seeing a new
+        // generation guarantees seeing the values published with it
+        unsigned generation = ParameterSet->GetGeneration();
+        if (CachedOverride || CachedSet != ParameterSet || CachedGeneration != generation)
+        {
+            ConvertParameters(ParameterSet->Acquire());
+            CachedSet = ParameterSet;
+            CachedGeneration = generation;
+            CachedOverride = false;
+        }
+        return CachedParams;
+    }
+    
+    void ConvertParameters(const WalkParameters& values) const
+    {
+        CachedParams.MoveSpeed = Math::FromFloat(values.MoveSpeed);
+        CachedParams.StrideLengthMultiplier = Math::FromFloat(values.StrideLengthMultiplier);
+        CachedParams.LiftHeightMultiplier = Math::FromFloat(values.LiftHeightMultiplier);
+        CachedParams.StepHeight = Math::FromFloat(values.StepHeight);
+        CachedParams.BalanceThreshold = Math::FromFloat(values.BalanceThreshold);
+        CachedParams.ReplanTolerance = Math::FromFloat(values.ReplanTolerance);
+    }
+
+public:
+
     // Query foot placement for AI/navigation
-    bool GetSafeFootPosition(FVector3& outPosition, const FVector3& desiredPosition)
+    bool GetSafeFootPosition(Vector& outPosition, const Vector& desiredPosition)
     {
         // Raycast/query for safe placement
-        if (!TerrainQuery->IsWalkable(desiredPosition))
+        if (!QueryWalkable(desiredPosition))
         {
             // Search nearby positions
-            const float searchRadius = 50.0f;
+            const Scalar searchRadius = Num(50.0f);
             const int searchSteps = 8;
             
             for (int i = 0; i < searchSteps; i++)
             {
-                float angle = (2.0f * 3.14159f * i) / searchSteps;
-                FVector3 offset = FVector3(
-                    std::cos(angle) * searchRadius,
-                    std::sin(angle) * searchRadius,
-                    0
+                Scalar turns = Math::FromInt(i) / Math::FromInt(searchSteps);
+                Vector offset = Vector(
+                    Math::CosTurns(turns) * searchRadius,
+                    Math::SinTurns(turns) * searchRadius,
+                    Scalar()
                 );
                 
-                FVector3 testPos = desiredPosition + offset;
-                if (TerrainQuery->IsWalkable(testPos))
+                Vector testPos = desiredPosition + offset;
+                if (QueryWalkable(testPos))
                 {
                     outPosition = testPos;
-                    outPosition.Z = TerrainQuery->GetSurfaceHeight(testPos);
+                    outPosition.Z = QuerySurfaceHeight(testPos);
                     return true;
                 }
             }
@@ -388,11 +1008,26 @@ public:
         }
         
         outPosition = desiredPosition;
-        outPosition.Z = TerrainQuery->GetSurfaceHeight(desiredPosition);
+        outPosition.Z = QuerySurfaceHeight(desiredPosition);
         return true;
     }
 };
 
+// Float build (original API)
+using FVector3 = TVector3<FloatMath>;
+using FootData = TFootData<FloatMath>;
+using Leg = TLeg<FloatMath>;
+using ITerrainQuery = TTerrainQuery<FloatMath>;
+using TrajectoryPredictor = TTrajectoryPredictor<FloatMath>;
+using ProceduralWalkSystem = TProceduralWalkSystem<FloatMath>;
+
+// 16.16 build for the AvP engine; positions and times are ONE_FIXED
+// values (Fixed16::Raw()), results are identical on every compiler
+using FixedVector3 = TVector3<FixedMath>;
+using FixedLeg = TLeg<FixedMath>;
+using FixedTerrainQuery = TTerrainQuery<FixedMath>;
+using FixedWalkSystem = TProceduralWalkSystem<FixedMath>;
+
 // Example terrain query implementation
 class SimpleTerrainQuery : public ITerrainQuery
 {
@@ -419,7 +1054,9 @@ public:
     }
 };
 
-// Usage example
+// Usage example (define PROCEDURAL_WALK_NO_EXAMPLE when including this
+// file from another program, e.g. procedural_walk_stress.cpp)
+#ifndef PROCEDURAL_WALK_NO_EXAMPLE
 int main()
 {
     // Create terrain query
@@ -455,6 +1092,7 @@ int main()
     
     return 0;
 }
+#endif
 
 // Key Components of This Implementation:
 //     Adaptive Foot Placement:
@@ -0,0 +1,236 @@
+#pragma once
+
+// ================================================================
+// Numeric policies for the procedural walk core
+//
+// TProceduralWalkSystem<Math> is written against one of these:
+//
+//   FloatMath  - plain float, the original behaviour
+//   FixedMath  - 16.16 fixed point in AvP's ONE_FIXED units
+//
+// FixedMath only uses integer arithmetic, so a given input stream
+// produces bit-identical output on every compiler and CPU. Multiply and
+// divide follow the engine's MUL_FIXED / DIV_FIXED (64-bit intermediate,
+// arithmetic shift), and SinTurns/CosTurns read a 4096-entry table with
+// the same layout and amplitude as the engine's GetSin/GetCos. When this
+// file is built inside AvP, define PWS_USE_ENGINE_SINE to read the
+// engine's own table instead of the built-in copy.
+//
+// Angles are given in turns (1.0 = full circle) so both policies share
+// the same call sites; for FixedMath that is 65536 raw units per turn,
+// i.e. a 16-bit engine angle shifted left by 4.
+// ================================================================
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#ifdef PWS_USE_ENGINE_SINE
+extern "C" int GetSin(int a);
+extern "C" int GetCos(int a);
+#endif
+
+// Plain float arithmetic
+struct FloatMath
+{
+    using Scalar = float;
+
+    static constexpr Scalar FromFloat(float value) { return value; }
+    static constexpr Scalar FromInt(int value) { return float(value); }
+    static constexpr float ToFloat(Scalar value) { return value; }
+
+    // Smallest value treated as non-zero by divisions
+    static constexpr Scalar Tiny() { return 1e-6f; }
+
+    static Scalar Sqrt(Scalar value) { return std::sqrt(value); }
+    static Scalar Length3(Scalar x, Scalar y, Scalar z) { return std::sqrt(x * x + y * y + z * z); }
+
+    static Scalar SinTurns(Scalar turns) { return std::sin(turns * 6.28318531f); }
+    static Scalar CosTurns(Scalar turns) { return std::cos(turns * 6.28318531f); }
+};
+
+// 16.16 fixed point value; Raw() is directly usable as an engine ONE_FIXED int
+class Fixed16
+{
+    int32_t Value = 0;
+
+    static constexpr int32_t Wrap(int64_t value) { return int32_t(uint32_t(uint64_t(value))); }
+
+    static constexpr int32_t Saturate(int64_t value)
+    {
+        return value > INT32_MAX ? INT32_MAX : (value < INT32_MIN ? INT32_MIN : int32_t(value));
+    }
+
+public:
+    static constexpr int32_t One = 65536;   // ONE_FIXED
+
+    constexpr Fixed16() = default;
+
+    static constexpr Fixed16 FromRaw(int32_t raw)
+    {
+        Fixed16 f;
+        f.Value = raw;
+        return f;
+    }
+
+    static constexpr Fixed16 FromInt(int value) { return FromRaw(Wrap(int64_t(value) * One)); }
+
+    // Meant for constants; the scale is a power of two so the product is
+    // exact and rounding is the only step that depends on the input
+    static constexpr Fixed16 FromFloat(float value)
+    {
+        return FromRaw(int32_t(value * float(One) + (value >= 0.0f ? 0.5f : -0.5f)));
+    }
+
+    constexpr int32_t Raw() const { return Value; }
+    constexpr float ToFloat() const { return float(Value) / float(One); }
+
+    // Addition wraps like the engine's int arithmetic instead of being
+    // undefined on overflow
+    constexpr Fixed16 operator+(Fixed16 other) const { return FromRaw(Wrap(int64_t(Value) + other.Value)); }
+    constexpr Fixed16 operator-(Fixed16 other) const { return FromRaw(Wrap(int64_t(Value) - other.Value)); }
+    constexpr Fixed16 operator-() const { return FromRaw(Wrap(-int64_t(Value))); }
+
+    // MUL_FIXED: 64-bit product, arithmetic shift (rounds towards -inf)
+    constexpr Fixed16 operator*(Fixed16 other) const
+    {
+        return FromRaw(Wrap((int64_t(Value) * other.Value) >> 16));
+    }
+
+    // DIV_FIXED; division by zero saturates instead of trapping
+    constexpr Fixed16 operator/(Fixed16 other) const
+    {
+        return other.Value == 0
+            ? FromRaw(Value >= 0 ? INT32_MAX : INT32_MIN)
+            : FromRaw(Saturate((int64_t(Value) * One) / other.Value));
+    }
+
+    Fixed16& operator+=(Fixed16 other) { return *this = *this + other; }
+    Fixed16& operator-=(Fixed16 other) { return *this = *this - other; }
+    Fixed16& operator*=(Fixed16 other) { return *this = *this * other; }
+    Fixed16& operator/=(Fixed16 other) { return *this = *this / other; }
+
+    constexpr bool operator<(Fixed16 other) const { return Value < other.Value; }
+    constexpr bool operator>(Fixed16 other) const { return Value > other.Value; }
+    constexpr bool operator<=(Fixed16 other) const { return Value <= other.Value; }
+    constexpr bool operator>=(Fixed16 other) const { return Value >= other.Value; }
+    constexpr bool operator==(Fixed16 other) const { return Value == other.Value; }
+    constexpr bool operator!=(Fixed16 other) const { return Value != other.Value; }
+};
+
+namespace FixedTables
+{
+    static const int SineSize = 4096;             // Entries per full turn, as in the engine
+    static const int SineMask = SineSize - 1;
+
+    // Integer square root, rounded down
+    constexpr uint64_t ISqrt(uint64_t value)
+    {
+        uint64_t result = 0;
+        uint64_t bit = uint64_t(1) << 62;
+        while (bit > value)
+            bit >>= 2;
+        while (bit != 0)
+        {
+            if (value >= result + bit)
+            {
+                value -= result + bit;
+                result = (result >> 1) + bit;
+            }
+            else
+            {
+                result >>= 1;
+            }
+            bit >>= 2;
+        }
+        return result;
+    }
+
+    // sin(2*pi*index/4096) * ONE_FIXED for the first quadrant, evaluated
+    // as a Taylor series in 2.30 fixed point so no float is involved
+    constexpr int32_t QuarterSine(int index)
+    {
+        const int64_t HalfPi = 1686629713;       // pi/2 in 2.30
+        int64_t x = HalfPi * index / (SineSize / 4);
+        int64_t x2 = (x * x) >> 30;
+
+        int64_t term = x;
+        int64_t sum = x;
+        for (int k = 1; k <= 8; k++)
+        {
+            term = -((term * x2) >> 30) / ((2 * k) * (2 * k + 1));
+            sum += term;
+        }
+        return int32_t((sum + (1 << 13)) >> 14);
+    }
+
+    constexpr std::array<int32_t, SineSize> BuildSine()
+    {
+        std::array<int32_t, SineSize> table{};
+        const int quarter = SineSize / 4;
+        for (int i = 0; i <= quarter; i++)
+        {
+            int32_t s = QuarterSine(i);
+            table[i] = s;
+            table[(2 * quarter - i) & SineMask] = s;
+            table[(2 * quarter + i) & SineMask] = -s;
+            table[(4 * quarter - i) & SineMask] = -s;
+        }
+        return table;
+    }
+
+    // Built at compile time
+    static constexpr std::array<int32_t, SineSize> Sine = BuildSine();
+
+    inline int32_t Sin(int index)
+    {
+#ifdef PWS_USE_ENGINE_SINE
+        return GetSin(index & SineMask);
+#else
+        return Sine[index & SineMask];
+#endif
+    }
+
+    inline int32_t Cos(int index)
+    {
+#ifdef PWS_USE_ENGINE_SINE
+        return GetCos(index & SineMask);
+#else
+        return Sine[(index + SineSize / 4) & SineMask];
+#endif
+    }
+}
+
+// 16.16 fixed point arithmetic
+struct FixedMath
+{
+    using Scalar = Fixed16;
+
+    static constexpr Scalar FromFloat(float value) { return Fixed16::FromFloat(value); }
+    static constexpr Scalar FromInt(int value) { return Fixed16::FromInt(value); }
+    static constexpr float ToFloat(Scalar value) { return value.ToFloat(); }
+
+    static constexpr Scalar Tiny() { return Fixed16::FromRaw(1); }
+
+    static Scalar Sqrt(Scalar value)
+    {
+        if (value.Raw() <= 0)
+            return Scalar();
+        return Fixed16::FromRaw(int32_t(FixedTables::ISqrt(uint64_t(value.Raw()) << 16)));
+    }
+
+    // Squares are summed in 64 bits, so vectors up to the full 16.16
+    // range do not overflow
+    static Scalar Length3(Scalar x, Scalar y, Scalar z)
+    {
+        uint64_t sum = uint64_t(int64_t(x.Raw()) * x.Raw())
+                     + uint64_t(int64_t(y.Raw()) * y.Raw())
+                     + uint64_t(int64_t(z.Raw()) * z.Raw());
+        uint64_t length = FixedTables::ISqrt(sum);
+        return Fixed16::FromRaw(length > uint64_t(INT32_MAX) ? INT32_MAX : int32_t(length));
+    }
+
+    // 65536 raw units per turn -> 4096 table entries per turn
+    static Scalar SinTurns(Scalar turns) { return Fixed16::FromRaw(FixedTables::Sin(turns.Raw() >> 4)); }
+    static Scalar CosTurns(Scalar turns) { return Fixed16::FromRaw(FixedTables::Cos(turns.Raw() >> 4)); }
+};
@@ -0,0 +1,275 @@
+#pragma once
+
+// ================================================================
+// Named walk parameter sets shared by many ProceduralWalkSystem instances
+//
+// Each archetype (e.g. "marine", "alien") is a WalkParameterSet with a
+// stable address. Characters point at a set and read its current
+// immutable WalkParameters through an atomic pointer. Publishing new
+// values is a single pointer swap (RCU style): readers never lock, and
+// the old version is retired until ReclaimRetired() is called at a point
+// where no walk update is running (e.g. between frames).
+//
+// Parameter files are plain text:
+//
+//   # comment
+//   [alien]
+//   move_speed = 220
+//   stride_length = 0.6
+//
+// Unlisted keys keep their defaults. A file with any error is rejected
+// as a whole and the previous values stay published.
+// ================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Tunables for one walk archetype
+struct WalkParameters
+{
+    float MoveSpeed = 150.0f;              // Units per second
+    float StrideLengthMultiplier = 0.5f;
+    float LiftHeightMultiplier = 1.0f;
+    float StepHeight = 15.0f;              // Max step height
+    float BalanceThreshold = 5.0f;         // Balance correction threshold
+    float ReplanTolerance = 10.0f;         // Mid-swing target drift that forces a re-plan
+
+    // Same limits the per-instance setters apply
+    void Clamp()
+    {
+        MoveSpeed = std::max(0.0f, MoveSpeed);
+        StrideLengthMultiplier = std::max(0.1f, std::min(StrideLengthMultiplier, 3.0f));
+        LiftHeightMultiplier = std::max(0.1f, std::min(LiftHeightMultiplier, 3.0f));
+        StepHeight = std::max(0.0f, StepHeight);
+        BalanceThreshold = std::max(0.0f, BalanceThreshold);
+        ReplanTolerance = std::max(0.0f, ReplanTolerance);
+    }
+};
+
+// One named archetype; readers hold a pointer to this and call Acquire()
+class WalkParameterSet
+{
+    friend class WalkParameterLibrary;
+
+    std::string Name;
+    std::atomic<const WalkParameters*> Current{nullptr};
+    std::unique_ptr<const WalkParameters> Owned;
+    std::atomic<unsigned> Generation{0};
+
+public:
+    explicit WalkParameterSet(std::string name, const WalkParameters& initial = WalkParameters())
+        : Name(std::move(name)), Owned(new WalkParameters(initial))
+    {
+        Current.store(Owned.get(), std::memory_order_release);
+    }
+
+    WalkParameterSet(const WalkParameterSet&) = delete;
+    WalkParameterSet& operator=(const WalkParameterSet&) = delete;
+
+    // Current values; valid until the next ReclaimRetired() after a publish
+    const WalkParameters& Acquire() const { return *Current.load(std::memory_order_acquire); }
+
+    const std::string& GetName() const { return Name; }
+    // Bumped after each publish; a reader that observes a new generation
+    // also observes the values published with it
+    unsigned GetGeneration() const { return Generation.load(std::memory_order_acquire); }
+
+    // Built-in defaults used by characters that were never assigned a set
+    static const WalkParameterSet& Default()
+    {
+        static const WalkParameterSet DefaultSet("default");
+        return DefaultSet;
+    }
+};
+
+// Owns the archetypes loaded from a parameter file and hot-reloads it.
+// All members are called from a single (game) thread; only
+// WalkParameterSet::Acquire() is called from walk update threads.
+class WalkParameterLibrary
+{
+    std::unordered_map<std::string, std::unique_ptr<WalkParameterSet>> Sets;
+    std::vector<std::unique_ptr<const WalkParameters>> Retired;
+
+    std::string WatchedPath;
+    std::filesystem::file_time_type WatchedWriteTime{};
+    std::string LastError;
+
+public:
+    // Set by name, or null when the library has no such archetype
+    const WalkParameterSet* Find(const std::string& name) const
+    {
+        auto it = Sets.find(name);
+        return it != Sets.end() ? it->second.get() : nullptr;
+    }
+
+    // Existing set, or a new one holding default values
+    WalkParameterSet& FindOrCreate(const std::string& name)
+    {
+        std::unique_ptr<WalkParameterSet>& slot = Sets[name];
+        if (!slot)
+            slot.reset(new WalkParameterSet(name));
+        return *slot;
+    }
+
+    std::vector<const WalkParameterSet*> GetSets() const
+    {
+        std::vector<const WalkParameterSet*> sets;
+        sets.reserve(Sets.size());
+        for (const auto& entry : Sets)
+            sets.push_back(entry.second.get());
+        return sets;
+    }
+
+    // Make new values visible to every character using 'set' in O(1)
+    void Publish(WalkParameterSet& set, const WalkParameters& values)
+    {
+        WalkParameters clamped = values;
+        clamped.Clamp();
+
+        std::unique_ptr<const WalkParameters> next(new WalkParameters(clamped));
+        set.Current.store(next.get(), std::memory_order_release);
+        set.Generation.fetch_add(1, std::memory_order_release);
+
+        Retired.push_back(std::move(set.Owned));
+        set.Owned = std::move(next);
+    }
+
+    // Free versions replaced by Publish(). Only call when no walk update
+    // is in flight, so no reader can still hold a retired version.
+    void ReclaimRetired() { Retired.clear(); }
+
+    size_t GetRetiredCount() const { return Retired.size(); }
+
+    // Load 'path' and remember it for PollForChanges()
+    bool LoadFromFile(const std::string& path)
+    {
+        WatchedPath = path;
+
+        std::error_code ec;
+        WatchedWriteTime = std::filesystem::last_write_time(path, ec);
+
+        return Reload();
+    }
+
+    // Reload the watched file if it was modified; true when new values
+    // were published
+    bool PollForChanges()
+    {
+        if (WatchedPath.empty())
+            return false;
+
+        std::error_code ec;
+        std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(WatchedPath, ec);
+        if (ec || writeTime == WatchedWriteTime)
+            return false;
+
+        WatchedWriteTime = writeTime;
+        return Reload();
+    }
+
+    const std::string& GetLastError() const { return LastError; }
+
+private:
+    bool Reload()
+    {
+        std::unordered_map<std::string, WalkParameters> parsed;
+        if (!ParseFile(WatchedPath, parsed))
+            return false;
+
+        for (auto& entry : parsed)
+            Publish(FindOrCreate(entry.first), entry.second);
+
+        LastError.clear();
+        return true;
+    }
+
+    static std::string Trim(const std::string& text)
+    {
+        size_t begin = text.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos)
+            return std::string();
+        size_t end = text.find_last_not_of(" \t\r\n");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    static float* FindField(WalkParameters& params, const std::string& key)
+    {
+        if (key == "move_speed")        return &params.MoveSpeed;
+        if (key == "stride_length")     return &params.StrideLengthMultiplier;
+        if (key == "lift_height")       return &params.LiftHeightMultiplier;
+        if (key == "step_height")       return &params.StepHeight;
+        if (key == "balance_threshold") return &params.BalanceThreshold;
+        if (key == "replan_tolerance")  return &params.ReplanTolerance;
+        return nullptr;
+    }
+
+    bool Fail(const std::string& path, int line, const std::string& message)
+    {
+        LastError = path + ":" + std::to_string(line) + ": " + message;
+        return false;
+    }
+
+    bool ParseFile(const std::string& path, std::unordered_map<std::string, WalkParameters>& out)
+    {
+        std::ifstream file(path);
+        if (!file)
+            return Fail(path, 0, "cannot open file");
+
+        WalkParameters* current = nullptr;
+        std::string text;
+        int line = 0;
+
+        while (std::getline(file, text))
+        {
+            line++;
+
+            size_t comment = text.find('#');
+            if (comment != std::string::npos)
+                text.erase(comment);
+            text = Trim(text);
+            if (text.empty())
+                continue;
+
+            if (text.front() == '[')
+            {
+                if (text.back() != ']' || text.size() < 3)
+                    return Fail(path, line, "malformed section header");
+
+                std::string name = Trim(text.substr(1, text.size() - 2));
+                if (out.count(name))
+                    return Fail(path, line, "duplicate set '" + name + "'");
+                current = &out[name];
+                continue;
+            }
+
+            size_t equals = text.find('=');
+            if (equals == std::string::npos)
+                return Fail(path, line, "expected key = value");
+            if (!current)
+                return Fail(path, line, "value outside of a [set] section");
+
+            std::string key = Trim(text.substr(0, equals));
+            std::string value = Trim(text.substr(equals + 1));
+
+            float* field = FindField(*current, key);
+            if (!field)
+                return Fail(path, line, "unknown key '" + key + "'");
+
+            char* end = nullptr;
+            float number = std::strtof(value.c_str(), &end);
+            if (value.empty() || *end != '\0')
+                return Fail(path, line, "invalid number '" + value + "'");
+
+            *field = number;
+        }
+
+        return true;
+    }
+};
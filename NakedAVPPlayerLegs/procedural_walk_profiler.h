@@ -0,0 +1,376 @@
+#pragma once
+
+// ================================================================
+// Per-stage profiling for ProceduralWalkSystem::Update
+//
+// Compile with PROCEDURAL_WALK_PROFILE defined to enable. Without it the
+// PWS_PROFILE_SCOPE macro expands to nothing and no counters exist.
+//
+// Each thread that runs walk updates owns a block of counters that only
+// it writes, so recording needs no locks or atomic read-modify-writes.
+// Blocks are linked into a lock-free list on first use and live for the
+// rest of the program. Terrain queries are recorded as their own stages
+// and their time is also charged to whichever stage issued them, which
+// shows how much of each stage is spent waiting on terrain.
+//
+// Overhead: every scope reads steady_clock twice and Update opens up to
+// nine scopes, so timing every update costs far more than the stages
+// being timed. The stress driver runs 4x to 8x slower with it,
+// depending on the clock source (2.47M down to 319k agent-updates/s on
+// one machine, 1.15M down to 290k on another). Profiled totals are the
+// cost of the code plus the clock reads, not real frame costs; compare
+// stages with each other, not with an unprofiled build.
+//
+// To keep the build close to real speed, define
+// PROCEDURAL_WALK_PROFILE_EVERY=N: only every Nth Update on each thread
+// is timed, with all of its stages, and the others read no clock.
+// Calls and totals then cover the sampled updates only; scale by N for
+// the whole run. With N=16 the stress driver runs within ~10% of an
+// unprofiled build.
+// ================================================================
+
+#include <cstdint>
+#include <cstdio>
+
+enum class WalkProfileStage : int
+{
+    Update,                 // Whole ProceduralWalkSystem::Update
+    StrideDuration,         // CalculateStrideDuration
+    FootPlacement,          // PredictFootPlacement
+    LegMovement,            // UpdateLegMovement (all legs)
+    PelvisBalance,          // UpdatePelvisBalance
+    TerrainAdapt,           // AdaptToTerrain
+    TerrainHeight,          // ITerrainQuery::GetSurfaceHeight
+    TerrainNormal,          // ITerrainQuery::GetSurfaceNormal
+    TerrainWalkable,        // ITerrainQuery::IsWalkable
+    Count
+};
+
+#ifdef PROCEDURAL_WALK_PROFILE
+
+#include <atomic>
+#include <chrono>
+
+#ifndef PROCEDURAL_WALK_PROFILE_EVERY
+#define PROCEDURAL_WALK_PROFILE_EVERY 1
+#endif
+
+namespace WalkProfiler
+{
+    static const int SampleEvery = PROCEDURAL_WALK_PROFILE_EVERY;
+
+    static const int StageCount = int(WalkProfileStage::Count);
+    static const int HistogramBuckets = 24;   // Bucket i holds durations in [2^i, 2^(i+1)) ns
+
+    inline const char* StageName(int stage)
+    {
+        static const char* const Names[StageCount] = {
+            "Update",
+            "CalculateStrideDuration",
+            "PredictFootPlacement",
+            "UpdateLegMovement",
+            "UpdatePelvisBalance",
+            "AdaptToTerrain",
+            "TerrainHeight",
+            "TerrainNormal",
+            "TerrainWalkable",
+        };
+        return (stage >= 0 && stage < StageCount) ? Names[stage] : "Unknown";
+    }
+
+    // Parent stage for hierarchical output (-1 = root)
+    inline int StageParent(int stage)
+    {
+        if (stage == int(WalkProfileStage::Update))
+            return -1;
+        if (stage >= int(WalkProfileStage::TerrainHeight))
+            return -1; // Terrain stages are charged to their caller, listed separately
+        return int(WalkProfileStage::Update);
+    }
+
+    inline bool IsTerrainStage(int stage)
+    {
+        return stage >= int(WalkProfileStage::TerrainHeight) && stage < StageCount;
+    }
+
+    // Counters for one stage; written by the owning thread only, read by
+    // any thread through relaxed atomics
+    struct StageCounters
+    {
+        std::atomic<uint64_t> Calls{0};
+        std::atomic<uint64_t> TotalNs{0};
+        std::atomic<uint64_t> MaxNs{0};
+        std::atomic<uint64_t> TerrainCalls{0};    // Terrain queries issued inside this stage
+        std::atomic<uint64_t> TerrainNs{0};       // Time spent in those queries
+        std::atomic<uint64_t> Histogram[HistogramBuckets];
+
+        StageCounters()
+        {
+            for (auto& bucket : Histogram)
+                bucket.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    struct ThreadCounters
+    {
+        StageCounters Stages[StageCount];
+        std::atomic<uint32_t> Epoch{0};           // Reset generation these counters belong to
+        ThreadCounters* Next = nullptr;
+    };
+
+    // Global registry of per-thread blocks
+    inline std::atomic<ThreadCounters*>& RegistryHead()
+    {
+        static std::atomic<ThreadCounters*> Head{nullptr};
+        return Head;
+    }
+
+    inline std::atomic<uint32_t>& ResetEpoch()
+    {
+        static std::atomic<uint32_t> Epoch{0};
+        return Epoch;
+    }
+
+    inline void Add(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    inline void ClearCounters(ThreadCounters& counters)
+    {
+        for (StageCounters& stage : counters.Stages)
+        {
+            stage.Calls.store(0, std::memory_order_relaxed);
+            stage.TotalNs.store(0, std::memory_order_relaxed);
+            stage.MaxNs.store(0, std::memory_order_relaxed);
+            stage.TerrainCalls.store(0, std::memory_order_relaxed);
+            stage.TerrainNs.store(0, std::memory_order_relaxed);
+            for (auto& bucket : stage.Histogram)
+                bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // This thread's counters, registered on first use. A pending Reset()
+    // is applied here by the owner so the writer stays single-threaded.
+    inline ThreadCounters& LocalCounters()
+    {
+        thread_local ThreadCounters* Local = nullptr;
+        if (!Local)
+        {
+            Local = new ThreadCounters();
+            Local->Epoch.store(ResetEpoch().load(std::memory_order_acquire), std::memory_order_relaxed);
+
+            std::atomic<ThreadCounters*>& head = RegistryHead();
+            Local->Next = head.load(std::memory_order_relaxed);
+            while (!head.compare_exchange_weak(Local->Next, Local,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed))
+            {
+            }
+        }
+
+        uint32_t epoch = ResetEpoch().load(std::memory_order_acquire);
+        if (Local->Epoch.load(std::memory_order_relaxed) != epoch)
+        {
+            ClearCounters(*Local);
+            Local->Epoch.store(epoch, std::memory_order_release);
+        }
+        return *Local;
+    }
+
+    inline int& CurrentStage()
+    {
+        thread_local int Stage = -1;
+        return Stage;
+    }
+
+    // Whether scopes opened on this thread right now are timed. Update
+    // scopes decide for everything inside them; outside an Update every
+    // scope is timed.
+    inline bool& Sampling()
+    {
+        thread_local bool Sample = true;
+        return Sample;
+    }
+
+    inline bool SampleUpdate()
+    {
+        thread_local int Countdown = 0;
+        if (Countdown > 0)
+        {
+            Countdown--;
+            return false;
+        }
+        Countdown = SampleEvery - 1;
+        return true;
+    }
+
+    inline int HistogramBucket(uint64_t ns)
+    {
+        int bucket = 0;
+        while (ns > 1 && bucket < HistogramBuckets - 1)
+        {
+            ns >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    inline void Record(int stage, int parent, uint64_t ns)
+    {
+        ThreadCounters& counters = LocalCounters();
+        StageCounters& s = counters.Stages[stage];
+
+        Add(s.Calls, 1);
+        Add(s.TotalNs, ns);
+        Add(s.Histogram[HistogramBucket(ns)], 1);
+        if (ns > s.MaxNs.load(std::memory_order_relaxed))
+            s.MaxNs.store(ns, std::memory_order_relaxed);
+
+        if (IsTerrainStage(stage) && parent >= 0)
+        {
+            StageCounters& p = counters.Stages[parent];
+            Add(p.TerrainCalls, 1);
+            Add(p.TerrainNs, ns);
+        }
+    }
+
+    // Times the enclosing scope and records it against 'stage', unless
+    // the Update it is in was not sampled
+    class ScopedStage
+    {
+        int Stage;
+        int Parent;
+        bool Timed;
+        bool WasSampling;
+        std::chrono::steady_clock::time_point Start;
+
+    public:
+        explicit ScopedStage(WalkProfileStage stage)
+            : Stage(int(stage)), Parent(CurrentStage()), WasSampling(Sampling())
+        {
+            if (stage == WalkProfileStage::Update)
+                Sampling() = SampleUpdate();
+
+            Timed = Sampling();
+            if (!Timed)
+                return;
+
+            CurrentStage() = Stage;
+            Start = std::chrono::steady_clock::now();
+        }
+
+        ~ScopedStage()
+        {
+            if (Timed)
+            {
+                uint64_t ns = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - Start).count());
+                CurrentStage() = Parent;
+                Record(Stage, Parent, ns);
+            }
+            Sampling() = WasSampling;
+        }
+
+        ScopedStage(const ScopedStage&) = delete;
+        ScopedStage& operator=(const ScopedStage&) = delete;
+    };
+
+    // Totals across all threads
+    struct StageSnapshot
+    {
+        uint64_t Calls = 0;
+        uint64_t TotalNs = 0;
+        uint64_t MaxNs = 0;
+        uint64_t TerrainCalls = 0;
+        uint64_t TerrainNs = 0;
+        uint64_t Histogram[HistogramBuckets] = {};
+    };
+
+    struct Snapshot
+    {
+        StageSnapshot Stages[StageCount];
+        int Threads = 0;
+    };
+
+    inline void Collect(Snapshot& out)
+    {
+        out = Snapshot();
+        uint32_t epoch = ResetEpoch().load(std::memory_order_acquire);
+
+        for (ThreadCounters* t = RegistryHead().load(std::memory_order_acquire); t; t = t->Next)
+        {
+            // Counters from before the last Reset() are not cleared until
+            // their owner records again; leave them out
+            if (t->Epoch.load(std::memory_order_acquire) != epoch)
+                continue;
+
+            out.Threads++;
+            for (int i = 0; i < StageCount; i++)
+            {
+                const StageCounters& s = t->Stages[i];
+                StageSnapshot& o = out.Stages[i];
+                o.Calls += s.Calls.load(std::memory_order_relaxed);
+                o.TotalNs += s.TotalNs.load(std::memory_order_relaxed);
+                o.TerrainCalls += s.TerrainCalls.load(std::memory_order_relaxed);
+                o.TerrainNs += s.TerrainNs.load(std::memory_order_relaxed);
+                uint64_t maxNs = s.MaxNs.load(std::memory_order_relaxed);
+                if (maxNs > o.MaxNs)
+                    o.MaxNs = maxNs;
+                for (int b = 0; b < HistogramBuckets; b++)
+                    o.Histogram[b] += s.Histogram[b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Zero all counters. Each thread clears its own block the next time it
+    // records, so Reset() is safe to call while updates are running.
+    inline void Reset()
+    {
+        ResetEpoch().fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    // Write the collected counters as a JSON object (no trailing newline)
+    inline void DumpJson(FILE* file, const char* indent = "")
+    {
+        Snapshot snapshot;
+        Collect(snapshot);
+
+        std::fprintf(file, "{\n%s  \"threads\": %d,\n%s  \"sample_every\": %d,\n%s  \"stages\": [\n",
+                     indent, snapshot.Threads, indent, SampleEvery, indent);
+
+        for (int i = 0; i < StageCount; i++)
+        {
+            const StageSnapshot& s = snapshot.Stages[i];
+            int parent = StageParent(i);
+
+            std::fprintf(file,
+                "%s    {\"name\": \"%s\", \"parent\": \"%s\", \"calls\": %llu, \"total_ms\": %.4f, "
+                "\"avg_ns\": %.1f, \"max_ns\": %llu, \"terrain_calls\": %llu, \"terrain_ms\": %.4f, "
+                "\"histogram_log2_ns\": [",
+                indent, StageName(i), parent >= 0 ? StageName(parent) : "",
+                (unsigned long long)s.Calls, s.TotalNs / 1e6,
+                s.Calls ? double(s.TotalNs) / double(s.Calls) : 0.0,
+                (unsigned long long)s.MaxNs,
+                (unsigned long long)s.TerrainCalls, s.TerrainNs / 1e6);
+
+            for (int b = 0; b < HistogramBuckets; b++)
+                std::fprintf(file, "%s%llu", b ? ", " : "", (unsigned long long)s.Histogram[b]);
+
+            std::fprintf(file, "]}%s\n", i + 1 < StageCount ? "," : "");
+        }
+
+        std::fprintf(file, "%s  ]\n%s}", indent, indent);
+    }
+}
+
+#define PWS_PROFILE_CONCAT_(a, b) a##b
+#define PWS_PROFILE_CONCAT(a, b) PWS_PROFILE_CONCAT_(a, b)
+#define PWS_PROFILE_SCOPE(stage) \
+    WalkProfiler::ScopedStage PWS_PROFILE_CONCAT(pwsProfileScope, __LINE__)(stage)
+
+#else
+
+#define PWS_PROFILE_SCOPE(stage) ((void)0)
+
+#endif // PROCEDURAL_WALK_PROFILE
@@ -0,0 +1,662 @@
+// ================================================================
+// File: procedural_walk_stress.cpp
+// Headless crowd stress driver for ProceduralWalkSystem
+//
+// Spawns a crowd on a synthetic or loaded heightfield, steers it with
+// flocking or waypoint behaviour and runs the walk system for a fixed
+// simulated time without a renderer. Results are printed as JSON.
+//
+// Build:
+//   g++ -O2 -std=c++17 procedural_walk_stress.cpp -o procedural_walk_stress
+//
+// Add -DPROCEDURAL_WALK_PROFILE for per-stage timings inside Update(),
+// and -DPROCEDURAL_WALK_PROFILE_EVERY=N to time only every Nth update
+// (see procedural_walk_profiler.h for what timing every update costs).
+//
+// Usage:
+//   procedural_walk_stress [--agents N] [--seconds S] [--hz H]
+//                          [--behaviour flock|waypoint|stophold] [--seed N]
+//                          [--world SIZE] [--heightfield FILE]
+//                          [--params FILE]
+//
+// With --params, agents are assigned round-robin to the parameter sets in
+// the file (see walk_params.txt) and share them instead of per-agent
+// values; the file is polled for changes once per simulated second.
+//
+// The stophold behaviour steers like waypoint for the first half of the
+// run, then brakes every agent to a stop and holds it there; the report
+// then gives the furthest any foot target got from its resting body.
+//
+// Heightfield files are plain text: "width depth cellSize" followed by
+// width*depth heights in row-major order.
+// ================================================================
+
+#define PROCEDURAL_WALK_NO_EXAMPLE
+#include "procedural_footsystem.cpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+
+// ================================================================
+// Heightfield terrain with query counters
+// ================================================================
+class HeightfieldTerrain : public ITerrainQuery
+{
+public:
+    // Query counters (driver is single-threaded)
+    mutable uint64_t HeightQueries = 0;
+    mutable uint64_t NormalQueries = 0;
+    mutable uint64_t WalkableQueries = 0;
+
+    float MaxWalkableSlope = 0.7f;   // Minimum normal.Z for a walkable cell
+
+private:
+    int Width = 0;
+    int Depth = 0;
+    float CellSize = 1.0f;
+    std::vector<float> Heights;
+
+public:
+    // Rolling hills with a few terraces so feet meet steps and slopes
+    void GenerateSynthetic(float worldSize, float cellSize, uint32_t seed)
+    {
+        CellSize = cellSize;
+        Width = Depth = std::max(2, int(worldSize / cellSize) + 1);
+        Heights.assign(size_t(Width) * Depth, 0.0f);
+
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> phase(0.0f, 6.2831853f);
+        float p0 = phase(rng), p1 = phase(rng), p2 = phase(rng);
+
+        for (int z = 0; z < Depth; z++)
+        {
+            for (int x = 0; x < Width; x++)
+            {
+                float wx = x * CellSize;
+                float wz = z * CellSize;
+                float h = 40.0f * std::sin(wx * 0.002f + p0) * std::cos(wz * 0.0015f + p1)
+                        + 10.0f * std::sin((wx + wz) * 0.01f + p2);
+
+                // Quantise some bands into 15 unit steps
+                if (int(wx / 500.0f) % 3 == 0)
+                    h = std::floor(h / 15.0f) * 15.0f;
+
+                Heights[size_t(z) * Width + x] = h;
+            }
+        }
+    }
+
+    bool Load(const char* path)
+    {
+        std::ifstream file(path);
+        if (!file)
+            return false;
+
+        file >> Width >> Depth >> CellSize;
+        if (!file || Width < 2 || Depth < 2 || CellSize <= 0.0f)
+            return false;
+
+        Heights.resize(size_t(Width) * Depth);
+        for (float& h : Heights)
+        {
+            if (!(file >> h))
+                return false;
+        }
+        return true;
+    }
+
+    float GetExtentX() const { return (Width - 1) * CellSize; }
+    float GetExtentY() const { return (Depth - 1) * CellSize; }
+    size_t GetMemoryBytes() const { return Heights.capacity() * sizeof(float); }
+
+    FVector3 GetSurfaceNormal(const FVector3& position) const override
+    {
+        NormalQueries++;
+
+        float hx0 = Sample(position.X - CellSize, position.Y);
+        float hx1 = Sample(position.X + CellSize, position.Y);
+        float hy0 = Sample(position.X, position.Y - CellSize);
+        float hy1 = Sample(position.X, position.Y + CellSize);
+
+        return FVector3(hx0 - hx1, hy0 - hy1, 2.0f * CellSize).Normalized();
+    }
+
+    float GetSurfaceHeight(const FVector3& position) const override
+    {
+        HeightQueries++;
+        return Sample(position.X, position.Y);
+    }
+
+    bool IsWalkable(const FVector3& position) const override
+    {
+        WalkableQueries++;
+
+        float hx0 = Sample(position.X - CellSize, position.Y);
+        float hx1 = Sample(position.X + CellSize, position.Y);
+        float hy0 = Sample(position.X, position.Y - CellSize);
+        float hy1 = Sample(position.X, position.Y + CellSize);
+
+        FVector3 normal = FVector3(hx0 - hx1, hy0 - hy1, 2.0f * CellSize).Normalized();
+        return normal.Z >= MaxWalkableSlope;
+    }
+
+private:
+    // Bilinear height lookup; the walk system's Z is up, the grid spans X/Y
+    float Sample(float x, float y) const
+    {
+        float fx = std::max(0.0f, std::min(x / CellSize, float(Width - 1)));
+        float fy = std::max(0.0f, std::min(y / CellSize, float(Depth - 1)));
+
+        int x0 = std::min(int(fx), Width - 2);
+        int y0 = std::min(int(fy), Depth - 2);
+        float tx = fx - x0;
+        float ty = fy - y0;
+
+        const float* row0 = &Heights[size_t(y0) * Width];
+        const float* row1 = row0 + Width;
+
+        float h0 = row0[x0] + (row0[x0 + 1] - row0[x0]) * tx;
+        float h1 = row1[x0] + (row1[x0 + 1] - row1[x0]) * tx;
+        return h0 + (h1 - h0) * ty;
+    }
+};
+
+// ================================================================
+// Crowd agents and steering
+// ================================================================
+struct Agent
+{
+    ProceduralWalkSystem Walk;
+    FVector3 Velocity;
+    FVector3 Waypoint;
+    float Speed;
+
+    Agent(std::shared_ptr<ITerrainQuery> terrain) : Walk(terrain), Speed(0.0f) {}
+};
+
+struct StressOptions
+{
+    int AgentCount = 10000;
+    float Seconds = 10.0f;
+    float UpdateHz = 60.0f;
+    bool Flocking = true;
+    bool StopAndHold = false;
+    uint32_t Seed = 1234;
+    float WorldSize = 20000.0f;
+    const char* HeightfieldPath = nullptr;
+    const char* ParamsPath = nullptr;
+};
+
+// Uniform grid of agent indices used for flocking neighbour queries
+class AgentGrid
+{
+    float CellSize;
+    int CellsX, CellsY;
+    std::vector<int> CellStart;
+    std::vector<int> Entries;
+
+public:
+    AgentGrid(float worldX, float worldY, float cellSize)
+        : CellSize(cellSize),
+          CellsX(std::max(1, int(worldX / cellSize) + 1)),
+          CellsY(std::max(1, int(worldY / cellSize) + 1))
+    {
+    }
+
+    int CellOf(const FVector3& p) const
+    {
+        int cx = std::max(0, std::min(int(p.X / CellSize), CellsX - 1));
+        int cy = std::max(0, std::min(int(p.Y / CellSize), CellsY - 1));
+        return cy * CellsX + cx;
+    }
+
+    // Counting sort of agents into cells
+    void Build(const std::vector<Agent>& agents)
+    {
+        CellStart.assign(size_t(CellsX) * CellsY + 1, 0);
+        Entries.resize(agents.size());
+
+        for (const Agent& a : agents)
+            CellStart[CellOf(a.Walk.GetPosition()) + 1]++;
+        for (size_t c = 1; c < CellStart.size(); c++)
+            CellStart[c] += CellStart[c - 1];
+
+        std::vector<int> fill(CellStart.begin(), CellStart.end() - 1);
+        for (size_t i = 0; i < agents.size(); i++)
+            Entries[fill[CellOf(agents[i].Walk.GetPosition())]++] = int(i);
+    }
+
+    template <typename Fn>
+    void ForNeighbours(const FVector3& p, Fn&& fn) const
+    {
+        int cx = std::max(0, std::min(int(p.X / CellSize), CellsX - 1));
+        int cy = std::max(0, std::min(int(p.Y / CellSize), CellsY - 1));
+
+        for (int y = std::max(0, cy - 1); y <= std::min(CellsY - 1, cy + 1); y++)
+        {
+            for (int x = std::max(0, cx - 1); x <= std::min(CellsX - 1, cx + 1); x++)
+            {
+                int c = y * CellsX + x;
+                for (int e = CellStart[c]; e < CellStart[c + 1]; e++)
+                    fn(Entries[e]);
+            }
+        }
+    }
+
+    size_t GetMemoryBytes() const
+    {
+        return (CellStart.capacity() + Entries.capacity()) * sizeof(int);
+    }
+};
+
+static FVector3 PlanarClamp(const FVector3& v, float maxLength)
+{
+    FVector3 flat(v.X, v.Y, 0.0f);
+    float length = flat.Length();
+    if (length > maxLength)
+        flat = flat * (maxLength / length);
+    return flat;
+}
+
+static void SteerFlock(std::vector<Agent>& agents, const AgentGrid& grid,
+                       float extentX, float extentY, float dt)
+{
+    const float neighbourRadius = 150.0f;
+    const float separationRadius = 50.0f;
+
+    for (size_t i = 0; i < agents.size(); i++)
+    {
+        Agent& self = agents[i];
+        const FVector3& p = self.Walk.GetPosition();
+
+        FVector3 separation, alignment, cohesion;
+        int neighbours = 0;
+
+        grid.ForNeighbours(p, [&](int j)
+        {
+            if (size_t(j) == i)
+                return;
+
+            FVector3 delta = agents[j].Walk.GetPosition() - p;
+            delta.Z = 0.0f;
+            float distance = delta.Length();
+            if (distance > neighbourRadius)
+                return;
+
+            if (distance < separationRadius && distance > 0.001f)
+                separation = separation - delta * (1.0f / (distance * distance));
+            alignment = alignment + agents[j].Velocity;
+            cohesion = cohesion + delta;
+            neighbours++;
+        });
+
+        FVector3 steer = separation * 4000.0f;
+        if (neighbours > 0)
+        {
+            steer = steer + (alignment * (1.0f / neighbours) - self.Velocity) * 0.5f;
+            steer = steer + cohesion * (0.2f / neighbours);
+        }
+
+        // Turn back from the world edges
+        const float margin = 300.0f;
+        if (p.X < margin) steer.X += self.Speed;
+        if (p.Y < margin) steer.Y += self.Speed;
+        if (p.X > extentX - margin) steer.X -= self.Speed;
+        if (p.Y > extentY - margin) steer.Y -= self.Speed;
+
+        self.Velocity = PlanarClamp(self.Velocity + PlanarClamp(steer, 400.0f) * dt, self.Speed);
+    }
+}
+
+static void SteerWaypoints(std::vector<Agent>& agents, std::mt19937& rng,
+                           float extentX, float extentY, float dt)
+{
+    std::uniform_real_distribution<float> rx(0.0f, extentX);
+    std::uniform_real_distribution<float> ry(0.0f, extentY);
+
+    for (Agent& a : agents)
+    {
+        FVector3 toGoal = a.Waypoint - a.Walk.GetPosition();
+        toGoal.Z = 0.0f;
+
+        if (toGoal.Length() < 50.0f)
+        {
+            a.Waypoint = FVector3(rx(rng), ry(rng), 0.0f);
+            continue;
+        }
+
+        FVector3 desired = toGoal.Normalized() * a.Speed;
+        a.Velocity = PlanarClamp(a.Velocity + PlanarClamp(desired - a.Velocity, 600.0f * dt), a.Speed);
+    }
+}
+
+// Brake hard to a standstill and stay there
+static void SteerStop(std::vector<Agent>& agents, float dt)
+{
+    const float braking = 1500.0f;
+
+    for (Agent& a : agents)
+    {
+        float speed = a.Velocity.Length();
+        a.Velocity = speed > braking * dt ? a.Velocity * (1.0f - braking * dt / speed) : FVector3();
+    }
+}
+
+// Furthest planar distance from a resting body to any of its foot targets
+static float MaxRestingFootOffset(const std::vector<Agent>& agents)
+{
+    float worst = 0.0f;
+    for (const Agent& a : agents)
+    {
+        if (a.Velocity.Length() > 0.0f)
+            continue;
+
+        for (const Leg& leg : a.Walk.GetLegs())
+        {
+            FVector3 offset = leg.Foot.TargetPosition - a.Walk.GetPosition();
+            offset.Z = 0.0f;
+            worst = std::max(worst, offset.Length());
+        }
+    }
+    return worst;
+}
+
+// ================================================================
+// Metrics
+// ================================================================
+static long ReadProcStatusKB(const char* key)
+{
+    FILE* file = std::fopen("/proc/self/status", "r");
+    if (!file)
+        return -1;
+
+    char line[256];
+    long value = -1;
+    size_t keyLength = std::strlen(key);
+    while (std::fgets(line, sizeof(line), file))
+    {
+        if (std::strncmp(line, key, keyLength) == 0 && line[keyLength] == ':')
+        {
+            value = std::strtol(line + keyLength + 1, nullptr, 10);
+            break;
+        }
+    }
+    std::fclose(file);
+    return value;
+}
+
+using StressClock = std::chrono::steady_clock;
+
+static double SecondsSince(StressClock::time_point start)
+{
+    return std::chrono::duration<double>(StressClock::now() - start).count();
+}
+
+// Text as the contents of a JSON string; paths may hold quotes and
+// Windows paths always hold backslashes
+static std::string JsonEscape(const char* text)
+{
+    std::string escaped;
+    for (const char* c = text; *c; c++)
+    {
+        unsigned char ch = (unsigned char)*c;
+        if (ch == '"' || ch == '\\')
+        {
+            escaped += '\\';
+            escaped += char(ch);
+        }
+        else if (ch < 0x20)
+        {
+            char code[8];
+            std::snprintf(code, sizeof(code), "\\u%04x", ch);
+            escaped += code;
+        }
+        else
+        {
+            escaped += char(ch);
+        }
+    }
+    return escaped;
+}
+
+static bool ParseOptions(int argc, char** argv, StressOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (!std::strcmp(arg, "--agents") && value)          { options.AgentCount = std::atoi(value); i++; }
+        else if (!std::strcmp(arg, "--seconds") && value)    { options.Seconds = float(std::atof(value)); i++; }
+        else if (!std::strcmp(arg, "--hz") && value)         { options.UpdateHz = float(std::atof(value)); i++; }
+        else if (!std::strcmp(arg, "--seed") && value)       { options.Seed = uint32_t(std::strtoul(value, nullptr, 10)); i++; }
+        else if (!std::strcmp(arg, "--world") && value)      { options.WorldSize = float(std::atof(value)); i++; }
+        else if (!std::strcmp(arg, "--heightfield") && value) { options.HeightfieldPath = value; i++; }
+        else if (!std::strcmp(arg, "--params") && value)     { options.ParamsPath = value; i++; }
+        else if (!std::strcmp(arg, "--behaviour") && value)
+        {
+            options.StopAndHold = std::strcmp(value, "stophold") == 0;
+            options.Flocking = std::strcmp(value, "waypoint") != 0 && !options.StopAndHold;
+            i++;
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            return false;
+        }
+    }
+
+    return options.AgentCount > 0 && options.Seconds > 0.0f && options.UpdateHz > 0.0f;
+}
+
+int main(int argc, char** argv)
+{
+    StressOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::fprintf(stderr,
+            "usage: %s [--agents N] [--seconds S] [--hz H] [--behaviour flock|waypoint|stophold]\n"
+            "          [--seed N] [--world SIZE] [--heightfield FILE] [--params FILE]\n", argv[0]);
+        return 1;
+    }
+
+    long rssBaselineKB = ReadProcStatusKB("VmRSS");
+
+    // Terrain
+    auto terrain = std::make_shared<HeightfieldTerrain>();
+    if (options.HeightfieldPath)
+    {
+        if (!terrain->Load(options.HeightfieldPath))
+        {
+            std::fprintf(stderr, "Failed to load heightfield: %s\n", options.HeightfieldPath);
+            return 1;
+        }
+    }
+    else
+    {
+        terrain->GenerateSynthetic(options.WorldSize, 25.0f, options.Seed);
+    }
+
+    // Shared parameter sets
+    WalkParameterLibrary library;
+    std::vector<const WalkParameterSet*> parameterSets;
+    if (options.ParamsPath)
+    {
+        if (!library.LoadFromFile(options.ParamsPath))
+        {
+            std::fprintf(stderr, "Failed to load parameters: %s\n", library.GetLastError().c_str());
+            return 1;
+        }
+        parameterSets = library.GetSets();
+    }
+
+    float extentX = terrain->GetExtentX();
+    float extentY = terrain->GetExtentY();
+
+    // Crowd
+    std::mt19937 rng(options.Seed);
+    std::uniform_real_distribution<float> rx(0.0f, extentX);
+    std::uniform_real_distribution<float> ry(0.0f, extentY);
+    std::uniform_real_distribution<float> speed(80.0f, 220.0f);
+    std::uniform_real_distribution<float> heading(0.0f, 6.2831853f);
+
+    StressClock::time_point spawnStart = StressClock::now();
+
+    std::vector<Agent> agents;
+    agents.reserve(size_t(options.AgentCount));
+    for (int i = 0; i < options.AgentCount; i++)
+    {
+        agents.emplace_back(terrain);
+        Agent& a = agents.back();
+
+        FVector3 spawn(rx(rng), ry(rng), 0.0f);
+        spawn.Z = terrain->GetSurfaceHeight(spawn);
+        a.Walk.Teleport(spawn);
+
+        if (!parameterSets.empty())
+        {
+            a.Walk.SetParameterSet(parameterSets[size_t(i) % parameterSets.size()]);
+            a.Speed = a.Walk.GetParameters().MoveSpeed;
+        }
+        else
+        {
+            a.Speed = speed(rng);
+            a.Walk.SetMoveSpeed(a.Speed);
+        }
+
+        float h = heading(rng);
+        a.Velocity = FVector3(std::cos(h), std::sin(h), 0.0f) * a.Speed;
+        a.Waypoint = FVector3(rx(rng), ry(rng), 0.0f);
+    }
+
+    double spawnSeconds = SecondsSince(spawnStart);
+
+    // Simulation
+    const float dt = 1.0f / options.UpdateHz;
+    const int frames = std::max(1, int(options.Seconds * options.UpdateHz + 0.5f));
+
+    const int pollFrames = std::max(1, int(options.UpdateHz + 0.5f));
+    int reloads = 0;
+
+    AgentGrid grid(extentX, extentY, 150.0f);
+    double steerSeconds = 0.0;
+    double walkSeconds = 0.0;
+    double worstFrameSeconds = 0.0;
+    int holdFrames = 0;
+    float holdFootOffset = 0.0f;
+
+    terrain->HeightQueries = terrain->NormalQueries = terrain->WalkableQueries = 0;
+#ifdef PROCEDURAL_WALK_PROFILE
+    WalkProfiler::Reset();
+#endif
+    StressClock::time_point runStart = StressClock::now();
+
+    for (int frame = 0; frame < frames; frame++)
+    {
+        StressClock::time_point frameStart = StressClock::now();
+
+        // Hot-reload between updates, where retired sets can be freed
+        if (options.ParamsPath && frame % pollFrames == 0)
+        {
+            if (library.PollForChanges())
+                reloads++;
+            library.ReclaimRetired();
+        }
+
+        if (options.Flocking)
+        {
+            grid.Build(agents);
+            SteerFlock(agents, grid, extentX, extentY, dt);
+        }
+        else if (options.StopAndHold && frame >= frames / 2)
+        {
+            SteerStop(agents, dt);
+        }
+        else
+        {
+            SteerWaypoints(agents, rng, extentX, extentY, dt);
+        }
+
+        StressClock::time_point walkStart = StressClock::now();
+        steerSeconds += std::chrono::duration<double>(walkStart - frameStart).count();
+
+        for (Agent& a : agents)
+            a.Walk.Update(dt, a.Velocity);
+
+        double walkFrame = SecondsSince(walkStart);
+        walkSeconds += walkFrame;
+        worstFrameSeconds = std::max(worstFrameSeconds, walkFrame);
+
+        if (options.StopAndHold && frame >= frames / 2)
+        {
+            holdFrames++;
+            holdFootOffset = std::max(holdFootOffset, MaxRestingFootOffset(agents));
+        }
+    }
+
+    double runSeconds = SecondsSince(runStart);
+
+    // Gait statistics
+    uint64_t steps = 0;
+    uint64_t replans = 0;
+    size_t legBytes = 0;
+    for (const Agent& a : agents)
+    {
+        steps += uint64_t(a.Walk.GetStepCount());
+        replans += uint64_t(a.Walk.GetReplanCount());
+        legBytes += a.Walk.GetLegs().capacity() * sizeof(Leg);
+    }
+
+    double agentUpdates = double(agents.size()) * frames;
+    uint64_t terrainQueries = terrain->HeightQueries + terrain->NormalQueries + terrain->WalkableQueries;
+
+    std::printf("{\n");
+    std::printf("  \"config\": {\"agents\": %d, \"seconds\": %.3f, \"hz\": %.3f, \"frames\": %d, "
+                "\"behaviour\": \"%s\", \"seed\": %u, \"terrain\": \"%s\", \"extent\": [%.1f, %.1f]},\n",
+                options.AgentCount, options.Seconds, options.UpdateHz, frames,
+                options.Flocking ? "flock" : (options.StopAndHold ? "stophold" : "waypoint"), options.Seed,
+                JsonEscape(options.HeightfieldPath ? options.HeightfieldPath : "synthetic").c_str(), extentX, extentY);
+    std::printf("  \"throughput\": {\"agent_updates\": %.0f, \"agent_updates_per_sec\": %.1f, "
+                "\"realtime_factor\": %.3f},\n",
+                agentUpdates, agentUpdates / std::max(walkSeconds, 1e-9),
+                double(options.Seconds) / std::max(runSeconds, 1e-9));
+    std::printf("  \"timings_ms\": {\"spawn\": %.3f, \"steering\": %.3f, \"walk_update\": %.3f, "
+                "\"walk_update_per_frame\": %.4f, \"walk_update_worst_frame\": %.4f, \"total\": %.3f},\n",
+                spawnSeconds * 1000.0, steerSeconds * 1000.0, walkSeconds * 1000.0,
+                walkSeconds * 1000.0 / frames, worstFrameSeconds * 1000.0, runSeconds * 1000.0);
+    std::printf("  \"terrain_queries\": {\"height\": %llu, \"normal\": %llu, \"walkable\": %llu, "
+                "\"total\": %llu, \"per_agent_update\": %.3f},\n",
+                (unsigned long long)terrain->HeightQueries,
+                (unsigned long long)terrain->NormalQueries,
+                (unsigned long long)terrain->WalkableQueries,
+                (unsigned long long)terrainQueries, double(terrainQueries) / agentUpdates);
+    std::printf("  \"params\": {\"file\": \"%s\", \"sets\": %zu, \"reloads\": %d},\n",
+                JsonEscape(options.ParamsPath ? options.ParamsPath : "").c_str(), parameterSets.size(), reloads);
+    std::printf("  \"gait\": {\"steps\": %llu, \"replans\": %llu, \"steps_per_agent_sec\": %.3f},\n",
+                (unsigned long long)steps, (unsigned long long)replans,
+                double(steps) / (double(agents.size()) * options.Seconds));
+    std::printf("  \"memory\": {\"rss_kb\": %ld, \"peak_rss_kb\": %ld, \"rss_growth_kb\": %ld, "
+                "\"agent_bytes\": %zu, \"leg_bytes\": %zu, \"terrain_bytes\": %zu, \"grid_bytes\": %zu}",
+                ReadProcStatusKB("VmRSS"), ReadProcStatusKB("VmHWM"),
+                ReadProcStatusKB("VmRSS") - rssBaselineKB,
+                agents.capacity() * sizeof(Agent), legBytes,
+                terrain->GetMemoryBytes(), grid.GetMemoryBytes());
+    if (options.StopAndHold)
+        std::printf(",\n  \"hold\": {\"frames\": %d, \"max_foot_offset\": %.3f}", holdFrames, holdFootOffset);
+#ifdef PROCEDURAL_WALK_PROFILE
+    std::printf(",\n  \"profile\": ");
+    WalkProfiler::DumpJson(stdout, "  ");
+    std::printf("\n");
+#else
+    std::printf("\n");
+#endif
+    std::printf("}\n");
+
+    return 0;
+}
@@ -0,0 +1,342 @@
+#include "sithAutoAim.h"
+
+#ifndef SITHAUTOAIM_STANDALONE
+#include "World/sithThing.h"
+#include "World/sithWorld.h"
+#include "Engine/sithCollision.h"
+#include "Gameplay/sithTime.h"
+#include "General/stdMath.h"
+#include "jk.h"
+#endif
+
+typedef struct sithAutoAimEntry
+{
+    sithThing* thing;
+    rdVector3 position;     // Where it was when the grid was built
+    int next;               // Next entry in the bucket, -1 at the end
+    int queryStamp;         // Last query that looked at it
+} sithAutoAimEntry;
+
+typedef struct sithAutoAimLos
+{
+    sithThing* sender;
+    sithThing* target;
+    int senderSignature;
+    int targetSignature;
+    rdVector3 senderPos;
+    rdVector3 targetPos;
+    uint32_t testMs;
+    int hasLos;
+} sithAutoAimLos;
+
+static sithAutoAimEntry sithAutoAim_aEntries[SITHAUTOAIM_MAX_THINGS];
+static int sithAutoAim_numEntries;
+static int sithAutoAim_aBuckets[SITHAUTOAIM_GRID_BUCKETS];
+static int sithAutoAim_bGridValid;
+static uint32_t sithAutoAim_gridMs;
+static flex_t sithAutoAim_cellSize;
+static flex_t sithAutoAim_maxRange;      // Longest query since the world loaded
+static flex_t sithAutoAim_maxRadius;     // Largest collideSize in the grid
+static int sithAutoAim_queryStamp;
+
+// Squared distances of a query's thingList, nearest first
+static flex_t sithAutoAim_aCandidateDist[SITHAUTOAIM_MAX_CANDIDATES];
+
+static sithAutoAimLos sithAutoAim_aLos[SITHAUTOAIM_LOS_ENTRIES];
+
+static int sithAutoAim_Cell(flex_t v)
+{
+    flex_t cell = v / sithAutoAim_cellSize;
+    int i = (int)cell;
+
+    if (cell < (flex_t)i)
+        i--;
+    return i;
+}
+
+static int sithAutoAim_Bucket(int x, int y, int z)
+{
+    uint32_t hash = ((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u) ^ ((uint32_t)z * 83492791u);
+    return hash & (SITHAUTOAIM_GRID_BUCKETS - 1);
+}
+
+// Same thing types sithWeapon_ProjectileAutoAim asked sithAI for
+static int sithAutoAim_IsCandidate(sithThing* thing)
+{
+    if (thing->type != SITH_THING_ACTOR && thing->type != SITH_THING_PLAYER)
+        return 0;
+    if (thing->thingflags & (SITH_TF_DISABLED | SITH_TF_WILLBEREMOVED))
+        return 0;
+    return 1;
+}
+
+static void sithAutoAim_BuildGrid(flex_t cellSize)
+{
+    sithWorld* world = sithWorld_pCurrentWorld;
+    int i;
+
+    sithAutoAim_cellSize = cellSize;
+    sithAutoAim_maxRadius = 0.0;
+    sithAutoAim_numEntries = 0;
+    for (i = 0; i < SITHAUTOAIM_GRID_BUCKETS; i++)
+        sithAutoAim_aBuckets[i] = -1;
+
+    for (i = 0; i < world->numThingsLoaded; i++)
+    {
+        sithThing* thing = &world->things[i];
+        sithAutoAimEntry* entry;
+        int bucket;
+
+        if (!sithAutoAim_IsCandidate(thing))
+            continue;
+
+        // Out of room: the rest can't be auto-aimed at this tick
+        if (sithAutoAim_numEntries == SITHAUTOAIM_MAX_THINGS)
+            break;
+
+        bucket = sithAutoAim_Bucket(sithAutoAim_Cell(thing->position.x), sithAutoAim_Cell(thing->position.y), sithAutoAim_Cell(thing->position.z));
+        entry = &sithAutoAim_aEntries[sithAutoAim_numEntries];
+        entry->thing = thing;
+        rdVector_Copy3(&entry->position, &thing->position);
+        entry->next = sithAutoAim_aBuckets[bucket];
+        entry->queryStamp = 0;
+        sithAutoAim_aBuckets[bucket] = sithAutoAim_numEntries++;
+
+        if (thing->collideSize > sithAutoAim_maxRadius)
+            sithAutoAim_maxRadius = thing->collideSize;
+    }
+
+    sithAutoAim_gridMs = sithTime_curMs;
+    sithAutoAim_bGridValid = 1;
+}
+
+// Within maxDist and at most fov degrees off the view's lvec, measured
+// separately left/right and up/down, widened by the thing's size.
+// *pDistSq gets the squared distance from the apex.
+static int sithAutoAim_InCone(sithAutoAimEntry* entry, rdMatrix34* view, flex_t tanFov, int bWide, flex_t maxDist, flex_t* pDistSq)
+{
+    rdVector3 delta;
+    flex_t forward, side, up, radius;
+
+    rdVector_Sub3(&delta, &entry->position, &view->scale);
+    *pDistSq = rdVector_Dot3(&delta, &delta);
+    if (*pDistSq > maxDist * maxDist)
+        return 0;
+
+    forward = rdVector_Dot3(&delta, &view->lvec);
+    if (bWide)
+        return tanFov < 0.0 || forward > 0.0;
+    if (forward <= 0.0)
+        return 0;
+
+    radius = entry->thing->collideSize;
+    side = rdVector_Dot3(&delta, &view->rvec);
+    up = rdVector_Dot3(&delta, &view->uvec);
+    if (side < 0.0)
+        side = -side;
+    if (up < 0.0)
+        up = -up;
+
+    return side - radius <= forward * tanFov && up - radius <= forward * tanFov;
+}
+
+// thingList stays sorted nearest first. Once it's full, a thing farther
+// than the last one is dropped and a nearer one pushes the last one out,
+// so truncation never depends on bucket order.
+static int sithAutoAim_Insert(sithThing* thing, flex_t distSq, int numThings, int maxThings, sithThing** thingList)
+{
+    int i;
+
+    if (numThings == maxThings)
+    {
+        if (distSq >= sithAutoAim_aCandidateDist[numThings - 1])
+            return numThings;
+        i = numThings - 1;
+    }
+    else
+    {
+        i = numThings++;
+    }
+
+    for (; i > 0 && sithAutoAim_aCandidateDist[i - 1] > distSq; i--)
+    {
+        thingList[i] = thingList[i - 1];
+        sithAutoAim_aCandidateDist[i] = sithAutoAim_aCandidateDist[i - 1];
+    }
+    thingList[i] = thing;
+    sithAutoAim_aCandidateDist[i] = distSq;
+
+    return numThings;
+}
+
+static int sithAutoAim_Visit(int bucket, rdMatrix34* view, flex_t tanFov, int bWide, flex_t maxDist, int numThings, int maxThings, sithThing** thingList)
+{
+    int i;
+
+    for (i = sithAutoAim_aBuckets[bucket]; i >= 0; i = sithAutoAim_aEntries[i].next)
+    {
+        sithAutoAimEntry* entry = &sithAutoAim_aEntries[i];
+        flex_t distSq;
+
+        // Two cells of the query can share a bucket
+        if (entry->queryStamp == sithAutoAim_queryStamp)
+            continue;
+        entry->queryStamp = sithAutoAim_queryStamp;
+
+        if (sithAutoAim_InCone(entry, view, tanFov, bWide, maxDist, &distSq))
+            numThings = sithAutoAim_Insert(entry->thing, distSq, numThings, maxThings, thingList);
+    }
+    return numThings;
+}
+
+// Actors and players in the cone of view (apex view->scale, axis
+// view->lvec), nearest first; past maxThings the farthest are left out.
+// Only the grid cells the cone's bounding box overlaps are visited, so
+// the cost follows the number of things near the cone.
+int sithAutoAim_ThingsInCone(rdMatrix34* view, flex_t fov, flex_t maxDist, int maxThings, sithThing** thingList)
+{
+    rdVector3 boxMin, boxMax;
+    flex_t sinFov, cosFov, tanFov;
+    flex_t cellSize;
+    int bWide;
+    int minCell[3], maxCell[3];
+    int numCells, numThings = 0;
+    int x, y, z;
+
+    if (!sithWorld_pCurrentWorld || maxThings <= 0)
+        return 0;
+    if (maxThings > SITHAUTOAIM_MAX_CANDIDATES)
+        maxThings = SITHAUTOAIM_MAX_CANDIDATES;
+
+    // One grid per tick, its cells sized from the longest range asked for
+    // so far, so the longest cone spans about the same number of cells
+    // however far it reaches. A longer range later in the tick still
+    // uses this tick's grid (it visits more cells) and sizes the next one.
+    if (maxDist > sithAutoAim_maxRange)
+        sithAutoAim_maxRange = maxDist;
+
+    if (!sithAutoAim_bGridValid || sithAutoAim_gridMs != sithTime_curMs)
+    {
+        cellSize = sithAutoAim_maxRange / SITHAUTOAIM_RANGE_CELLS;
+        if (cellSize < SITHAUTOAIM_MIN_CELL_SIZE)
+            cellSize = SITHAUTOAIM_MIN_CELL_SIZE;
+        sithAutoAim_BuildGrid(cellSize);
+    }
+    if (!sithAutoAim_numEntries)
+        return 0;
+
+    if (++sithAutoAim_queryStamp == 0)
+        sithAutoAim_queryStamp = 1;
+
+    // Past ~85 degrees the cone is no tighter than the sphere; a negative
+    // tanFov means everything around the shooter counts
+    stdMath_SinCos(fov, &sinFov, &cosFov);
+    bWide = cosFov <= 0.1;
+    tanFov = bWide ? (cosFov < 0.0 ? -1.0 : 0.0) : sinFov / cosFov;
+
+    if (bWide)
+    {
+        boxMin.x = view->scale.x - maxDist;
+        boxMin.y = view->scale.y - maxDist;
+        boxMin.z = view->scale.z - maxDist;
+        boxMax.x = view->scale.x + maxDist;
+        boxMax.y = view->scale.y + maxDist;
+        boxMax.z = view->scale.z + maxDist;
+    }
+    else
+    {
+        // Apex plus the square that caps the cone at maxDist (InCone
+        // measures left/right and up/down separately). A thing's center
+        // can be off the cone by up to its size, to either side.
+        flex_t capHalf = maxDist * tanFov;
+        flex_t* apex = &view->scale.x;
+        flex_t* axis = &view->lvec.x;
+        flex_t* right = &view->rvec.x;
+        flex_t* up = &view->uvec.x;
+        flex_t* pMin = &boxMin.x;
+        flex_t* pMax = &boxMax.x;
+        int i;
+
+        for (i = 0; i < 3; i++)
+        {
+            flex_t cap = apex[i] + axis[i] * maxDist;
+            flex_t across = (right[i] < 0.0 ? -right[i] : right[i]) + (up[i] < 0.0 ? -up[i] : up[i]);
+            flex_t extent = capHalf * across;
+            flex_t pad = sithAutoAim_maxRadius * across;
+
+            pMin[i] = (apex[i] < cap - extent ? apex[i] : cap - extent) - pad;
+            pMax[i] = (apex[i] > cap + extent ? apex[i] : cap + extent) + pad;
+        }
+    }
+
+    minCell[0] = sithAutoAim_Cell(boxMin.x);
+    minCell[1] = sithAutoAim_Cell(boxMin.y);
+    minCell[2] = sithAutoAim_Cell(boxMin.z);
+    maxCell[0] = sithAutoAim_Cell(boxMax.x);
+    maxCell[1] = sithAutoAim_Cell(boxMax.y);
+    maxCell[2] = sithAutoAim_Cell(boxMax.z);
+    numCells = (maxCell[0] - minCell[0] + 1) * (maxCell[1] - minCell[1] + 1) * (maxCell[2] - minCell[2] + 1);
+
+    // Bigger than the table: every bucket once is cheaper
+    if (numCells >= SITHAUTOAIM_GRID_BUCKETS || numCells <= 0)
+    {
+        for (x = 0; x < SITHAUTOAIM_GRID_BUCKETS; x++)
+            numThings = sithAutoAim_Visit(x, view, tanFov, bWide, maxDist, numThings, maxThings, thingList);
+        return numThings;
+    }
+
+    for (x = minCell[0]; x <= maxCell[0]; x++)
+    {
+        for (y = minCell[1]; y <= maxCell[1]; y++)
+        {
+            for (z = minCell[2]; z <= maxCell[2]; z++)
+                numThings = sithAutoAim_Visit(sithAutoAim_Bucket(x, y, z), view, tanFov, bWide, maxDist, numThings, maxThings, thingList);
+        }
+    }
+    return numThings;
+}
+
+static int sithAutoAim_Moved(rdVector3* from, rdVector3* to)
+{
+    rdVector3 delta;
+
+    rdVector_Sub3(&delta, to, from);
+    return rdVector_Dot3(&delta, &delta) > SITHAUTOAIM_LOS_MOVE * SITHAUTOAIM_LOS_MOVE;
+}
+
+// sithCollision_HasLos, reused while neither end has moved
+int sithAutoAim_HasLos(sithThing* sender, sithThing* target)
+{
+    sithAutoAimLos* los = &sithAutoAim_aLos[(sender->thingIdx * 31 + target->thingIdx) & (SITHAUTOAIM_LOS_ENTRIES - 1)];
+
+    if (los->sender == sender
+        && los->target == target
+        && los->senderSignature == sender->signature
+        && los->targetSignature == target->signature
+        && sithTime_curMs - los->testMs < SITHAUTOAIM_LOS_MAX_MS
+        && !sithAutoAim_Moved(&los->senderPos, &sender->position)
+        && !sithAutoAim_Moved(&los->targetPos, &target->position))
+    {
+        return los->hasLos;
+    }
+
+    los->sender = sender;
+    los->target = target;
+    los->senderSignature = sender->signature;
+    los->targetSignature = target->signature;
+    rdVector_Copy3(&los->senderPos, &sender->position);
+    rdVector_Copy3(&los->targetPos, &target->position);
+    los->testMs = sithTime_curMs;
+    los->hasLos = sithCollision_HasLos(sender, target, 0);
+
+    return los->hasLos;
+}
+
+void sithAutoAim_Reset()
+{
+    // Things and their indices belong to the world being unloaded
+    sithAutoAim_bGridValid = 0;
+    sithAutoAim_numEntries = 0;
+    sithAutoAim_maxRange = 0.0;
+    _memset(sithAutoAim_aLos, 0, sizeof(sithAutoAim_aLos));
+}
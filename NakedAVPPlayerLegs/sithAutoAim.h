@@ -0,0 +1,43 @@
+#ifndef _SITHAUTOAIM_H
+#define _SITHAUTOAIM_H
+
+#ifndef SITHAUTOAIM_STANDALONE
+#include "types.h"
+#include "globals.h"
+#endif
+
+// Added: auto-aim candidate search without the sector flood.
+//
+// sithWeapon_ProjectileAutoAim used to gather targets with
+// sithAI_FirstThingInView and then run sithCollision_HasLos on each one,
+// for every shot. Here the actors and players are hashed into a grid
+// once per tick, the first time anything aims, with cells sized from
+// the longest aiming range seen (SITHAUTOAIM_RANGE_CELLS across it), and
+// a shot only visits the cells its cone overlaps. The grid is never
+// rebuilt within a tick, whatever ranges the shooters have. Candidates
+// come back nearest first, so the SITHAUTOAIM_MAX_CANDIDATES kept are
+// the nearest ones, not whichever buckets came first.
+//
+// LOS results are cached per shooter and target and reused until either
+// of them moves past SITHAUTOAIM_LOS_MOVE or the result gets
+// SITHAUTOAIM_LOS_MAX_MS old, so a repeater firing at the same target
+// does one LOS test, not dozens.
+//
+// sithAutoAim_compare.c builds this file on its own
+// (SITHAUTOAIM_STANDALONE) and checks queries against a brute-force cone
+// search.
+
+#define SITHAUTOAIM_MAX_CANDIDATES (64)
+#define SITHAUTOAIM_MAX_THINGS     (512)
+#define SITHAUTOAIM_GRID_BUCKETS   (256)
+#define SITHAUTOAIM_RANGE_CELLS    (4)
+#define SITHAUTOAIM_MIN_CELL_SIZE  (0.5)
+#define SITHAUTOAIM_LOS_ENTRIES    (64)
+#define SITHAUTOAIM_LOS_MOVE       (0.025)
+#define SITHAUTOAIM_LOS_MAX_MS     (250)
+
+MATH_FUNC int sithAutoAim_ThingsInCone(rdMatrix34* view, flex_t fov, flex_t maxDist, int maxThings, sithThing** thingList);
+MATH_FUNC int sithAutoAim_HasLos(sithThing* sender, sithThing* target);
+void sithAutoAim_Reset();
+
+#endif // _SITHAUTOAIM_H
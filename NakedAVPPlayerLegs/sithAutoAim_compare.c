@@ -0,0 +1,354 @@
+// ================================================================
+// File: sithAutoAim_compare.c
+// Brute-force check for the auto-aim grid (sithAutoAim)
+//
+// Scatters actors, players and other things, moves them every tick and
+// aims from random spots with a mix of weapon ranges and fields of view.
+// Every sithAutoAim_ThingsInCone result is compared with a brute-force
+// cone test over every thing, sorted nearest first and cut at the
+// candidate limit. It also checks that:
+//
+// - a tick builds one grid, however many different ranges aim in it
+//   (things moved after the first query must not show up until the next
+//   tick);
+// - the LOS cache reuses a result until either end moves or it ages, and
+//   tests again after that.
+//
+// Results are printed as JSON; the exit code is non-zero on a mismatch.
+//
+// Build:
+//   cc -O2 sithAutoAim_compare.c -lm -o sithAutoAim_compare
+//
+// Usage:
+//   sithAutoAim_compare [--things N] [--ticks N] [--queries N] [--seed N]
+// ================================================================
+
+#define SITHAUTOAIM_STANDALONE
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ================================================================
+// Stand-ins for the engine types and functions sithAutoAim.c uses
+// ================================================================
+
+typedef float flex_t;
+#define MATH_FUNC
+
+typedef struct { flex_t x, y, z; } rdVector3;
+typedef struct { rdVector3 rvec, lvec, uvec, scale; } rdMatrix34;
+typedef struct sithThing
+{
+    int type;
+    int thingflags;
+    int thingIdx;
+    int signature;
+    rdVector3 position;
+    flex_t collideSize;
+} sithThing;
+typedef struct { int numThingsLoaded; sithThing* things; } sithWorld;
+
+#define SITH_THING_ACTOR        (2)
+#define SITH_THING_PLAYER       (10)
+#define SITH_TF_DISABLED        (0x1)
+#define SITH_TF_WILLBEREMOVED   (0x2)
+
+#define _memset memset
+
+static sithWorld compare_world;
+static sithWorld* sithWorld_pCurrentWorld = &compare_world;
+static uint32_t sithTime_curMs = 1000;
+static int compare_numLosTests;
+
+static int sithCollision_HasLos(sithThing* sender, sithThing* target, int flags)
+{
+    (void)sender;
+    (void)target;
+    (void)flags;
+    compare_numLosTests++;
+    return 1;
+}
+
+static void stdMath_SinCos(flex_t angle, flex_t* pSin, flex_t* pCos)
+{
+    *pSin = sinf(angle * 3.14159265f / 180.0f);
+    *pCos = cosf(angle * 3.14159265f / 180.0f);
+}
+
+static void rdVector_Copy3(rdVector3* out, const rdVector3* v) { *out = *v; }
+static void rdVector_Sub3(rdVector3* out, const rdVector3* a, const rdVector3* b) { out->x = a->x - b->x; out->y = a->y - b->y; out->z = a->z - b->z; }
+static flex_t rdVector_Dot3(const rdVector3* a, const rdVector3* b) { return a->x*b->x + a->y*b->y + a->z*b->z; }
+
+#include "sithAutoAim.c"
+
+// ================================================================
+// Brute force
+// ================================================================
+
+#define COMPARE_MAX_THINGS      (1024)
+#define COMPARE_WORLD_SIZE      (40.0f)
+#define COMPARE_TICK_MS         (20)
+
+static sithThing compare_aThings[COMPARE_MAX_THINGS];
+static uint32_t compare_seed = 1;
+
+static const float compare_aRanges[] = { 0.5f, 1.0f, 2.0f, 4.0f, 8.0f };
+
+static float Compare_Rand()
+{
+    compare_seed = compare_seed * 1664525u + 1013904223u;
+    return (float)(compare_seed >> 8) / 16777216.0f;
+}
+
+static float Compare_Range(float lo, float hi)
+{
+    return lo + (hi - lo) * Compare_Rand();
+}
+
+static int Compare_SortDist(const void* a, const void* b)
+{
+    float x = *(const float*)a;
+    float y = *(const float*)b;
+    return x < y ? -1 : x > y;
+}
+
+// Squared distances of every candidate in the cone, nearest first. The
+// grid holds only the first SITHAUTOAIM_MAX_THINGS candidates, so this
+// stops there as well.
+static int Compare_Cone(rdMatrix34* view, float fov, float maxDist, float* aDist)
+{
+    float sinFov, cosFov, tanFov;
+    int bWide;
+    int numCandidates = 0, n = 0;
+    int i;
+
+    stdMath_SinCos(fov, &sinFov, &cosFov);
+    bWide = cosFov <= 0.1f;
+    tanFov = bWide ? (cosFov < 0.0f ? -1.0f : 0.0f) : sinFov / cosFov;
+
+    for (i = 0; i < compare_world.numThingsLoaded; i++)
+    {
+        sithThing* thing = &compare_aThings[i];
+        rdVector3 delta;
+        float distSq, forward, side, up;
+
+        if (thing->type != SITH_THING_ACTOR && thing->type != SITH_THING_PLAYER)
+            continue;
+        if (thing->thingflags & (SITH_TF_DISABLED | SITH_TF_WILLBEREMOVED))
+            continue;
+        if (numCandidates++ == SITHAUTOAIM_MAX_THINGS)
+            break;
+
+        rdVector_Sub3(&delta, &thing->position, &view->scale);
+        distSq = rdVector_Dot3(&delta, &delta);
+        if (distSq > maxDist * maxDist)
+            continue;
+
+        forward = rdVector_Dot3(&delta, &view->lvec);
+        if (bWide)
+        {
+            if (tanFov < 0.0f || forward > 0.0f)
+                aDist[n++] = distSq;
+            continue;
+        }
+        if (forward <= 0.0f)
+            continue;
+
+        side = fabsf(rdVector_Dot3(&delta, &view->rvec));
+        up = fabsf(rdVector_Dot3(&delta, &view->uvec));
+        if (side - thing->collideSize <= forward * tanFov && up - thing->collideSize <= forward * tanFov)
+            aDist[n++] = distSq;
+    }
+
+    qsort(aDist, n, sizeof(aDist[0]), Compare_SortDist);
+    return n;
+}
+
+static void Compare_View(rdMatrix34* view)
+{
+    float yaw = Compare_Range(-3.14159265f, 3.14159265f);
+    float pitch = Compare_Range(-1.2f, 1.2f);
+
+    view->lvec.x = cosf(yaw) * cosf(pitch);
+    view->lvec.y = sinf(yaw) * cosf(pitch);
+    view->lvec.z = sinf(pitch);
+    view->rvec.x = sinf(yaw);
+    view->rvec.y = -cosf(yaw);
+    view->rvec.z = 0.0f;
+    view->uvec.x = -cosf(yaw) * sinf(pitch);
+    view->uvec.y = -sinf(yaw) * sinf(pitch);
+    view->uvec.z = cosf(pitch);
+    view->scale.x = Compare_Range(-COMPARE_WORLD_SIZE * 0.5f, COMPARE_WORLD_SIZE * 0.5f);
+    view->scale.y = Compare_Range(-COMPARE_WORLD_SIZE * 0.5f, COMPARE_WORLD_SIZE * 0.5f);
+    view->scale.z = Compare_Range(-1.0f, 1.0f);
+}
+
+// Clustered, so some cones hold more than SITHAUTOAIM_MAX_CANDIDATES
+static void Compare_Place(sithThing* thing)
+{
+    float spread = Compare_Rand() < 0.3f ? 1.5f : COMPARE_WORLD_SIZE * 0.5f;
+
+    thing->position.x = Compare_Range(-spread, spread);
+    thing->position.y = Compare_Range(-spread, spread);
+    thing->position.z = Compare_Range(-1.0f, 1.0f);
+}
+
+static int Compare_LosCache()
+{
+    sithThing sender, target;
+    int bad = 0;
+    int i;
+
+    memset(&sender, 0, sizeof(sender));
+    memset(&target, 0, sizeof(target));
+    sender.thingIdx = 1;
+    sender.signature = 7;
+    target.thingIdx = 2;
+    target.signature = 9;
+    target.position.x = 1.0f;
+    compare_numLosTests = 0;
+
+    for (i = 0; i < 20; i++)
+        sithAutoAim_HasLos(&sender, &target);
+    bad |= compare_numLosTests != 1;
+
+    target.position.x += SITHAUTOAIM_LOS_MOVE * 0.5f;
+    sithAutoAim_HasLos(&sender, &target);
+    bad |= compare_numLosTests != 1;
+
+    target.position.x += SITHAUTOAIM_LOS_MOVE * 2.0f;
+    sithAutoAim_HasLos(&sender, &target);
+    bad |= compare_numLosTests != 2;
+
+    sithTime_curMs += SITHAUTOAIM_LOS_MAX_MS + 1;
+    sithAutoAim_HasLos(&sender, &target);
+    bad |= compare_numLosTests != 3;
+
+    // Same slot, another thing
+    target.signature++;
+    sithAutoAim_HasLos(&sender, &target);
+    bad |= compare_numLosTests != 4;
+
+    return bad;
+}
+
+int main(int argc, char** argv)
+{
+    static sithThing* thingList[SITHAUTOAIM_MAX_CANDIDATES];
+    static float aExpected[COMPARE_MAX_THINGS];
+    int numThings = 600;
+    int numTicks = 200;
+    int queriesPerTick = 8;
+    long queries = 0, truncated = 0, mismatches = 0, midTickRebuilds = 0;
+    int losMismatch;
+    int tick, q, i;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "--things"))
+            numThings = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--ticks"))
+            numTicks = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--queries"))
+            queriesPerTick = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seed"))
+            compare_seed = (uint32_t)atoi(argv[i + 1]);
+    }
+    if (numThings < 0)
+        numThings = 0;
+    if (numThings > COMPARE_MAX_THINGS)
+        numThings = COMPARE_MAX_THINGS;
+
+    compare_world.numThingsLoaded = numThings;
+    compare_world.things = compare_aThings;
+    for (i = 0; i < numThings; i++)
+    {
+        sithThing* thing = &compare_aThings[i];
+        float roll = Compare_Rand();
+
+        thing->type = roll < 0.1f ? 0 : (roll < 0.2f ? SITH_THING_PLAYER : SITH_THING_ACTOR);
+        thing->thingflags = Compare_Rand() < 0.05f ? SITH_TF_DISABLED : 0;
+        thing->thingIdx = i;
+        thing->signature = i + 1;
+        thing->collideSize = Compare_Range(0.02f, 0.2f);
+        Compare_Place(thing);
+    }
+
+    for (tick = 0; tick < numTicks; tick++)
+    {
+        sithTime_curMs += COMPARE_TICK_MS;
+        for (i = 0; i < numThings; i++)
+        {
+            compare_aThings[i].position.x += Compare_Range(-0.05f, 0.05f);
+            compare_aThings[i].position.y += Compare_Range(-0.05f, 0.05f);
+        }
+
+        for (q = 0; q < queriesPerTick; q++)
+        {
+            rdMatrix34 view;
+            float fov = Compare_Rand() < 0.1f ? Compare_Range(86.0f, 180.0f) : Compare_Range(2.0f, 60.0f);
+            float maxDist = compare_aRanges[(int)(Compare_Rand() * 5)];
+            int n, expected;
+
+            Compare_View(&view);
+            n = sithAutoAim_ThingsInCone(&view, fov, maxDist, SITHAUTOAIM_MAX_CANDIDATES, thingList);
+            expected = Compare_Cone(&view, fov, maxDist, aExpected);
+            if (expected > SITHAUTOAIM_MAX_CANDIDATES)
+            {
+                expected = SITHAUTOAIM_MAX_CANDIDATES;
+                truncated++;
+            }
+            queries++;
+
+            if (n != expected)
+            {
+                mismatches++;
+                continue;
+            }
+            for (i = 0; i < n; i++)
+            {
+                rdVector3 delta;
+
+                rdVector_Sub3(&delta, &thingList[i]->position, &view.scale);
+                if (fabsf(rdVector_Dot3(&delta, &delta) - aExpected[i]) > 1e-4f)
+                {
+                    mismatches++;
+                    break;
+                }
+            }
+        }
+
+        // Moved after this tick's grid: a longer range now must not pick
+        // them up until the next tick
+        if (numThings)
+        {
+            rdMatrix34 view;
+            rdVector3 before = sithAutoAim_aEntries[0].position;
+
+            compare_aThings[sithAutoAim_aEntries[0].thing->thingIdx].position.z += 5.0f;
+            Compare_View(&view);
+            sithAutoAim_ThingsInCone(&view, 90.0f, 16.0f, SITHAUTOAIM_MAX_CANDIDATES, thingList);
+            if (memcmp(&before, &sithAutoAim_aEntries[0].position, sizeof(before)) != 0)
+                midTickRebuilds++;
+            compare_aThings[sithAutoAim_aEntries[0].thing->thingIdx].position.z -= 5.0f;
+        }
+    }
+
+    losMismatch = Compare_LosCache();
+
+    printf("{\n");
+    printf("  \"things\": %d,\n", numThings);
+    printf("  \"ticks\": %d,\n", numTicks);
+    printf("  \"queries\": %ld,\n", queries);
+    printf("  \"truncated\": %ld,\n", truncated);
+    printf("  \"cellSize\": %g,\n", sithAutoAim_cellSize);
+    printf("  \"mismatches\": %ld,\n", mismatches);
+    printf("  \"midTickRebuilds\": %ld,\n", midTickRebuilds);
+    printf("  \"losCacheMismatch\": %d\n", losMismatch);
+    printf("}\n");
+
+    return (mismatches || midTickRebuilds || losMismatch) ? 1 : 0;
+}
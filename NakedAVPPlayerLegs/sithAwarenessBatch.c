@@ -0,0 +1,117 @@
+#include "sithAwarenessBatch.h"
+
+#include "World/sithThing.h"
+#include "World/sithSector.h"
+#include "AI/sithAIAwareness.h"
+#include "General/stdMath.h"
+#include "jk.h"
+
+typedef struct sithAwarenessEvent
+{
+    sithSector* sector;
+    int type;
+    flex_t level;               // Highest level merged in
+    rdVector3 boundsMin;
+    rdVector3 boundsMax;
+    sithThing* thing;           // Source of the highest level event
+    int thingSignature;
+    sithThing* lastThing;       // Source of the latest event, if that one is gone
+    int lastThingSignature;
+} sithAwarenessEvent;
+
+static sithAwarenessEvent sithAwarenessBatch_aEvents[SITHAWARENESSBATCH_MAX];
+static int sithAwarenessBatch_numEvents;
+
+void sithAwarenessBatch_Add(sithSector* sector, rdVector3* pos, int type, flex_t level, sithThing* thing)
+{
+    sithAwarenessEvent* event;
+    int i;
+
+    if (!sector)
+        return;
+
+    for (i = 0; i < sithAwarenessBatch_numEvents; i++)
+    {
+        event = &sithAwarenessBatch_aEvents[i];
+        if (event->sector != sector || event->type != type)
+            continue;
+
+        if (pos->x < event->boundsMin.x) event->boundsMin.x = pos->x;
+        if (pos->y < event->boundsMin.y) event->boundsMin.y = pos->y;
+        if (pos->z < event->boundsMin.z) event->boundsMin.z = pos->z;
+        if (pos->x > event->boundsMax.x) event->boundsMax.x = pos->x;
+        if (pos->y > event->boundsMax.y) event->boundsMax.y = pos->y;
+        if (pos->z > event->boundsMax.z) event->boundsMax.z = pos->z;
+
+        if (level >= event->level)
+        {
+            event->level = level;
+            event->thing = thing;
+            event->thingSignature = thing ? thing->signature : 0;
+        }
+        event->lastThing = thing;
+        event->lastThingSignature = thing ? thing->signature : 0;
+        return;
+    }
+
+    // Out of room: straight through, as before
+    if (sithAwarenessBatch_numEvents == SITHAWARENESSBATCH_MAX)
+    {
+        sithAIAwareness_AddEntry(sector, pos, type, level, thing);
+        return;
+    }
+
+    event = &sithAwarenessBatch_aEvents[sithAwarenessBatch_numEvents++];
+    event->sector = sector;
+    event->type = type;
+    event->level = level;
+    rdVector_Copy3(&event->boundsMin, pos);
+    rdVector_Copy3(&event->boundsMax, pos);
+    event->thing = thing;
+    event->thingSignature = thing ? thing->signature : 0;
+    event->lastThing = thing;
+    event->lastThingSignature = thing ? thing->signature : 0;
+}
+
+static int sithAwarenessBatch_IsAlive(sithThing* thing, int signature)
+{
+    return thing && thing->type != SITH_THING_FREE && thing->signature == signature;
+}
+
+void sithAwarenessBatch_Flush()
+{
+    int i;
+
+    for (i = 0; i < sithAwarenessBatch_numEvents; i++)
+    {
+        sithAwarenessEvent* event = &sithAwarenessBatch_aEvents[i];
+        sithThing* thing = event->thing;
+        rdVector3 center, halfSize;
+
+        // A projectile can be gone by the end of the tick that queued it,
+        // and its slot reused; a later source that is still there is
+        // better. If neither is, the event goes out without a source
+        // rather than with a pointer to whatever took the slot.
+        if (!sithAwarenessBatch_IsAlive(thing, event->thingSignature))
+        {
+            if (sithAwarenessBatch_IsAlive(event->lastThing, event->lastThingSignature))
+                thing = event->lastThing;
+            else
+                thing = NULL;
+        }
+
+        rdVector_Sub3(&halfSize, &event->boundsMax, &event->boundsMin);
+        rdVector_Scale3Acc(&halfSize, 0.5);
+        rdVector_Add3(&center, &event->boundsMin, &halfSize);
+
+        sithAIAwareness_AddEntry(event->sector, &center, event->type, event->level + rdVector_Len3(&halfSize), thing);
+    }
+
+    sithAwarenessBatch_numEvents = 0;
+}
+
+void sithAwarenessBatch_Reset()
+{
+    // The sectors and things belong to the world being unloaded
+    sithAwarenessBatch_numEvents = 0;
+}
@@ -0,0 +1,28 @@
+#ifndef _SITHAWARENESSBATCH_H
+#define _SITHAWARENESSBATCH_H
+
+#include "types.h"
+#include "globals.h"
+
+// Added: per-tick coalescing of weapon AI awareness events.
+//
+// Every shot with a fire sound, every 8th tick of every
+// SITH_WF_TRIGGER_AI_AWARENESS projectile and every explosion used to add
+// its own sithAIAwareness entry. A minigun stream fills the engine's
+// small entry table with near-identical events in one sector and the
+// rest of the tick's events are dropped. Weapon events are collected
+// here instead, merged per sector and event type, and handed to
+// sithAIAwareness_AddEntry once per tick by sithWeapon_TickEnd.
+//
+// A merged event keeps the highest level of its events and is placed at
+// the center of their bounds. The level is raised by the half-diagonal
+// of the bounds so it still reaches everything each original event
+// reached.
+
+#define SITHAWARENESSBATCH_MAX (32)
+
+void sithAwarenessBatch_Add(sithSector* sector, rdVector3* pos, int type, flex_t level, sithThing* thing);
+MATH_FUNC void sithAwarenessBatch_Flush();
+void sithAwarenessBatch_Reset();
+
+#endif // _SITHAWARENESSBATCH_H
@@ -0,0 +1,133 @@
+#include "sithDecalPool.h"
+
+#include "World/sithThing.h"
+#include "World/sithSector.h"
+#include "Gameplay/sithTime.h"
+#include "Engine/sithRender.h"
+#include "Engine/rdThing.h"
+#include "jk.h"
+
+typedef struct sithDecalPoolEntry
+{
+    sithThing* decalTemplate;   // NULL when free
+    sithSector* sector;
+    sithSurface* surface;       // Merge key only, NULL for thing hits
+    rdMatrix34 orient;          // scale holds the position, as drawn
+    uint32_t lastHit;           // LRU stamp
+    uint32_t expireMs;
+    int bExpires;               // 0: stays until evicted
+} sithDecalPoolEntry;
+
+static sithDecalPoolEntry sithDecalPool_aDecals[SITHDECALPOOL_MAX];
+static uint32_t sithDecalPool_stamp;
+
+// A decal thing that only sits on the wall until its lifetime runs out.
+// Anything it could do as a thing (move, collide, run a cog, light the
+// room, play a create sound) would be lost in the pool, so those keep
+// the old path.
+static int sithDecalPool_CanPool(sithThing* decalTemplate)
+{
+    if (decalTemplate->rdthing.type != RD_THINGTYPE_DECAL)
+        return 0;
+    if (decalTemplate->moveType != SITH_MT_NONE || decalTemplate->collide != SITH_COLLIDE_NONE)
+        return 0;
+    if (decalTemplate->class_cog || decalTemplate->soundclass)
+        return 0;
+    if (decalTemplate->thingflags & SITH_TF_LIGHT)
+        return 0;
+
+    return 1;
+}
+
+// Returns 0 when the template can't be pooled; the caller then creates
+// the thing itself.
+int sithDecalPool_Add(sithThing* decalTemplate, rdVector3* pos, rdMatrix34* orient, sithSector* sector, sithSurface* surface)
+{
+    sithDecalPoolEntry* decal;
+    int freeIdx = -1, lruIdx = -1;
+    int idx;
+
+    if (!sector || !sithDecalPool_CanPool(decalTemplate))
+        return 0;
+
+    // Near one already there: that one is hit again
+    for (idx = 0; idx < SITHDECALPOOL_MAX; idx++)
+    {
+        rdVector3 diff;
+
+        decal = &sithDecalPool_aDecals[idx];
+        if (decal->decalTemplate != decalTemplate || decal->surface != surface || decal->sector != sector)
+            continue;
+
+        rdVector_Sub3(&diff, &decal->orient.scale, pos);
+        if (rdVector_Dot3(&diff, &diff) > SITHDECALPOOL_MERGE_DIST * SITHDECALPOOL_MERGE_DIST)
+            continue;
+
+        decal->lastHit = ++sithDecalPool_stamp;
+        decal->expireMs = sithTime_curMs + decalTemplate->lifeLeftMs;
+        return 1;
+    }
+
+    // A free record, else the least recently hit decal is reused
+    for (idx = 0; idx < SITHDECALPOOL_MAX; idx++)
+    {
+        decal = &sithDecalPool_aDecals[idx];
+        if (!decal->decalTemplate)
+        {
+            freeIdx = idx;
+            break;
+        }
+        if (lruIdx < 0 || decal->lastHit < sithDecalPool_aDecals[lruIdx].lastHit)
+            lruIdx = idx;
+    }
+    if (freeIdx < 0)
+        freeIdx = lruIdx;
+
+    decal = &sithDecalPool_aDecals[freeIdx];
+    decal->decalTemplate = decalTemplate;
+    decal->sector = sector;
+    decal->surface = surface;
+    _memcpy(&decal->orient, orient, sizeof(decal->orient));
+    rdVector_Copy3(&decal->orient.scale, pos);
+    decal->lastHit = ++sithDecalPool_stamp;
+    decal->bExpires = decalTemplate->lifeLeftMs > 0;
+    decal->expireMs = sithTime_curMs + decalTemplate->lifeLeftMs;
+
+    return 1;
+}
+
+void sithDecalPool_Tick()
+{
+    int i;
+
+    for (i = 0; i < SITHDECALPOOL_MAX; i++)
+    {
+        sithDecalPoolEntry* decal = &sithDecalPool_aDecals[i];
+
+        if (decal->decalTemplate && decal->bExpires && (int32_t)(decal->expireMs - sithTime_curMs) <= 0)
+            decal->decalTemplate = NULL;
+    }
+}
+
+// Render hook, see sithDecalPool.h
+void sithDecalPool_Draw()
+{
+    int i;
+
+    for (i = 0; i < SITHDECALPOOL_MAX; i++)
+    {
+        sithDecalPoolEntry* decal = &sithDecalPool_aDecals[i];
+
+        if (!decal->decalTemplate || decal->sector->renderTick != sithRender_lastRenderTick)
+            continue;
+        rdThing_Draw(&decal->decalTemplate->rdthing, &decal->orient);
+    }
+}
+
+void sithDecalPool_Reset()
+{
+    // The templates, sectors and surfaces belong to the world being
+    // unloaded
+    _memset(sithDecalPool_aDecals, 0, sizeof(sithDecalPool_aDecals));
+    sithDecalPool_stamp = 0;
+}
@@ -0,0 +1,39 @@
+#ifndef _SITHDECALPOOL_H
+#define _SITHDECALPOOL_H
+
+#include "types.h"
+#include "globals.h"
+
+// Added: pooled weapon impact decals.
+//
+// sithWeapon_WallHitExplode used to create a wallHitTemplate thing for
+// every impact, so sustained fire at a wall kept adding things (and
+// overlapping quads) for as long as it lasted. Decal templates now go
+// into a fixed pool of records instead:
+//
+// - an impact within SITHDECALPOOL_MERGE_DIST of a decal of the same
+//   template on the same surface refreshes that decal rather than adding
+//   one on top of it;
+// - when the pool is full, the least recently hit decal is reused.
+//
+// SITHDECALPOOL_MAX is the only limit; any number of templates share the
+// pool. Decals still expire with their template's lifetime; templates
+// with none stay until they are evicted. Only cosmetic decal templates
+// are pooled (see sithDecalPool_Add); anything else still gets its
+// thing.
+//
+// Render hook: nothing in this tree draws the pool. DECAL_POOL is off
+// unless defined, and must stay off until sithRender_Draw (outside this
+// tree) calls sithDecalPool_Draw right after sithRender_RenderThings,
+// while the visible sectors' renderTick is current; without that call
+// pooled decals are invisible.
+
+#define SITHDECALPOOL_MAX           (128)
+#define SITHDECALPOOL_MERGE_DIST    (0.02)
+
+MATH_FUNC int sithDecalPool_Add(sithThing* decalTemplate, rdVector3* pos, rdMatrix34* orient, sithSector* sector, sithSurface* surface);
+void sithDecalPool_Tick();
+MATH_FUNC void sithDecalPool_Draw();
+void sithDecalPool_Reset();
+
+#endif // _SITHDECALPOOL_H
@@ -0,0 +1,541 @@
+#include "sithFireNet.h"
+
+#include <math.h>
+#include <string.h>
+
+#ifndef SITHFIRENET_STANDALONE
+#include "World/sithThing.h"
+#include "World/sithTemplate.h"
+#include "World/sithSound.h"
+#include "Dss/sithMulti.h"
+#include "Win95/sithComm.h"
+#include "jk.h"
+
+#include "sithWeapon.h"
+#endif
+
+// What a shot sends beyond its origin, direction and thing id
+#define SITHFIRENET_NEW_REF     (0x01)  // Shooter id and reference position
+#define SITHFIRENET_TEMPLATE    (0x02)
+#define SITHFIRENET_SOUND       (0x04)
+#define SITHFIRENET_ANIM        (0x08)
+#define SITHFIRENET_SCALE       (0x10)  // scale and scaleFlags
+#define SITHFIRENET_DELTA       (0x20)
+#define SITHFIRENET_EXTRA       (0x40)
+#define SITHFIRENET_FAR         (0x80)  // Origin as floats
+
+// Largest a shot can encode to (mask, every field, float origin)
+#define SITHFIRENET_MAX_EVENT_SIZE (1 + 5 + 12 + 5 + 5 + 5 + 4 + 5 + 4 + 5 + 12 + 4 + 5)
+
+// ================================================================
+// Quantization
+// ================================================================
+
+static int sithFireNet_OriginCode(const float* ref, const float* origin, int16_t* code)
+{
+    int i;
+
+    for (i = 0; i < 3; i++)
+    {
+        float q = floorf((origin[i] - ref[i]) * SITHFIRENET_ORIGIN_SCALE + 0.5f);
+
+        if (q < -32767.0f || q > 32767.0f)
+            return 0;
+        code[i] = (int16_t)q;
+    }
+    return 1;
+}
+
+static void sithFireNet_OriginFromCode(const float* ref, const int16_t* code, float* origin)
+{
+    int i;
+
+    for (i = 0; i < 3; i++)
+        origin[i] = ref[i] + (float)code[i] / SITHFIRENET_ORIGIN_SCALE;
+}
+
+// Origin as every machine will see it. Too far from the reference to
+// quantize, it is sent (and kept) as is.
+void sithFireNet_QuantizeOrigin(const float* ref, float* origin)
+{
+    int16_t code[3];
+
+    if (sithFireNet_OriginCode(ref, origin, code))
+        sithFireNet_OriginFromCode(ref, code, origin);
+}
+
+static int16_t sithFireNet_Snorm16(float v)
+{
+    if (v > 1.0f)
+        v = 1.0f;
+    if (v < -1.0f)
+        v = -1.0f;
+    return (int16_t)floorf(v * 32767.0f + 0.5f);
+}
+
+static void sithFireNet_DirCode(const float* dir, int16_t* code)
+{
+    float len = fabsf(dir[0]) + fabsf(dir[1]) + fabsf(dir[2]);
+    float x, y;
+
+    if (len <= 0.0f)
+    {
+        code[0] = 0;
+        code[1] = 0;
+        return;
+    }
+
+    // Onto the octahedron, the lower half folded over the diagonals
+    x = dir[0] / len;
+    y = dir[1] / len;
+    if (dir[2] < 0.0f)
+    {
+        float fx = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float fy = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+
+        x = fx;
+        y = fy;
+    }
+    code[0] = sithFireNet_Snorm16(x);
+    code[1] = sithFireNet_Snorm16(y);
+}
+
+static void sithFireNet_DirFromCode(const int16_t* code, float* dir)
+{
+    float x = (float)code[0] / 32767.0f;
+    float y = (float)code[1] / 32767.0f;
+    float z = 1.0f - fabsf(x) - fabsf(y);
+    float t = z < 0.0f ? -z : 0.0f;
+    float len;
+
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+
+    len = sqrtf(x*x + y*y + z*z);
+    dir[0] = x / len;
+    dir[1] = y / len;
+    dir[2] = z / len;
+}
+
+// Direction as every machine will see it, and its code. The code is
+// what gets sent: encoding the decoded direction again is not always
+// the same code.
+void sithFireNet_QuantizeDir(float* dir, int16_t* code)
+{
+    sithFireNet_DirCode(dir, code);
+    sithFireNet_DirFromCode(code, dir);
+}
+
+// ================================================================
+// Packet codec
+// ================================================================
+
+typedef struct sithFireNetWriter
+{
+    uint8_t* buf;
+    int pos;
+} sithFireNetWriter;
+
+typedef struct sithFireNetReader
+{
+    const uint8_t* buf;
+    int size;
+    int pos;
+    int bError;
+} sithFireNetReader;
+
+static void sithFireNet_PutU8(sithFireNetWriter* w, uint8_t v)
+{
+    w->buf[w->pos++] = v;
+}
+
+static void sithFireNet_PutVarint(sithFireNetWriter* w, uint32_t v)
+{
+    while (v >= 0x80)
+    {
+        sithFireNet_PutU8(w, (uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    sithFireNet_PutU8(w, (uint8_t)v);
+}
+
+// Small deltas either way stay one byte
+static void sithFireNet_PutDelta(sithFireNetWriter* w, int32_t v)
+{
+    sithFireNet_PutVarint(w, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+static void sithFireNet_PutS16(sithFireNetWriter* w, int16_t v)
+{
+    sithFireNet_PutU8(w, (uint8_t)((uint16_t)v & 0xFF));
+    sithFireNet_PutU8(w, (uint8_t)((uint16_t)v >> 8));
+}
+
+static void sithFireNet_PutF32(sithFireNetWriter* w, float v)
+{
+    memcpy(&w->buf[w->pos], &v, sizeof(v));
+    w->pos += sizeof(v);
+}
+
+static uint8_t sithFireNet_GetU8(sithFireNetReader* r)
+{
+    if (r->pos >= r->size)
+    {
+        r->bError = 1;
+        return 0;
+    }
+    return r->buf[r->pos++];
+}
+
+static uint32_t sithFireNet_GetVarint(sithFireNetReader* r)
+{
+    uint32_t v = 0;
+    int shift;
+
+    for (shift = 0; shift < 35; shift += 7)
+    {
+        uint8_t b = sithFireNet_GetU8(r);
+
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return v;
+    }
+    r->bError = 1;
+    return 0;
+}
+
+static int32_t sithFireNet_GetDelta(sithFireNetReader* r)
+{
+    uint32_t v = sithFireNet_GetVarint(r);
+
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static int16_t sithFireNet_GetS16(sithFireNetReader* r)
+{
+    uint16_t lo = sithFireNet_GetU8(r);
+    uint16_t hi = sithFireNet_GetU8(r);
+
+    return (int16_t)(lo | (hi << 8));
+}
+
+static float sithFireNet_GetF32(sithFireNetReader* r)
+{
+    float v = 0.0f;
+
+    if (r->pos + (int)sizeof(v) > r->size)
+    {
+        r->bError = 1;
+        return v;
+    }
+    memcpy(&v, &r->buf[r->pos], sizeof(v));
+    r->pos += sizeof(v);
+    return v;
+}
+
+// Both ends start every packet from this
+static void sithFireNet_InitPrev(sithFireNetEvent* prev)
+{
+    memset(prev, 0, sizeof(*prev));
+    prev->soundIdx = -1;
+    prev->anim = -1;
+    prev->scale = 1.0f;
+}
+
+static int sithFireNet_SameRef(const sithFireNetEvent* a, const sithFireNetEvent* b)
+{
+    return a->shooterId == b->shooterId
+        && a->shooterPos[0] == b->shooterPos[0]
+        && a->shooterPos[1] == b->shooterPos[1]
+        && a->shooterPos[2] == b->shooterPos[2];
+}
+
+// Encodes as many of the events as fit in bufSize (at least one if
+// bufSize allows any). Returns how many were encoded, the packet size in
+// pSize.
+int sithFireNet_Encode(const sithFireNetEvent* events, int numEvents, uint8_t* buf, int bufSize, int* pSize)
+{
+    sithFireNetWriter w;
+    sithFireNetEvent prev;
+    int bFirst = 1;
+    int n;
+
+    // Count, patched in at the end (one byte, so at most 0x7F a packet)
+    w.buf = buf;
+    w.pos = 1;
+    sithFireNet_InitPrev(&prev);
+
+    for (n = 0; n < numEvents && n < 0x7F; n++)
+    {
+        const sithFireNetEvent* ev = &events[n];
+        int16_t originCode[3];
+        uint8_t mask = 0;
+        int i;
+
+        if (w.pos + SITHFIRENET_MAX_EVENT_SIZE > bufSize)
+            break;
+
+        if (bFirst || !sithFireNet_SameRef(ev, &prev))
+            mask |= SITHFIRENET_NEW_REF;
+        if (ev->templateIdx != prev.templateIdx)
+            mask |= SITHFIRENET_TEMPLATE;
+        if (ev->soundIdx != prev.soundIdx)
+            mask |= SITHFIRENET_SOUND;
+        if (ev->anim != prev.anim)
+            mask |= SITHFIRENET_ANIM;
+        if (ev->scale != prev.scale || ev->scaleFlags != prev.scaleFlags)
+            mask |= SITHFIRENET_SCALE;
+        if (ev->deltaSecs != prev.deltaSecs)
+            mask |= SITHFIRENET_DELTA;
+        if (ev->extra != prev.extra)
+            mask |= SITHFIRENET_EXTRA;
+        if (!sithFireNet_OriginCode(ev->shooterPos, ev->origin, originCode))
+            mask |= SITHFIRENET_FAR;
+
+        sithFireNet_PutU8(&w, mask);
+        if (mask & SITHFIRENET_NEW_REF)
+        {
+            sithFireNet_PutDelta(&w, ev->shooterId - prev.shooterId);
+            for (i = 0; i < 3; i++)
+                sithFireNet_PutF32(&w, ev->shooterPos[i]);
+        }
+        if (mask & SITHFIRENET_TEMPLATE)
+            sithFireNet_PutDelta(&w, ev->templateIdx - prev.templateIdx);
+        if (mask & SITHFIRENET_SOUND)
+            sithFireNet_PutDelta(&w, ev->soundIdx - prev.soundIdx);
+        if (mask & SITHFIRENET_ANIM)
+            sithFireNet_PutDelta(&w, ev->anim - prev.anim);
+        if (mask & SITHFIRENET_SCALE)
+        {
+            sithFireNet_PutF32(&w, ev->scale);
+            sithFireNet_PutVarint(&w, (uint16_t)ev->scaleFlags);
+        }
+        if (mask & SITHFIRENET_DELTA)
+            sithFireNet_PutF32(&w, ev->deltaSecs);
+        if (mask & SITHFIRENET_EXTRA)
+            sithFireNet_PutDelta(&w, ev->extra - prev.extra);
+
+        if (mask & SITHFIRENET_FAR)
+        {
+            for (i = 0; i < 3; i++)
+                sithFireNet_PutF32(&w, ev->origin[i]);
+        }
+        else
+        {
+            for (i = 0; i < 3; i++)
+                sithFireNet_PutS16(&w, originCode[i]);
+        }
+
+        sithFireNet_PutS16(&w, ev->dirCode[0]);
+        sithFireNet_PutS16(&w, ev->dirCode[1]);
+
+        // Consecutive spawns get consecutive ids, one byte
+        sithFireNet_PutDelta(&w, ev->thingId - prev.thingId);
+
+        prev = *ev;
+        bFirst = 0;
+    }
+
+    buf[0] = (uint8_t)n;
+    *pSize = w.pos;
+    return n;
+}
+
+// Returns the number of events, -1 for a malformed packet
+int sithFireNet_Decode(const uint8_t* buf, int size, sithFireNetEvent* events, int maxEvents)
+{
+    sithFireNetReader r;
+    sithFireNetEvent prev;
+    int numEvents, n;
+
+    r.buf = buf;
+    r.size = size;
+    r.pos = 0;
+    r.bError = 0;
+    sithFireNet_InitPrev(&prev);
+
+    numEvents = sithFireNet_GetU8(&r);
+    if (r.bError || numEvents > maxEvents)
+        return -1;
+
+    for (n = 0; n < numEvents; n++)
+    {
+        sithFireNetEvent* ev = &events[n];
+        uint8_t mask = sithFireNet_GetU8(&r);
+        int16_t originCode[3];
+        int i;
+
+        *ev = prev;
+        if (mask & SITHFIRENET_NEW_REF)
+        {
+            ev->shooterId = prev.shooterId + sithFireNet_GetDelta(&r);
+            for (i = 0; i < 3; i++)
+                ev->shooterPos[i] = sithFireNet_GetF32(&r);
+        }
+        if (mask & SITHFIRENET_TEMPLATE)
+            ev->templateIdx = (int16_t)(prev.templateIdx + sithFireNet_GetDelta(&r));
+        if (mask & SITHFIRENET_SOUND)
+            ev->soundIdx = (int16_t)(prev.soundIdx + sithFireNet_GetDelta(&r));
+        if (mask & SITHFIRENET_ANIM)
+            ev->anim = (int16_t)(prev.anim + sithFireNet_GetDelta(&r));
+        if (mask & SITHFIRENET_SCALE)
+        {
+            ev->scale = sithFireNet_GetF32(&r);
+            ev->scaleFlags = (int16_t)sithFireNet_GetVarint(&r);
+        }
+        if (mask & SITHFIRENET_DELTA)
+            ev->deltaSecs = sithFireNet_GetF32(&r);
+        if (mask & SITHFIRENET_EXTRA)
+            ev->extra = prev.extra + sithFireNet_GetDelta(&r);
+
+        if (mask & SITHFIRENET_FAR)
+        {
+            for (i = 0; i < 3; i++)
+                ev->origin[i] = sithFireNet_GetF32(&r);
+        }
+        else
+        {
+            for (i = 0; i < 3; i++)
+                originCode[i] = sithFireNet_GetS16(&r);
+            sithFireNet_OriginFromCode(ev->shooterPos, originCode, ev->origin);
+        }
+
+        ev->dirCode[0] = sithFireNet_GetS16(&r);
+        ev->dirCode[1] = sithFireNet_GetS16(&r);
+        sithFireNet_DirFromCode(ev->dirCode, ev->dir);
+
+        ev->thingId = prev.thingId + sithFireNet_GetDelta(&r);
+
+        if (r.bError)
+            return -1;
+        prev = *ev;
+    }
+
+    return r.pos == size ? numEvents : -1;
+}
+
+#ifndef SITHFIRENET_STANDALONE
+
+// ================================================================
+// Engine side
+// ================================================================
+
+static sithFireNetEvent sithFireNet_aQueue[SITHFIRENET_MAX_QUEUE];
+static int sithFireNet_numQueued;
+
+void sithFireNet_Startup()
+{
+    sithComm_SetMsgFunc(SITHFIRENET_MSG_ID, sithFireNet_ProcessMsg);
+}
+
+// Before the shooter fires its own copy: dir and origin are replaced by
+// what the other machines will decode, and event remembers them
+void sithFireNet_Prepare(sithFireNetEvent* event, sithThing* sender, rdVector3* dir, rdVector3* origin)
+{
+    memset(event, 0, sizeof(*event));
+    event->shooterId = sender->thing_id;
+    event->shooterPos[0] = (float)sender->position.x;
+    event->shooterPos[1] = (float)sender->position.y;
+    event->shooterPos[2] = (float)sender->position.z;
+    event->origin[0] = (float)origin->x;
+    event->origin[1] = (float)origin->y;
+    event->origin[2] = (float)origin->z;
+    event->dir[0] = (float)dir->x;
+    event->dir[1] = (float)dir->y;
+    event->dir[2] = (float)dir->z;
+
+    sithFireNet_QuantizeOrigin(event->shooterPos, event->origin);
+    sithFireNet_QuantizeDir(event->dir, event->dirCode);
+
+    origin->x = event->origin[0];
+    origin->y = event->origin[1];
+    origin->z = event->origin[2];
+    dir->x = event->dir[0];
+    dir->y = event->dir[1];
+    dir->z = event->dir[2];
+}
+
+// In place of sithDSSThing_SendFireProjectile, once the shot is fired
+void sithFireNet_Queue(sithFireNetEvent* event, sithThing* projectile, sithSound* fireSound, int anim, flex_t scale, int16_t scaleFlags, flex_t deltaSecs, int thingId, int extra)
+{
+    sithFireNetEvent* queued;
+
+    if (sithFireNet_numQueued == SITHFIRENET_MAX_QUEUE)
+        sithFireNet_Flush();
+
+    queued = &sithFireNet_aQueue[sithFireNet_numQueued++];
+    *queued = *event;
+    queued->templateIdx = projectile ? projectile->thingIdx : -1;
+    queued->soundIdx = fireSound ? fireSound->id : -1;
+    queued->anim = anim;
+    queued->scale = scale;
+    queued->scaleFlags = scaleFlags;
+    queued->deltaSecs = deltaSecs;
+    queued->thingId = thingId;
+    queued->extra = extra;
+}
+
+void sithFireNet_Flush()
+{
+    int sent = 0;
+
+    while (sent < sithFireNet_numQueued)
+    {
+        int size;
+
+        sent += sithFireNet_Encode(&sithFireNet_aQueue[sent], sithFireNet_numQueued - sent, (uint8_t*)sithComm_netMsgTmp.pktData, SITHFIRENET_MAX_PACKET, &size);
+        sithComm_netMsgTmp.netMsg.cogMsgId = SITHFIRENET_MSG_ID;
+        sithComm_netMsgTmp.netMsg.msg_size = size;
+        sithComm_SendMsgToPlayer(&sithComm_netMsgTmp, INVALID_DPID, 255, 1);
+    }
+
+    sithFireNet_numQueued = 0;
+}
+
+// Each shot as sithDSSThing_ProcessFireProjectile would have fired it
+int sithFireNet_ProcessMsg(sithCogMsg* msg)
+{
+    static sithFireNetEvent events[0x7F];
+    int numEvents, i;
+
+    numEvents = sithFireNet_Decode((const uint8_t*)msg->pktData, msg->netMsg.msg_size, events, 0x7F);
+    if (numEvents < 0)
+        return 0;
+
+    for (i = 0; i < numEvents; i++)
+    {
+        sithFireNetEvent* ev = &events[i];
+        sithThing* shooter = sithThing_GetById(ev->shooterId);
+        sithThing* projectile;
+        rdVector3 dir, origin;
+
+        if (!shooter)
+            continue;
+
+        projectile = ev->templateIdx >= 0 ? sithTemplate_GetEntryByIdx(ev->templateIdx) : NULL;
+        dir.x = ev->dir[0];
+        dir.y = ev->dir[1];
+        dir.z = ev->dir[2];
+        origin.x = ev->origin[0];
+        origin.y = ev->origin[1];
+        origin.z = ev->origin[2];
+
+        projectile = sithWeapon_FireProjectile_0(shooter, projectile, &dir, &origin,
+            ev->soundIdx >= 0 ? sithSound_GetFromIdx(ev->soundIdx) : NULL,
+            ev->anim, ev->scale, (char)ev->scaleFlags, ev->deltaSecs, ev->extra);
+        if (projectile)
+        {
+            projectile->thing_id = ev->thingId;
+            sithThing_netidMap[projectile->thingIdx] = ev->thingId;
+        }
+    }
+    return 1;
+}
+
+void sithFireNet_Reset()
+{
+    // Shots of the world being unloaded
+    sithFireNet_numQueued = 0;
+}
+
+#endif // SITHFIRENET_STANDALONE
@@ -0,0 +1,73 @@
+#ifndef _SITHFIRENET_H
+#define _SITHFIRENET_H
+
+#include <stdint.h>
+
+#ifndef SITHFIRENET_STANDALONE
+#include "types.h"
+#include "globals.h"
+#endif
+
+// Added: batched fire-projectile network messages.
+//
+// sithWeapon used to send one sithDSSThing_SendFireProjectile per shot,
+// each with full vectors and every parameter. Shots are now queued and
+// sent by sithWeapon_TickEnd as one SITHFIRENET_MSG_ID message per tick
+// (split at SITHFIRENET_MAX_PACKET bytes), encoded as:
+//
+// - origins quantized to 1/SITHFIRENET_ORIGIN_SCALE units relative to the
+//   shooter's position, which is sent once per shooter and packet
+//   (origins further than ~8 units away go out as floats);
+// - directions as octahedral normals, two 16 bit components;
+// - template, sound, anim, scale, extra and thing id as deltas against
+//   the previous shot in the packet, and left out when unchanged.
+//
+// The shooter's own projectile is fired with the quantized origin and
+// direction (sithFireNet_Prepare), so every machine simulates the same
+// shot bit for bit. The reference position travels in the packet rather
+// than relying on the receiver's copy of the shooter, so a lost or late
+// packet can't shift the shots of later ones.
+//
+// The codec (everything but the engine functions) also builds on its own
+// with SITHFIRENET_STANDALONE; sithFireNet_loopback.c uses that to check
+// the byte savings and the round trip.
+
+#define SITHFIRENET_MAX_QUEUE       (128)
+#define SITHFIRENET_MAX_PACKET      (480)
+#define SITHFIRENET_ORIGIN_SCALE    (4096.0f)
+
+// Spare slot in sithComm_msgFuncs
+#define SITHFIRENET_MSG_ID          (63)
+
+typedef struct sithFireNetEvent
+{
+    int32_t shooterId;          // thing_id
+    int32_t thingId;            // thing_id the projectile gets everywhere
+    int32_t extra;
+    int16_t templateIdx;
+    int16_t soundIdx;           // -1 for none
+    int16_t anim;
+    int16_t scaleFlags;
+    int16_t dirCode[2];         // Octahedral code of dir, as sent
+    float shooterPos[3];        // What origin is quantized against
+    float origin[3];
+    float dir[3];
+    float scale;
+    float deltaSecs;
+} sithFireNetEvent;
+
+void sithFireNet_QuantizeOrigin(const float* ref, float* origin);
+void sithFireNet_QuantizeDir(float* dir, int16_t* code);
+int sithFireNet_Encode(const sithFireNetEvent* events, int numEvents, uint8_t* buf, int bufSize, int* pSize);
+int sithFireNet_Decode(const uint8_t* buf, int size, sithFireNetEvent* events, int maxEvents);
+
+#ifndef SITHFIRENET_STANDALONE
+void sithFireNet_Startup();
+void sithFireNet_Prepare(sithFireNetEvent* event, sithThing* sender, rdVector3* dir, rdVector3* origin);
+void sithFireNet_Queue(sithFireNetEvent* event, sithThing* projectile, sithSound* fireSound, int anim, flex_t scale, int16_t scaleFlags, flex_t deltaSecs, int thingId, int extra);
+void sithFireNet_Flush();
+int sithFireNet_ProcessMsg(sithCogMsg* msg);
+void sithFireNet_Reset();
+#endif
+
+#endif // _SITHFIRENET_H
@@ -0,0 +1,251 @@
+// ================================================================
+// File: sithFireNet_loopback.c
+// Loopback check for the batched fire-projectile messages (sithFireNet)
+//
+// Generates sustained fire from a number of shooters, sends every tick's
+// shots through sithFireNet_Encode/Decode and checks that:
+//
+// - every decoded shot matches what the shooter fired locally (the
+//   quantized origin and direction) bit for bit, along with every other
+//   field;
+// - a projectile stepped from both copies ends in the same place on the
+//   same tick;
+// - the bytes sent stay below one sithDSSThing_SendFireProjectile per
+//   shot.
+//
+// Results are printed as JSON; the exit code is non-zero on a mismatch.
+//
+// Build:
+//   cc -O2 sithFireNet_loopback.c -lm -o sithFireNet_loopback
+//
+// Usage:
+//   sithFireNet_loopback [--shooters N] [--rate SHOTS_PER_SEC]
+//                        [--seconds S] [--hz H] [--seed N]
+//
+// The per-shot size of the old message (SITHFIRENET_OLD_MSG_SIZE) and
+// the per-packet overhead (SITHFIRENET_PACKET_OVERHEAD: message header
+// plus UDP/IP) are what the comparison assumes for the old layout.
+// ================================================================
+
+#define SITHFIRENET_STANDALONE
+#include "sithFireNet.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Thing id, template, sound, anim, 2 vectors, scale, scaleFlags, a9,
+// spawned id, extra
+#define SITHFIRENET_OLD_MSG_SIZE    (4 + 2 + 2 + 2 + 12 + 12 + 4 + 2 + 4 + 4 + 4)
+#define SITHFIRENET_PACKET_OVERHEAD (8 + 28)
+
+#define LOOPBACK_MAX_SHOOTERS       (64)
+#define LOOPBACK_WALL_DIST          (6.0f)
+#define LOOPBACK_BOLT_SPEED         (4.0f)
+
+typedef struct LoopbackShooter
+{
+    float pos[3];
+    float yaw;
+    float fireTimer;
+    int16_t templateIdx;
+    int16_t soundIdx;
+} LoopbackShooter;
+
+static uint32_t loopback_seed = 1;
+
+static float Loopback_Rand()
+{
+    loopback_seed = loopback_seed * 1664525u + 1013904223u;
+    return (float)(loopback_seed >> 8) / 16777216.0f;
+}
+
+// Steps a bolt until it passes the wall plane x = LOOPBACK_WALL_DIST;
+// returns the tick, pos is where it ended
+static int Loopback_Simulate(const sithFireNetEvent* ev, float dt, float* pos)
+{
+    int tick;
+
+    memcpy(pos, ev->origin, sizeof(ev->origin));
+    for (tick = 0; tick < 1000; tick++)
+    {
+        pos[0] += ev->dir[0] * LOOPBACK_BOLT_SPEED * dt;
+        pos[1] += ev->dir[1] * LOOPBACK_BOLT_SPEED * dt;
+        pos[2] += ev->dir[2] * LOOPBACK_BOLT_SPEED * dt;
+        if (fabsf(pos[0] - ev->shooterPos[0]) > LOOPBACK_WALL_DIST)
+            break;
+    }
+    return tick;
+}
+
+static int Loopback_Same(const sithFireNetEvent* a, const sithFireNetEvent* b)
+{
+    return a->shooterId == b->shooterId
+        && a->thingId == b->thingId
+        && a->extra == b->extra
+        && a->templateIdx == b->templateIdx
+        && a->soundIdx == b->soundIdx
+        && a->anim == b->anim
+        && a->scaleFlags == b->scaleFlags
+        && a->dirCode[0] == b->dirCode[0]
+        && a->dirCode[1] == b->dirCode[1]
+        && memcmp(a->shooterPos, b->shooterPos, sizeof(a->shooterPos)) == 0
+        && memcmp(a->origin, b->origin, sizeof(a->origin)) == 0
+        && memcmp(a->dir, b->dir, sizeof(a->dir)) == 0
+        && memcmp(&a->scale, &b->scale, sizeof(a->scale)) == 0
+        && memcmp(&a->deltaSecs, &b->deltaSecs, sizeof(a->deltaSecs)) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    static LoopbackShooter shooters[LOOPBACK_MAX_SHOOTERS];
+    static sithFireNetEvent sent[SITHFIRENET_MAX_QUEUE];
+    static sithFireNetEvent received[SITHFIRENET_MAX_QUEUE];
+    static uint8_t packet[SITHFIRENET_MAX_PACKET];
+    int numShooters = 32;
+    float rate = 20.0f;
+    float seconds = 10.0f;
+    float hz = 50.0f;
+    long shots = 0, packets = 0, newBytes = 0, oldBytes = 0;
+    long mismatches = 0, simMismatches = 0, farOrigins = 0;
+    int nextThingId = 1000;
+    int numTicks, tick, i;
+    float dt;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "--shooters"))
+            numShooters = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--rate"))
+            rate = (float)atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seconds"))
+            seconds = (float)atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--hz"))
+            hz = (float)atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seed"))
+            loopback_seed = (uint32_t)atoi(argv[i + 1]);
+    }
+    if (numShooters < 1)
+        numShooters = 1;
+    if (numShooters > LOOPBACK_MAX_SHOOTERS)
+        numShooters = LOOPBACK_MAX_SHOOTERS;
+
+    dt = 1.0f / hz;
+    numTicks = (int)(seconds * hz);
+
+    for (i = 0; i < numShooters; i++)
+    {
+        shooters[i].pos[0] = Loopback_Rand() * 200.0f - 100.0f;
+        shooters[i].pos[1] = Loopback_Rand() * 200.0f - 100.0f;
+        shooters[i].pos[2] = Loopback_Rand() * 10.0f;
+        shooters[i].yaw = Loopback_Rand() * 6.2831853f;
+        shooters[i].fireTimer = Loopback_Rand() / rate;
+        shooters[i].templateIdx = (int16_t)(10 + (i % 3));
+        shooters[i].soundIdx = (int16_t)(40 + (i % 3));
+    }
+
+    for (tick = 0; tick < numTicks; tick++)
+    {
+        int numSent = 0;
+        int done = 0;
+
+        // Move, aim and fire
+        for (i = 0; i < numShooters; i++)
+        {
+            LoopbackShooter* shooter = &shooters[i];
+
+            shooter->pos[0] += (Loopback_Rand() - 0.5f) * 0.1f;
+            shooter->pos[1] += (Loopback_Rand() - 0.5f) * 0.1f;
+            shooter->yaw += (Loopback_Rand() - 0.5f) * 0.2f;
+
+            shooter->fireTimer -= dt;
+            while (shooter->fireTimer <= 0.0f && numSent < SITHFIRENET_MAX_QUEUE)
+            {
+                sithFireNetEvent* ev = &sent[numSent++];
+                float pitch = (Loopback_Rand() - 0.5f) * 1.2f;
+
+                memset(ev, 0, sizeof(*ev));
+                ev->shooterId = 100 + i;
+                ev->thingId = nextThingId++;
+                ev->templateIdx = shooter->templateIdx;
+                ev->soundIdx = shooter->soundIdx;
+                ev->anim = 2;
+                ev->scale = 1.0f;
+                ev->scaleFlags = 0x20;
+                memcpy(ev->shooterPos, shooter->pos, sizeof(shooter->pos));
+
+                // Fire point a little ahead of the eye; now and then one
+                // far off, as a mounted gun would
+                ev->dir[0] = cosf(shooter->yaw) * cosf(pitch);
+                ev->dir[1] = sinf(shooter->yaw) * cosf(pitch);
+                ev->dir[2] = sinf(pitch);
+                ev->origin[0] = shooter->pos[0] + ev->dir[0] * 0.05f;
+                ev->origin[1] = shooter->pos[1] + ev->dir[1] * 0.05f;
+                ev->origin[2] = shooter->pos[2] + 0.04f;
+                if (Loopback_Rand() < 0.01f)
+                {
+                    ev->origin[2] += 20.0f;
+                    farOrigins++;
+                }
+
+                // What sithFireNet_Prepare does before the local fire
+                sithFireNet_QuantizeOrigin(ev->shooterPos, ev->origin);
+                sithFireNet_QuantizeDir(ev->dir, ev->dirCode);
+
+                shooter->fireTimer += 1.0f / rate;
+            }
+        }
+
+        // One packet per tick (more if it doesn't fit), decoded at once
+        while (done < numSent)
+        {
+            int size, numEncoded, numDecoded;
+
+            numEncoded = sithFireNet_Encode(&sent[done], numSent - done, packet, SITHFIRENET_MAX_PACKET, &size);
+            numDecoded = sithFireNet_Decode(packet, size, received, SITHFIRENET_MAX_QUEUE);
+            if (numDecoded != numEncoded)
+            {
+                printf("{\"error\": \"decoded %d of %d shots\"}\n", numDecoded, numEncoded);
+                return 1;
+            }
+
+            for (i = 0; i < numEncoded; i++)
+            {
+                float localPos[3], remotePos[3];
+                int localTick, remoteTick;
+
+                if (!Loopback_Same(&sent[done + i], &received[i]))
+                    mismatches++;
+
+                localTick = Loopback_Simulate(&sent[done + i], dt, localPos);
+                remoteTick = Loopback_Simulate(&received[i], dt, remotePos);
+                if (localTick != remoteTick || memcmp(localPos, remotePos, sizeof(localPos)) != 0)
+                    simMismatches++;
+            }
+
+            packets++;
+            newBytes += size + SITHFIRENET_PACKET_OVERHEAD;
+            done += numEncoded;
+        }
+
+        shots += numSent;
+        oldBytes += (long)numSent * (SITHFIRENET_OLD_MSG_SIZE + SITHFIRENET_PACKET_OVERHEAD);
+    }
+
+    printf("{\n");
+    printf("  \"shooters\": %d,\n", numShooters);
+    printf("  \"shotsPerSec\": %.1f,\n", rate);
+    printf("  \"ticks\": %d,\n", numTicks);
+    printf("  \"shots\": %ld,\n", shots);
+    printf("  \"farOrigins\": %ld,\n", farOrigins);
+    printf("  \"packets\": %ld,\n", packets);
+    printf("  \"oldBytes\": %ld,\n", oldBytes);
+    printf("  \"newBytes\": %ld,\n", newBytes);
+    printf("  \"bytesPerShotOld\": %.2f,\n", shots ? (double)oldBytes / shots : 0.0);
+    printf("  \"bytesPerShotNew\": %.2f,\n", shots ? (double)newBytes / shots : 0.0);
+    printf("  \"saving\": %.3f,\n", oldBytes ? 1.0 - (double)newBytes / oldBytes : 0.0);
+    printf("  \"fieldMismatches\": %ld,\n", mismatches);
+    printf("  \"simulationMismatches\": %ld\n", simMismatches);
+    printf("}\n");
+
+    return (mismatches || simMismatches || newBytes >= oldBytes) ? 1 : 0;
+}
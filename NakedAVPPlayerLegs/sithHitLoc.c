@@ -0,0 +1,469 @@
+#include "sithHitLoc.h"
+
+#ifndef SITHHITLOC_STANDALONE
+#include "World/sithThing.h"
+#include "Engine/rdThing.h"
+#include "Engine/sithAnimClass.h"
+#include "Gameplay/sithTime.h"
+#include "General/stdMath.h"
+#include "jk.h"
+#endif
+
+#if !defined(SITHHITLOC_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define SITHHITLOC_SSE
+#include <xmmintrin.h>
+#endif
+
+// Room for the last group of four capsules to read past the end
+#define SITHHITLOC_MAX_LANES       (SITHHITLOC_MAX_CAPSULES + 3)
+
+// Capsule radius of the parts that aren't limbs, as a fraction of the
+// thing's collideSize; 0 is SITHHITLOC_RADIUS_SCALE
+static const flex_t sithHitLoc_aRadiusScale[JOINTTYPE_NUM_JOINTS] = {
+    [JOINTTYPE_HEAD] = 0.45,
+    [JOINTTYPE_NECK] = 0.3,
+    [JOINTTYPE_TORSO] = 0.8,
+};
+
+// One puppet's capsules, axis ends and radius in parallel float arrays
+// whatever flex_t is, so the leaf loop can test four at a time with SSE.
+// Capsules [0, split) are under box 1 and [split, numCapsules) under
+// box 2; box 0 holds both.
+typedef struct sithHitLocEntry
+{
+    sithThing* thing;
+    int signature;
+    uint32_t builtMs;
+
+    int numCapsules;
+    int split;
+    rdVector3 boxMin[3];
+    rdVector3 boxMax[3];
+
+    int joint[SITHHITLOC_MAX_LANES];
+    float ax[SITHHITLOC_MAX_LANES];
+    float ay[SITHHITLOC_MAX_LANES];
+    float az[SITHHITLOC_MAX_LANES];
+    float bx[SITHHITLOC_MAX_LANES];
+    float by[SITHHITLOC_MAX_LANES];
+    float bz[SITHHITLOC_MAX_LANES];
+    float radius[SITHHITLOC_MAX_LANES];
+} sithHitLocEntry;
+
+static sithHitLocEntry sithHitLoc_aEntries[SITHHITLOC_MAX_THINGS];
+
+static void sithHitLoc_Swap(sithHitLocEntry* entry, int i, int j)
+{
+    int joint = entry->joint[i];
+    float tmp;
+
+    entry->joint[i] = entry->joint[j];
+    entry->joint[j] = joint;
+    tmp = entry->ax[i]; entry->ax[i] = entry->ax[j]; entry->ax[j] = tmp;
+    tmp = entry->ay[i]; entry->ay[i] = entry->ay[j]; entry->ay[j] = tmp;
+    tmp = entry->az[i]; entry->az[i] = entry->az[j]; entry->az[j] = tmp;
+    tmp = entry->bx[i]; entry->bx[i] = entry->bx[j]; entry->bx[j] = tmp;
+    tmp = entry->by[i]; entry->by[i] = entry->by[j]; entry->by[j] = tmp;
+    tmp = entry->bz[i]; entry->bz[i] = entry->bz[j]; entry->bz[j] = tmp;
+    tmp = entry->radius[i]; entry->radius[i] = entry->radius[j]; entry->radius[j] = tmp;
+}
+
+static void sithHitLoc_Bounds(sithHitLocEntry* entry, int box, int first, int last)
+{
+    rdVector3* boxMin = &entry->boxMin[box];
+    rdVector3* boxMax = &entry->boxMax[box];
+    int i;
+
+    for (i = first; i < last; i++)
+    {
+        flex_t r = entry->radius[i];
+        flex_t minX = (entry->ax[i] < entry->bx[i] ? entry->ax[i] : entry->bx[i]) - r;
+        flex_t minY = (entry->ay[i] < entry->by[i] ? entry->ay[i] : entry->by[i]) - r;
+        flex_t minZ = (entry->az[i] < entry->bz[i] ? entry->az[i] : entry->bz[i]) - r;
+        flex_t maxX = (entry->ax[i] > entry->bx[i] ? entry->ax[i] : entry->bx[i]) + r;
+        flex_t maxY = (entry->ay[i] > entry->by[i] ? entry->ay[i] : entry->by[i]) + r;
+        flex_t maxZ = (entry->az[i] > entry->bz[i] ? entry->az[i] : entry->bz[i]) + r;
+
+        if (i == first)
+        {
+            boxMin->x = minX; boxMin->y = minY; boxMin->z = minZ;
+            boxMax->x = maxX; boxMax->y = maxY; boxMax->z = maxZ;
+            continue;
+        }
+        if (minX < boxMin->x) boxMin->x = minX;
+        if (minY < boxMin->y) boxMin->y = minY;
+        if (minZ < boxMin->z) boxMin->z = minZ;
+        if (maxX > boxMax->x) boxMax->x = maxX;
+        if (maxY > boxMax->y) boxMax->y = maxY;
+        if (maxZ > boxMax->z) boxMax->z = maxZ;
+    }
+}
+
+// Capsules from the hierarchy node matrices as they are this tick, and
+// the two halves split at the middle of the longest side
+static int sithHitLoc_Build(sithHitLocEntry* entry, sithThing* thing)
+{
+    rdModel3* model = thing->rdthing.model3;
+    rdVector3 extent;
+    flex_t mid;
+    int axis, first, last;
+    int i;
+
+    entry->thing = thing;
+    entry->signature = thing->signature;
+    entry->builtMs = sithTime_curMs;
+    entry->numCapsules = 0;
+
+    for (i = 0; i < JOINTTYPE_NUM_JOINTS; i++)
+    {
+        int nodeIdx = thing->animclass->bodypart_to_joint[i];
+        flex_t radiusScale = sithHitLoc_aRadiusScale[i];
+        rdHierarchyNode* node;
+        rdVector3* a;
+        rdVector3* b;
+        int n;
+
+        if (nodeIdx < 0 || nodeIdx >= model->numHierarchyNodes)
+            continue;
+
+        // From the joint to where the part hangs off its parent; a root
+        // joint is a sphere
+        node = &model->hierarchyNodes[nodeIdx];
+        a = &thing->rdthing.hierarchyNodeMatrices[nodeIdx].scale;
+        b = node->parent ? &thing->rdthing.hierarchyNodeMatrices[node->parent->idx].scale : a;
+
+        n = entry->numCapsules++;
+        entry->joint[n] = i;
+        entry->ax[n] = a->x;
+        entry->ay[n] = a->y;
+        entry->az[n] = a->z;
+        entry->bx[n] = b->x;
+        entry->by[n] = b->y;
+        entry->bz[n] = b->z;
+        entry->radius[n] = thing->collideSize * (radiusScale > 0.0 ? radiusScale : SITHHITLOC_RADIUS_SCALE);
+    }
+    if (!entry->numCapsules)
+        return 0;
+
+    sithHitLoc_Bounds(entry, 0, 0, entry->numCapsules);
+    rdVector_Sub3(&extent, &entry->boxMax[0], &entry->boxMin[0]);
+    axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+    mid = (axis == 0 ? entry->boxMin[0].x + entry->boxMax[0].x
+         : axis == 1 ? entry->boxMin[0].y + entry->boxMax[0].y
+         : entry->boxMin[0].z + entry->boxMax[0].z) * 0.5;
+
+    // Partition by capsule middle
+    first = 0;
+    last = entry->numCapsules;
+    while (first < last)
+    {
+        flex_t center = axis == 0 ? entry->ax[first] + entry->bx[first]
+                      : axis == 1 ? entry->ay[first] + entry->by[first]
+                      : entry->az[first] + entry->bz[first];
+
+        if (center * 0.5 < mid)
+            first++;
+        else
+            sithHitLoc_Swap(entry, first, --last);
+    }
+
+    // Everything on one side: halve by count
+    if (first == 0 || first == entry->numCapsules)
+        first = (entry->numCapsules + 1) / 2;
+
+    entry->split = first;
+    sithHitLoc_Bounds(entry, 1, 0, first);
+    sithHitLoc_Bounds(entry, 2, first, entry->numCapsules);
+    if (first == entry->numCapsules)
+    {
+        rdVector_Copy3(&entry->boxMin[2], &entry->boxMin[1]);
+        rdVector_Copy3(&entry->boxMax[2], &entry->boxMax[1]);
+    }
+    return 1;
+}
+
+static sithHitLocEntry* sithHitLoc_Get(sithThing* thing)
+{
+    sithHitLocEntry* oldest = &sithHitLoc_aEntries[0];
+    sithHitLocEntry* entry;
+    int i;
+
+    for (i = 0; i < SITHHITLOC_MAX_THINGS; i++)
+    {
+        entry = &sithHitLoc_aEntries[i];
+        if (entry->thing == thing && entry->signature == thing->signature)
+        {
+            if (entry->builtMs == sithTime_curMs)
+                return entry->numCapsules ? entry : NULL;
+            oldest = entry;
+            break;
+        }
+        if (!entry->thing)
+        {
+            oldest = entry;
+            break;
+        }
+        if (entry->builtMs < oldest->builtMs)
+            oldest = entry;
+    }
+
+    return sithHitLoc_Build(oldest, thing) ? oldest : NULL;
+}
+
+// Slab test; tMin is where the ray enters the box
+static int sithHitLoc_RayBox(rdVector3* origin, rdVector3* invDir, rdVector3* boxMin, rdVector3* boxMax, flex_t* tMin)
+{
+    flex_t tNear = 0.0, tFar = 1e30;
+    flex_t t0, t1, tmp;
+
+    t0 = (boxMin->x - origin->x) * invDir->x;
+    t1 = (boxMax->x - origin->x) * invDir->x;
+    if (t0 > t1) { tmp = t0; t0 = t1; t1 = tmp; }
+    if (t0 > tNear) tNear = t0;
+    if (t1 < tFar) tFar = t1;
+
+    t0 = (boxMin->y - origin->y) * invDir->y;
+    t1 = (boxMax->y - origin->y) * invDir->y;
+    if (t0 > t1) { tmp = t0; t0 = t1; t1 = tmp; }
+    if (t0 > tNear) tNear = t0;
+    if (t1 < tFar) tFar = t1;
+
+    t0 = (boxMin->z - origin->z) * invDir->z;
+    t1 = (boxMax->z - origin->z) * invDir->z;
+    if (t0 > t1) { tmp = t0; t0 = t1; t1 = tmp; }
+    if (t0 > tNear) tNear = t0;
+    if (t1 < tFar) tFar = t1;
+
+    *tMin = tNear;
+    return tNear <= tFar;
+}
+
+// Where a ray from o along unit d enters the sphere at c, -1 if it
+// doesn't; 0 if o is inside
+static flex_t sithHitLoc_RaySphere(rdVector3* o, rdVector3* d, flex_t cx, flex_t cy, flex_t cz, flex_t r)
+{
+    flex_t ox = o->x - cx, oy = o->y - cy, oz = o->z - cz;
+    flex_t b = ox * d->x + oy * d->y + oz * d->z;
+    flex_t c = ox * ox + oy * oy + oz * oz - r * r;
+    flex_t h, t;
+
+    if (c <= 0.0)
+        return 0.0;
+    h = b * b - c;
+    if (b > 0.0 || h < 0.0)
+        return -1.0;
+    t = -b - stdMath_Sqrt(h);
+    return t < 0.0 ? 0.0 : t;
+}
+
+// Where a ray from o along unit d enters capsule i, -1 if it doesn't
+static flex_t sithHitLoc_RayCapsule(sithHitLocEntry* entry, int i, rdVector3* o, rdVector3* d)
+{
+    flex_t r = entry->radius[i];
+    flex_t bax = entry->bx[i] - entry->ax[i];
+    flex_t bay = entry->by[i] - entry->ay[i];
+    flex_t baz = entry->bz[i] - entry->az[i];
+    flex_t oax = o->x - entry->ax[i];
+    flex_t oay = o->y - entry->ay[i];
+    flex_t oaz = o->z - entry->az[i];
+    flex_t baba = bax * bax + bay * bay + baz * baz;
+    flex_t bard = bax * d->x + bay * d->y + baz * d->z;
+    flex_t baoa = bax * oax + bay * oay + baz * oaz;
+    flex_t rdoa = d->x * oax + d->y * oay + d->z * oaz;
+    flex_t oaoa = oax * oax + oay * oay + oaz * oaz;
+    flex_t a, b, c, h, t, y;
+
+    a = baba - bard * bard;
+    if (baba > 0.0 && a > 0.0000001)
+    {
+        // Side of the cylinder, if it's between the ends
+        b = baba * rdoa - baoa * bard;
+        c = baba * oaoa - baoa * baoa - r * r * baba;
+
+        // Starting inside the infinite cylinder: inside the capsule if
+        // between the ends, and otherwise it can only come in through the
+        // end it is past
+        if (c <= 0.0)
+        {
+            if (baoa >= 0.0 && baoa <= baba)
+                return 0.0;
+            if (baoa < 0.0)
+                return sithHitLoc_RaySphere(o, d, entry->ax[i], entry->ay[i], entry->az[i], r);
+            return sithHitLoc_RaySphere(o, d, entry->bx[i], entry->by[i], entry->bz[i], r);
+        }
+        h = b * b - a * c;
+        if (h < 0.0)
+            return -1.0;
+        t = (-b - stdMath_Sqrt(h)) / a;
+        y = baoa + t * bard;
+        if (y > 0.0 && y < baba)
+            return t < 0.0 ? -1.0 : t;
+
+        // Otherwise through the end it is past
+        if (y <= 0.0)
+            return sithHitLoc_RaySphere(o, d, entry->ax[i], entry->ay[i], entry->az[i], r);
+        return sithHitLoc_RaySphere(o, d, entry->bx[i], entry->by[i], entry->bz[i], r);
+    }
+
+    // A sphere, or a ray along the axis: the end it meets first
+    t = sithHitLoc_RaySphere(o, d, entry->ax[i], entry->ay[i], entry->az[i], r);
+    y = sithHitLoc_RaySphere(o, d, entry->bx[i], entry->by[i], entry->bz[i], r);
+    if (t < 0.0 || (y >= 0.0 && y < t))
+        t = y;
+    return t;
+}
+
+static void sithHitLoc_Nearest(flex_t t, int i, flex_t* pBest, int* pBestIdx)
+{
+    if (t >= 0.0 && (*pBestIdx < 0 || t < *pBest))
+    {
+        *pBest = t;
+        *pBestIdx = i;
+    }
+}
+
+#ifdef SITHHITLOC_SSE
+static __m128 sithHitLoc_Select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// sithHitLoc_RayCapsule for capsules [first, last), four at a time.
+// Lanes it special-cases (a sphere, or a ray along the axis) are left to
+// it.
+static void sithHitLoc_Leaves(sithHitLocEntry* entry, int first, int last, rdVector3* o, rdVector3* d, flex_t* pBest, int* pBestIdx)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 minusOne = _mm_set1_ps(-1.0f);
+    const __m128 axisEps = _mm_set1_ps(0.0000001f);
+    const __m128 ox = _mm_set1_ps((float)o->x);
+    const __m128 oy = _mm_set1_ps((float)o->y);
+    const __m128 oz = _mm_set1_ps((float)o->z);
+    const __m128 dx = _mm_set1_ps((float)d->x);
+    const __m128 dy = _mm_set1_ps((float)d->y);
+    const __m128 dz = _mm_set1_ps((float)d->z);
+    float laneT[4];
+    int i, k;
+
+    for (i = first; i < last; i += 4)
+    {
+        __m128 ax = _mm_loadu_ps(&entry->ax[i]);
+        __m128 ay = _mm_loadu_ps(&entry->ay[i]);
+        __m128 az = _mm_loadu_ps(&entry->az[i]);
+        __m128 bx = _mm_loadu_ps(&entry->bx[i]);
+        __m128 by = _mm_loadu_ps(&entry->by[i]);
+        __m128 bz = _mm_loadu_ps(&entry->bz[i]);
+        __m128 rr = _mm_loadu_ps(&entry->radius[i]);
+        __m128 bax = _mm_sub_ps(bx, ax), bay = _mm_sub_ps(by, ay), baz = _mm_sub_ps(bz, az);
+        __m128 oax = _mm_sub_ps(ox, ax), oay = _mm_sub_ps(oy, ay), oaz = _mm_sub_ps(oz, az);
+        __m128 baba, bard, baoa, rdoa, oaoa, a, b, c, h, t, y, res;
+        __m128 endA, sx, sy, sz, bs, cs, hs, ts, bInCylinder, bBetween, bBody, bGeneral;
+        int generalMask;
+
+        rr = _mm_mul_ps(rr, rr);
+        baba = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bax, bax), _mm_mul_ps(bay, bay)), _mm_mul_ps(baz, baz));
+        bard = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bax, dx), _mm_mul_ps(bay, dy)), _mm_mul_ps(baz, dz));
+        baoa = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bax, oax), _mm_mul_ps(bay, oay)), _mm_mul_ps(baz, oaz));
+        rdoa = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, oax), _mm_mul_ps(dy, oay)), _mm_mul_ps(dz, oaz));
+        oaoa = _mm_add_ps(_mm_add_ps(_mm_mul_ps(oax, oax), _mm_mul_ps(oay, oay)), _mm_mul_ps(oaz, oaz));
+
+        a = _mm_sub_ps(baba, _mm_mul_ps(bard, bard));
+        bGeneral = _mm_and_ps(_mm_cmpgt_ps(baba, zero), _mm_cmpgt_ps(a, axisEps));
+        generalMask = _mm_movemask_ps(bGeneral);
+        a = sithHitLoc_Select(bGeneral, a, _mm_set1_ps(1.0f));
+
+        // Side of the cylinder
+        b = _mm_sub_ps(_mm_mul_ps(baba, rdoa), _mm_mul_ps(baoa, bard));
+        c = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(baba, oaoa), _mm_mul_ps(baoa, baoa)), _mm_mul_ps(rr, baba));
+        h = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(a, c));
+        t = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(zero, b), _mm_sqrt_ps(_mm_max_ps(h, zero))), a);
+        y = _mm_add_ps(baoa, _mm_mul_ps(t, bard));
+        bBody = _mm_and_ps(_mm_cmpgt_ps(y, zero), _mm_cmplt_ps(y, baba));
+        bInCylinder = _mm_cmple_ps(c, zero);
+        bBetween = _mm_and_ps(_mm_cmpge_ps(baoa, zero), _mm_cmple_ps(baoa, baba));
+
+        // The end it is past: where it starts if in the cylinder, else
+        // where it meets the cylinder
+        endA = sithHitLoc_Select(bInCylinder, _mm_cmplt_ps(baoa, zero), _mm_cmple_ps(y, zero));
+        sx = _mm_sub_ps(ox, sithHitLoc_Select(endA, ax, bx));
+        sy = _mm_sub_ps(oy, sithHitLoc_Select(endA, ay, by));
+        sz = _mm_sub_ps(oz, sithHitLoc_Select(endA, az, bz));
+        bs = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, dx), _mm_mul_ps(sy, dy)), _mm_mul_ps(sz, dz));
+        cs = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, sx), _mm_mul_ps(sy, sy)), _mm_mul_ps(sz, sz)), rr);
+        hs = _mm_sub_ps(_mm_mul_ps(bs, bs), cs);
+        ts = _mm_max_ps(_mm_sub_ps(_mm_sub_ps(zero, bs), _mm_sqrt_ps(_mm_max_ps(hs, zero))), zero);
+        ts = sithHitLoc_Select(_mm_or_ps(_mm_cmpgt_ps(bs, zero), _mm_cmplt_ps(hs, zero)), minusOne, ts);
+        ts = sithHitLoc_Select(_mm_cmple_ps(cs, zero), zero, ts);
+
+        // In the order sithHitLoc_RayCapsule decides
+        res = sithHitLoc_Select(bBody, sithHitLoc_Select(_mm_cmplt_ps(t, zero), minusOne, t), ts);
+        res = sithHitLoc_Select(_mm_cmplt_ps(h, zero), minusOne, res);
+        res = sithHitLoc_Select(bInCylinder, sithHitLoc_Select(bBetween, zero, ts), res);
+        _mm_storeu_ps(laneT, res);
+
+        for (k = 0; k < 4 && i + k < last; k++)
+        {
+            flex_t lane = (generalMask & (1 << k)) ? laneT[k] : sithHitLoc_RayCapsule(entry, i + k, o, d);
+            sithHitLoc_Nearest(lane, i + k, pBest, pBestIdx);
+        }
+    }
+}
+#else
+static void sithHitLoc_Leaves(sithHitLocEntry* entry, int first, int last, rdVector3* o, rdVector3* d, flex_t* pBest, int* pBestIdx)
+{
+    int i;
+
+    for (i = first; i < last; i++)
+        sithHitLoc_Nearest(sithHitLoc_RayCapsule(entry, i, o, d), i, pBest, pBestIdx);
+}
+#endif
+
+int sithHitLoc_Find(sithThing* thing, rdVector3* origin, rdVector3* dir)
+{
+    sithHitLocEntry* entry;
+    rdVector3 invDir;
+    flex_t tBox[2], tBest = -1.0;
+    int bHitBox[2];
+    int order[2];
+    int best = -1;
+    int k;
+
+    if (!thing->animclass || thing->rdthing.type != RD_THINGTYPE_MODEL || !thing->rdthing.model3 || !thing->rdthing.hierarchyNodeMatrices)
+        return -1;
+
+    entry = sithHitLoc_Get(thing);
+    if (!entry)
+        return -1;
+
+    invDir.x = dir->x != 0.0 ? 1.0 / dir->x : 1e30;
+    invDir.y = dir->y != 0.0 ? 1.0 / dir->y : 1e30;
+    invDir.z = dir->z != 0.0 ? 1.0 / dir->z : 1e30;
+    if (!sithHitLoc_RayBox(origin, &invDir, &entry->boxMin[0], &entry->boxMax[0], &tBox[0]))
+        return -1;
+
+    bHitBox[0] = sithHitLoc_RayBox(origin, &invDir, &entry->boxMin[1], &entry->boxMax[1], &tBox[0]);
+    bHitBox[1] = sithHitLoc_RayBox(origin, &invDir, &entry->boxMin[2], &entry->boxMax[2], &tBox[1]);
+    order[0] = (bHitBox[1] && (!bHitBox[0] || tBox[1] < tBox[0])) ? 1 : 0;
+    order[1] = 1 - order[0];
+
+    // Nearer half first; the other only if it could hold a nearer hit
+    for (k = 0; k < 2; k++)
+    {
+        int half = order[k];
+        int first = half ? entry->split : 0;
+        int last = half ? entry->numCapsules : entry->split;
+
+        if (!bHitBox[half] || (best >= 0 && tBox[half] > tBest))
+            continue;
+
+        sithHitLoc_Leaves(entry, first, last, origin, dir, &tBest, &best);
+    }
+
+    return best >= 0 ? entry->joint[best] : -1;
+}
+
+void sithHitLoc_Reset()
+{
+    // The things belong to the world being unloaded
+    _memset(sithHitLoc_aEntries, 0, sizeof(sithHitLoc_aEntries));
+}
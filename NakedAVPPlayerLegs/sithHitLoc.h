@@ -0,0 +1,35 @@
+#ifndef _SITHHITLOC_H
+#define _SITHHITLOC_H
+
+#ifndef SITHHITLOC_STANDALONE
+#include "types.h"
+#include "globals.h"
+#endif
+
+// Added: ray-vs-capsule hit locations for REGIONAL_DAMAGE.
+//
+// sithPuppet_FindHitLoc works out the body part nearest a hit point by
+// going through the puppet's joints one by one, for every hit. Here each
+// body part of a puppet is a capsule from its joint to the parent joint,
+// as thick as that kind of part, built once per tick from the hierarchy
+// node matrices the first time the puppet is hit, and kept in a
+// two-level tree (the whole body, then two halves). A hit follows the
+// weapon's ray through the boxes and tests only the capsules under the
+// ones it crosses, so a shotgun blast into one puppet builds its
+// capsules once and each pellet costs a few box and capsule tests.
+//
+// sithHitLoc_Find returns -1 when the thing has no puppet or the ray
+// misses every capsule (it hit the collision sphere, not the body);
+// the caller then asks sithPuppet_FindHitLoc as before.
+
+#define SITHHITLOC_MAX_THINGS      (16)
+#define SITHHITLOC_MAX_CAPSULES    (JOINTTYPE_NUM_JOINTS)
+
+// Capsule radius of a limb, as a fraction of the thing's collideSize;
+// the head, neck and torso have their own (sithHitLoc.c)
+#define SITHHITLOC_RADIUS_SCALE    (0.3)
+
+MATH_FUNC int sithHitLoc_Find(sithThing* thing, rdVector3* origin, rdVector3* dir);
+void sithHitLoc_Reset();
+
+#endif // _SITHHITLOC_H
@@ -0,0 +1,413 @@
+// ================================================================
+// File: sithHitLoc_compare.c
+// Brute-force check for the capsule hit locations (sithHitLoc)
+//
+// Poses a crowd of random puppets every tick and fires rays at them
+// through sithHitLoc_Find, several per puppet per tick, as a shotgun
+// would. Every ray is compared with a search over all of the puppet's
+// body parts that shares no code with sithHitLoc.c: each part is the
+// segment from its joint to the parent joint, as thick as its kind of
+// part, and the ray's distance to it is minimized and bisected
+// numerically. Checks that:
+//
+// - a ray that hits gets the part the search hits first (another part
+//   entered at the same distance counts as a tie);
+// - a ray the search finds missing every part gets -1, and so does a
+//   puppet without a model.
+//
+// A part the ray only grazes (passes within COMPARE_GRAZE of its
+// surface) may be hit or missed either way; where that changes the
+// answer the ray is counted as a graze.
+//
+// Results are printed as JSON; the exit code is non-zero on a mismatch.
+//
+// Build (SSE lanes where the target has them, then the scalar loop):
+//   cc -O2 sithHitLoc_compare.c -lm -o sithHitLoc_compare
+//   cc -O2 -DSITHHITLOC_NO_SIMD sithHitLoc_compare.c -lm -o sithHitLoc_compare
+//
+// Usage:
+//   sithHitLoc_compare [--puppets N] [--ticks N] [--rays N] [--seed N]
+// ================================================================
+
+#define SITHHITLOC_STANDALONE
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ================================================================
+// Stand-ins for the engine types and functions sithHitLoc.c uses
+// ================================================================
+
+typedef float flex_t;
+#define MATH_FUNC
+#define _memset memset
+
+// Only the parts sithHitLoc.c names; the rest are limbs
+enum { JOINTTYPE_HEAD = 0, JOINTTYPE_NECK = 1, JOINTTYPE_TORSO = 2, JOINTTYPE_NUM_JOINTS = 10 };
+#define RD_THINGTYPE_MODEL (1)
+
+typedef struct { flex_t x, y, z; } rdVector3;
+typedef struct { rdVector3 rvec, lvec, uvec, scale; } rdMatrix34;
+typedef struct rdHierarchyNode { int idx; struct rdHierarchyNode* parent; } rdHierarchyNode;
+typedef struct { int numHierarchyNodes; rdHierarchyNode* hierarchyNodes; } rdModel3;
+typedef struct { int type; rdModel3* model3; rdMatrix34* hierarchyNodeMatrices; } rdThing;
+typedef struct { int bodypart_to_joint[JOINTTYPE_NUM_JOINTS]; } sithAnimclass;
+typedef struct sithThing
+{
+    int signature;
+    flex_t collideSize;
+    sithAnimclass* animclass;
+    rdThing rdthing;
+} sithThing;
+
+static uint32_t sithTime_curMs = 1;
+
+static flex_t stdMath_Sqrt(flex_t a) { return sqrtf(a); }
+static void rdVector_Copy3(rdVector3* out, const rdVector3* v) { *out = *v; }
+static void rdVector_Sub3(rdVector3* out, const rdVector3* a, const rdVector3* b) { out->x = a->x - b->x; out->y = a->y - b->y; out->z = a->z - b->z; }
+
+#include "sithHitLoc.c"
+
+// ================================================================
+// Puppets and the brute-force search
+// ================================================================
+
+#define COMPARE_MAX_PUPPETS     (64)
+#define COMPARE_NODES           (12)
+#define COMPARE_GRAZE           (1e-4)
+
+typedef struct ComparePuppet
+{
+    sithThing thing;
+    sithAnimclass animclass;
+    rdModel3 model;
+    rdHierarchyNode nodes[COMPARE_NODES];
+    rdMatrix34 matrices[COMPARE_NODES];
+} ComparePuppet;
+
+static ComparePuppet compare_aPuppets[COMPARE_MAX_PUPPETS];
+
+static uint32_t compare_seed = 1;
+
+static float Compare_Rand()
+{
+    compare_seed = compare_seed * 1664525u + 1013904223u;
+    return (float)(compare_seed >> 8) / 16777216.0f;
+}
+
+static float Compare_Range(float lo, float hi)
+{
+    return lo + (hi - lo) * Compare_Rand();
+}
+
+// How thick each kind of part should be
+static double Compare_Radius(const sithThing* thing, int joint)
+{
+    double scale = SITHHITLOC_RADIUS_SCALE;
+
+    if (joint == JOINTTYPE_HEAD)
+        scale = 0.45;
+    else if (joint == JOINTTYPE_NECK)
+        scale = 0.3;
+    else if (joint == JOINTTYPE_TORSO)
+        scale = 0.8;
+    return thing->collideSize * scale;
+}
+
+// Distance from p to the segment ab
+static double Compare_SegmentDist(const double* p, const double* a, const double* b)
+{
+    double ab[3], ap[3], abab = 0.0, abap = 0.0, h, dist = 0.0;
+    int k;
+
+    for (k = 0; k < 3; k++)
+    {
+        ab[k] = b[k] - a[k];
+        ap[k] = p[k] - a[k];
+        abab += ab[k] * ab[k];
+        abap += ab[k] * ap[k];
+    }
+    h = abab > 0.0 ? abap / abab : 0.0;
+    if (h < 0.0)
+        h = 0.0;
+    if (h > 1.0)
+        h = 1.0;
+    for (k = 0; k < 3; k++)
+    {
+        double e = ap[k] - ab[k] * h;
+        dist += e * e;
+    }
+    return sqrt(dist);
+}
+
+static double Compare_Gap(const double* o, const double* d, double t, const double* a, const double* b, double r)
+{
+    double p[3];
+
+    p[0] = o[0] + d[0] * t;
+    p[1] = o[1] + d[1] * t;
+    p[2] = o[2] + d[2] * t;
+    return Compare_SegmentDist(p, a, b) - r;
+}
+
+// Where the ray first comes within r of the segment. The gap is convex
+// along the ray, so its minimum is found by ternary search and the entry
+// by bisection before it. Returns -1 on a miss; *pMinGap is how close
+// the ray gets, at *pMinT.
+static double Compare_Enter(const double* o, const double* d, const double* a, const double* b, double r, double* pMinGap, double* pMinT)
+{
+    double lo = 0.0, hi = 100.0, t;
+    int n;
+
+    if (Compare_Gap(o, d, 0.0, a, b, r) <= 0.0)
+    {
+        *pMinGap = -r;
+        *pMinT = 0.0;
+        return 0.0;
+    }
+    for (n = 0; n < 90; n++)
+    {
+        double m1 = lo + (hi - lo) / 3.0;
+        double m2 = hi - (hi - lo) / 3.0;
+
+        if (Compare_Gap(o, d, m1, a, b, r) < Compare_Gap(o, d, m2, a, b, r))
+            hi = m2;
+        else
+            lo = m1;
+    }
+    t = (lo + hi) * 0.5;
+    *pMinGap = Compare_Gap(o, d, t, a, b, r);
+    *pMinT = t;
+    if (*pMinGap > 0.0)
+        return -1.0;
+
+    lo = 0.0;
+    hi = t;
+    for (n = 0; n < 50; n++)
+    {
+        t = (lo + hi) * 0.5;
+        if (Compare_Gap(o, d, t, a, b, r) > 0.0)
+            lo = t;
+        else
+            hi = t;
+    }
+    return hi;
+}
+
+// Entry distance of every part the puppet has, -1 for parts it doesn't
+// have or the ray misses
+static void Compare_Search(ComparePuppet* puppet, const rdVector3* origin, const rdVector3* dir, double* aEnter, double* aMinGap, double* aMinT)
+{
+    double o[3], d[3];
+    int joint;
+
+    o[0] = origin->x; o[1] = origin->y; o[2] = origin->z;
+    d[0] = dir->x; d[1] = dir->y; d[2] = dir->z;
+
+    for (joint = 0; joint < JOINTTYPE_NUM_JOINTS; joint++)
+    {
+        int nodeIdx = puppet->animclass.bodypart_to_joint[joint];
+        rdHierarchyNode* node;
+        rdVector3* pa;
+        rdVector3* pb;
+        double a[3], b[3];
+
+        aEnter[joint] = -1.0;
+        aMinGap[joint] = 1e30;
+        if (nodeIdx < 0)
+            continue;
+        node = &puppet->nodes[nodeIdx];
+        pa = &puppet->matrices[nodeIdx].scale;
+        pb = node->parent ? &puppet->matrices[node->parent->idx].scale : pa;
+        a[0] = pa->x; a[1] = pa->y; a[2] = pa->z;
+        b[0] = pb->x; b[1] = pb->y; b[2] = pb->z;
+        aEnter[joint] = Compare_Enter(o, d, a, b, Compare_Radius(&puppet->thing, joint), &aMinGap[joint], &aMinT[joint]);
+    }
+}
+
+static void Compare_Pose(ComparePuppet* puppet, const rdVector3* center)
+{
+    int n;
+
+    for (n = 0; n < COMPARE_NODES; n++)
+    {
+        puppet->matrices[n].scale.x = center->x + Compare_Range(-0.05f, 0.05f);
+        puppet->matrices[n].scale.y = center->y + Compare_Range(-0.05f, 0.05f);
+        puppet->matrices[n].scale.z = center->z + Compare_Range(0.0f, 0.2f);
+    }
+}
+
+static void Compare_NewPuppet(ComparePuppet* puppet, int signature)
+{
+    int n;
+
+    memset(puppet, 0, sizeof(*puppet));
+    puppet->thing.signature = signature;
+    puppet->thing.collideSize = Compare_Range(0.04f, 0.08f);
+    puppet->thing.animclass = &puppet->animclass;
+    puppet->thing.rdthing.type = RD_THINGTYPE_MODEL;
+    puppet->thing.rdthing.model3 = &puppet->model;
+    puppet->thing.rdthing.hierarchyNodeMatrices = puppet->matrices;
+    puppet->model.numHierarchyNodes = COMPARE_NODES;
+    puppet->model.hierarchyNodes = puppet->nodes;
+
+    for (n = 0; n < COMPARE_NODES; n++)
+    {
+        puppet->nodes[n].idx = n;
+        puppet->nodes[n].parent = n ? &puppet->nodes[(int)(Compare_Rand() * n)] : NULL;
+    }
+    for (n = 0; n < JOINTTYPE_NUM_JOINTS; n++)
+        puppet->animclass.bodypart_to_joint[n] = Compare_Rand() < 0.2f ? -1 : (int)(Compare_Rand() * COMPARE_NODES);
+}
+
+int main(int argc, char** argv)
+{
+    static rdVector3 centers[COMPARE_MAX_PUPPETS];
+    int numPuppets = 24;
+    int numTicks = 200;
+    int numRays = 20;
+    long rays = 0, hits = 0, misses = 0, ties = 0, grazes = 0, mismatches = 0;
+    int tick, i, k;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "--puppets"))
+            numPuppets = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--ticks"))
+            numTicks = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--rays"))
+            numRays = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seed"))
+            compare_seed = (uint32_t)atoi(argv[i + 1]);
+    }
+    if (numPuppets < 1)
+        numPuppets = 1;
+    if (numPuppets > COMPARE_MAX_PUPPETS)
+        numPuppets = COMPARE_MAX_PUPPETS;
+
+    for (i = 0; i < numPuppets; i++)
+    {
+        centers[i].x = Compare_Range(-10.0f, 10.0f);
+        centers[i].y = Compare_Range(-10.0f, 10.0f);
+        centers[i].z = 0.0f;
+        Compare_NewPuppet(&compare_aPuppets[i], i + 1);
+    }
+
+    for (tick = 0; tick < numTicks; tick++)
+    {
+        sithTime_curMs += 20;
+
+        // Every puppet moves every tick; now and then one dies and its
+        // slot is reused by another
+        for (i = 0; i < numPuppets; i++)
+        {
+            if (Compare_Rand() < 0.02f)
+                Compare_NewPuppet(&compare_aPuppets[i], compare_aPuppets[i].thing.signature + COMPARE_MAX_PUPPETS);
+            Compare_Pose(&compare_aPuppets[i], &centers[i]);
+        }
+
+        for (i = 0; i < numPuppets; i++)
+        {
+            ComparePuppet* puppet = &compare_aPuppets[i];
+            rdVector3 origin;
+            float yaw = Compare_Range(0.0f, 6.2831853f);
+
+            // A shooter somewhere around it and a blast of rays from
+            // there, or a projectile that is already in its collision
+            // sphere when it hits, and may be inside a part
+            if (Compare_Rand() < 0.2f)
+            {
+                origin.x = centers[i].x + Compare_Range(-0.06f, 0.06f);
+                origin.y = centers[i].y + Compare_Range(-0.06f, 0.06f);
+                origin.z = centers[i].z + Compare_Range(0.0f, 0.2f);
+            }
+            else
+            {
+                origin.x = centers[i].x + cosf(yaw) * Compare_Range(0.5f, 3.0f);
+                origin.y = centers[i].y + sinf(yaw) * Compare_Range(0.5f, 3.0f);
+                origin.z = Compare_Range(-0.2f, 0.4f);
+            }
+
+            for (k = 0; k < numRays; k++)
+            {
+                double aEnter[JOINTTYPE_NUM_JOINTS], aMinGap[JOINTTYPE_NUM_JOINTS], aMinT[JOINTTYPE_NUM_JOINTS];
+                double tBest = -1.0;
+                rdVector3 target, dir;
+                float len;
+                int got, want = -1, joint;
+
+                target.x = centers[i].x + Compare_Range(-0.1f, 0.1f);
+                target.y = centers[i].y + Compare_Range(-0.1f, 0.1f);
+                target.z = centers[i].z + Compare_Range(-0.05f, 0.25f);
+                rdVector_Sub3(&dir, &target, &origin);
+                len = sqrtf(dir.x*dir.x + dir.y*dir.y + dir.z*dir.z);
+                dir.x /= len;
+                dir.y /= len;
+                dir.z /= len;
+
+                got = sithHitLoc_Find(&puppet->thing, &origin, &dir);
+                Compare_Search(puppet, &origin, &dir, aEnter, aMinGap, aMinT);
+
+                // Nearest part the ray clearly enters
+                for (joint = 0; joint < JOINTTYPE_NUM_JOINTS; joint++)
+                {
+                    if (aMinGap[joint] < -COMPARE_GRAZE && (want < 0 || aEnter[joint] < tBest))
+                    {
+                        tBest = aEnter[joint];
+                        want = joint;
+                    }
+                }
+
+                rays++;
+                if (want < 0)
+                    misses++;
+                else
+                    hits++;
+                if (got == want)
+                    continue;
+
+                // Where a grazing ray enters a part is ill-conditioned: it
+                // may be anywhere the ray is within COMPARE_GRAZE of it
+                if (got >= 0 && fabs(aMinGap[got]) <= COMPARE_GRAZE
+                    && (want < 0
+                        || (aEnter[got] >= 0.0 && aEnter[got] <= tBest + 1e-4)
+                        || aMinT[got] - sqrt(2.0 * Compare_Radius(&puppet->thing, got) * COMPARE_GRAZE) <= tBest + 1e-4))
+                    grazes++;
+                else if (got < 0 && want >= 0 && fabs(aMinGap[want]) <= 2.0 * COMPARE_GRAZE)
+                    grazes++;
+                else if (got >= 0 && want >= 0 && aEnter[got] >= 0.0 && fabs(aEnter[got] - tBest) < 1e-4)
+                    ties++;
+                else
+                    mismatches++;
+            }
+        }
+    }
+
+    // No model: nothing to find
+    compare_aPuppets[0].thing.rdthing.model3 = NULL;
+    {
+        rdVector3 origin = {0.0f, 0.0f, 0.0f}, dir = {1.0f, 0.0f, 0.0f};
+        mismatches += sithHitLoc_Find(&compare_aPuppets[0].thing, &origin, &dir) != -1;
+    }
+
+    printf("{\n");
+#ifdef SITHHITLOC_SSE
+    printf("  \"lanes\": \"sse\",\n");
+#else
+    printf("  \"lanes\": \"scalar\",\n");
+#endif
+    printf("  \"puppets\": %d,\n", numPuppets);
+    printf("  \"ticks\": %d,\n", numTicks);
+    printf("  \"rays\": %ld,\n", rays);
+    printf("  \"hits\": %ld,\n", hits);
+    printf("  \"misses\": %ld,\n", misses);
+    printf("  \"ties\": %ld,\n", ties);
+    printf("  \"grazes\": %ld,\n", grazes);
+    printf("  \"mismatches\": %ld\n", mismatches);
+    printf("}\n");
+
+    return mismatches ? 1 : 0;
+}
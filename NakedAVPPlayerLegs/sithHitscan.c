@@ -0,0 +1,464 @@
+#include "sithHitscan.h"
+
+#ifndef SITHHITSCAN_STANDALONE
+#include "World/sithThing.h"
+#include "World/sithSector.h"
+#include "World/sithSurface.h"
+#include "World/sithWorld.h"
+#include "Engine/sithCollision.h"
+#include "General/stdMath.h"
+#include "jk.h"
+
+#include "sithWeapon.h"
+#endif
+
+#if !defined(SITHHITSCAN_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define SITHHITSCAN_SSE
+#include <xmmintrin.h>
+#endif
+
+// Rays of one batch, one lane per weapon. The lanes are float arrays
+// whatever flex_t is, so the per-candidate loops can take four rays at a
+// time with SSE; SITHHITSCAN_MAX_RAYS is a multiple of four, so the last
+// group never reads past the arrays.
+typedef struct sithHitscanBatch
+{
+    sithThing* shooter;
+    sithSector* sector;
+    rdVector3 origin;
+    int numRays;
+    sithThing* weapons[SITHHITSCAN_MAX_RAYS];
+
+    float dirX[SITHHITSCAN_MAX_RAYS];
+    float dirY[SITHHITSCAN_MAX_RAYS];
+    float dirZ[SITHHITSCAN_MAX_RAYS];
+    float moveSize[SITHHITSCAN_MAX_RAYS];
+    float range[SITHHITSCAN_MAX_RAYS];      // Nearest hit so far, weapon range if none
+    int bPerRay[SITHHITSCAN_MAX_RAYS];      // Reaches a face-collide thing: leave to sithWeapon_sub_4D35E0
+
+    // Scratch for one candidate
+    float laneDist[SITHHITSCAN_MAX_RAYS];
+
+    // Nearest hit of each ray (hitType 0 = none)
+    sithCollisionSearchEntry hits[SITHHITSCAN_MAX_RAYS];
+    sithSector* hitSectors[SITHHITSCAN_MAX_RAYS];
+} sithHitscanBatch;
+
+static sithHitscanBatch sithHitscan_batch;
+
+// Sectors reached by the current flush (visit queue and visited set)
+static sithSector* sithHitscan_aSectors[SITHHITSCAN_MAX_SECTORS];
+static int sithHitscan_numSectors;
+
+static int sithHitscan_CanBatch(sithThing* weapon)
+{
+    if (!weapon->sector)
+        return 0;
+
+    // Trails are laid sector by sector along the ray; keep the old path
+    if ((weapon->weaponParams.typeflags & SITH_WF_OBJECT_TRAIL) && weapon->weaponParams.trailThing)
+        return 0;
+
+    return 1;
+}
+
+static int sithHitscan_SameShot(sithThing* weapon, sithThing* shooter)
+{
+    sithHitscanBatch* batch = &sithHitscan_batch;
+
+    return shooter == batch->shooter
+        && weapon->sector == batch->sector
+        && weapon->position.x == batch->origin.x
+        && weapon->position.y == batch->origin.y
+        && weapon->position.z == batch->origin.z;
+}
+
+int sithHitscan_Queue(sithThing* weapon)
+{
+    sithHitscanBatch* batch = &sithHitscan_batch;
+    sithThing* shooter;
+    int i;
+
+    if (!sithHitscan_CanBatch(weapon))
+        return 0;
+
+    shooter = sithThing_GetParent(weapon);
+
+    if (batch->numRays)
+    {
+        if (batch->numRays == SITHHITSCAN_MAX_RAYS || !sithHitscan_SameShot(weapon, shooter))
+            sithHitscan_Flush();
+    }
+
+    // Ticked again before a flush: sithWeapon_TickEnd is not being called
+    for (i = 0; i < batch->numRays; i++)
+    {
+        if (batch->weapons[i] == weapon)
+        {
+            sithHitscan_Flush();
+            return 1;
+        }
+    }
+
+    if (!batch->numRays)
+    {
+        batch->shooter = shooter;
+        batch->sector = weapon->sector;
+        rdVector_Copy3(&batch->origin, &weapon->position);
+    }
+
+    i = batch->numRays++;
+    batch->weapons[i] = weapon;
+    batch->dirX[i] = weapon->lookOrientation.lvec.x;
+    batch->dirY[i] = weapon->lookOrientation.lvec.y;
+    batch->dirZ[i] = weapon->lookOrientation.lvec.z;
+    batch->moveSize[i] = weapon->moveSize;
+    batch->range[i] = weapon->weaponParams.range;
+    batch->bPerRay[i] = 0;
+    batch->hits[i].hitType = 0;
+    batch->hitSectors[i] = NULL;
+
+    return 1;
+}
+
+void sithHitscan_Reset()
+{
+    // The queued weapons belong to the world being unloaded
+    sithHitscan_batch.numRays = 0;
+    sithHitscan_numSectors = 0;
+}
+
+static void sithHitscan_AddSector(sithSector* sector)
+{
+    int i;
+
+    for (i = 0; i < sithHitscan_numSectors; i++)
+    {
+        if (sithHitscan_aSectors[i] == sector)
+            return;
+    }
+
+    // Out of room: rays past here only see what was reached so far
+    if (sithHitscan_numSectors < SITHHITSCAN_MAX_SECTORS)
+        sithHitscan_aSectors[sithHitscan_numSectors++] = sector;
+}
+
+static int sithHitscan_CanHit(sithThing* thing)
+{
+    sithHitscanBatch* batch = &sithHitscan_batch;
+    int i;
+
+    if (thing->type == SITH_THING_FREE || thing->collide == SITH_COLLIDE_NONE)
+        return 0;
+    if (thing->thingflags & (SITH_TF_DISABLED | SITH_TF_WILLBEREMOVED))
+        return 0;
+    if (thing == batch->shooter)
+        return 0;
+    if (!sithCollision_collisionHandlers[SITH_THING_WEAPON * 12 + thing->type].handler)
+        return 0;
+
+    // Pellets of the same blast
+    if (thing->type == SITH_THING_WEAPON)
+    {
+        for (i = 0; i < batch->numRays; i++)
+        {
+            if (batch->weapons[i] == thing)
+                return 0;
+        }
+    }
+    return 1;
+}
+
+// Distance along every ray to where it enters the sphere at c (relative
+// to the origin), or a value past the ray's range when it misses
+static void sithHitscan_SphereLanes(float cx, float cy, float cz, float collideSize)
+{
+    sithHitscanBatch* batch = &sithHitscan_batch;
+    float cc = cx*cx + cy*cy + cz*cz;
+    int i;
+
+#ifdef SITHHITSCAN_SSE
+    __m128 vcx = _mm_set1_ps(cx);
+    __m128 vcy = _mm_set1_ps(cy);
+    __m128 vcz = _mm_set1_ps(cz);
+    __m128 vcc = _mm_set1_ps(cc);
+    __m128 vsize = _mm_set1_ps(collideSize);
+    __m128 zero = _mm_setzero_ps();
+    __m128 one = _mm_set1_ps(1.0f);
+
+    for (i = 0; i < batch->numRays; i += 4)
+    {
+        __m128 radius = _mm_add_ps(vsize, _mm_loadu_ps(&batch->moveSize[i]));
+        __m128 along = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vcx, _mm_loadu_ps(&batch->dirX[i])),
+                                             _mm_mul_ps(vcy, _mm_loadu_ps(&batch->dirY[i]))),
+                                  _mm_mul_ps(vcz, _mm_loadu_ps(&batch->dirZ[i])));
+        __m128 inside = _mm_sub_ps(_mm_mul_ps(radius, radius), _mm_sub_ps(vcc, _mm_mul_ps(along, along)));
+        __m128 enter = _mm_max_ps(_mm_sub_ps(along, _mm_sqrt_ps(_mm_max_ps(inside, zero))), zero);
+        __m128 hit = _mm_and_ps(_mm_cmpge_ps(inside, zero), _mm_cmpge_ps(_mm_add_ps(along, radius), zero));
+        __m128 miss = _mm_add_ps(_mm_loadu_ps(&batch->range[i]), one);
+
+        _mm_storeu_ps(&batch->laneDist[i], _mm_or_ps(_mm_and_ps(hit, enter), _mm_andnot_ps(hit, miss)));
+    }
+#else
+    for (i = 0; i < batch->numRays; i++)
+    {
+        float radius = collideSize + batch->moveSize[i];
+        float along = cx*batch->dirX[i] + cy*batch->dirY[i] + cz*batch->dirZ[i];
+        float inside = radius*radius - (cc - along*along);
+        float enter = along - stdMath_Sqrt(inside > 0.0f ? inside : 0.0f);
+
+        batch->laneDist[i] = (inside >= 0.0f && along + radius >= 0.0f) ? (enter > 0.0f ? enter : 0.0f) : batch->range[i] + 1.0f;
+    }
+#endif
+}
+
+// Every ray against the collision sphere of each thing in the sector.
+// Things that collide by their faces (doors, elevators) only get the
+// sphere as a bound: a ray that reaches it is resolved on its own by
+// sithWeapon_sub_4D35E0, which tests the faces.
+static void sithHitscan_TestThings(sithSector* sector)
+{
+    sithHitscanBatch* batch = &sithHitscan_batch;
+    sithThing* thing;
+    int numRays = batch->numRays;
+    int i;
+
+    for (thing = sector->thingsList; thing; thing = thing->nextThing)
+    {
+        if (!sithHitscan_CanHit(thing))
+            continue;
+
+        sithHitscan_SphereLanes(thing->position.x - batch->origin.x,
+                                thing->position.y - batch->origin.y,
+                                thing->position.z - batch->origin.z,
+                                thing->collideSize);
+
+        for (i = 0; i < numRays; i++)
+        {
+            sithCollisionSearchEntry* hit;
+            flex_t dist = batch->laneDist[i];
+            rdVector3 hitPos;
+
+            if (dist >= batch->range[i])
+                continue;
+
+            if (thing->collide == SITH_COLLIDE_FACE)
+            {
+                batch->bPerRay[i] = 1;
+                continue;
+            }
+
+            hit = &batch->hits[i];
+            hit->hitType = SITHCOLLISION_THING;
+            hit->receiver = thing;
+            hit->surface = NULL;
+            hit->distance = dist;
+
+            hitPos.x = batch->origin.x + batch->dirX[i] * dist;
+            hitPos.y = batch->origin.y + batch->dirY[i] * dist;
+            hitPos.z = batch->origin.z + batch->dirZ[i] * dist;
+            rdVector_Sub3(&hit->hitNorm, &hitPos, &thing->position);
+            rdVector_Normalize3Acc(&hit->hitNorm);
+
+            batch->range[i] = dist;
+            batch->hitSectors[i] = sector;
+        }
+    }
+}
+
+// Distance along every ray to where its moveSize sphere (its center for
+// a passable adjoin) touches a plane the origin is in front of, or a
+// value past the ray's range when the ray runs away from the plane
+static void sithHitscan_PlaneLanes(rdVector3* normal, float planeDist, int passable)
+{
+    sithHitscanBatch* batch = &sithHitscan_batch;
+    float nx = normal->x, ny = normal->y, nz = normal->z;
+    int i;
+
+#ifdef SITHHITSCAN_SSE
+    __m128 vnx = _mm_set1_ps(nx);
+    __m128 vny = _mm_set1_ps(ny);
+    __m128 vnz = _mm_set1_ps(nz);
+    __m128 vdist = _mm_set1_ps(planeDist);
+    __m128 zero = _mm_setzero_ps();
+    __m128 one = _mm_set1_ps(1.0f);
+
+    for (i = 0; i < batch->numRays; i += 4)
+    {
+        __m128 facing = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vnx, _mm_loadu_ps(&batch->dirX[i])),
+                                              _mm_mul_ps(vny, _mm_loadu_ps(&batch->dirY[i]))),
+                                   _mm_mul_ps(vnz, _mm_loadu_ps(&batch->dirZ[i])));
+        __m128 offset = passable ? vdist : _mm_add_ps(vdist, _mm_loadu_ps(&batch->moveSize[i]));
+        __m128 hit = _mm_cmplt_ps(facing, zero);
+        __m128 touch = _mm_max_ps(_mm_div_ps(offset, _mm_or_ps(_mm_and_ps(hit, facing), _mm_andnot_ps(hit, one))), zero);
+        __m128 miss = _mm_add_ps(_mm_loadu_ps(&batch->range[i]), one);
+
+        _mm_storeu_ps(&batch->laneDist[i], _mm_or_ps(_mm_and_ps(hit, touch), _mm_andnot_ps(hit, miss)));
+    }
+#else
+    for (i = 0; i < batch->numRays; i++)
+    {
+        float facing = nx*batch->dirX[i] + ny*batch->dirY[i] + nz*batch->dirZ[i];
+        float touch = batch->range[i] + 1.0f;
+
+        if (facing < 0.0f)
+        {
+            touch = (planeDist + (passable ? 0.0f : batch->moveSize[i])) / facing;
+            if (touch < 0.0f)
+                touch = 0.0f;
+        }
+        batch->laneDist[i] = touch;
+    }
+#endif
+}
+
+// Point on the face plane inside the (convex) face
+static int sithHitscan_InsideFace(rdFace* face, rdVector3* point)
+{
+    rdVector3* vertices = sithWorld_pCurrentWorld->vertices;
+    int sign = 0;
+    int i;
+
+    for (i = 0; i < face->numVertices; i++)
+    {
+        rdVector3* a = &vertices[face->vertexPosIdx[i]];
+        rdVector3* b = &vertices[face->vertexPosIdx[(i + 1) % face->numVertices]];
+        rdVector3 edge, toPoint, cross;
+        flex_t side;
+
+        rdVector_Sub3(&edge, b, a);
+        rdVector_Sub3(&toPoint, point, a);
+        rdVector_Cross3(&cross, &edge, &toPoint);
+        side = rdVector_Dot3(&cross, &face->normal);
+
+        if (side > 0.0)
+        {
+            if (sign < 0)
+                return 0;
+            sign = 1;
+        }
+        else if (side < 0.0)
+        {
+            if (sign > 0)
+                return 0;
+            sign = -1;
+        }
+    }
+    return 1;
+}
+
+// Every ray against the surfaces of the sector. Solid surfaces are hits
+// where the weapon's moveSize sphere first touches them, as in the
+// per-ray sweep; passable adjoins a ray's center crosses before its
+// nearest hit add the sector behind them to the walk.
+static void sithHitscan_TestSurfaces(sithSector* sector)
+{
+    sithHitscanBatch* batch = &sithHitscan_batch;
+    int numRays = batch->numRays;
+    int s, i;
+
+    for (s = 0; s < sector->numSurfaces; s++)
+    {
+        sithSurface* surface = &sector->surfaces[s];
+        rdFace* face = &surface->surfaceInfo.face;
+        rdVector3* normal = &face->normal;
+        rdVector3* v0 = &sithWorld_pCurrentWorld->vertices[face->vertexPosIdx[0]];
+        int passable = surface->adjoin && (surface->adjoin->flags & SITH_ADJOIN_MOVE);
+        flex_t planeDist;
+
+        // Signed distance from the origin to the plane (negative in front);
+        // no ray can reach the front face from behind it
+        planeDist = normal->x * (v0->x - batch->origin.x)
+                  + normal->y * (v0->y - batch->origin.y)
+                  + normal->z * (v0->z - batch->origin.z);
+        if (planeDist > 0.0)
+            continue;
+
+        sithHitscan_PlaneLanes(normal, planeDist, passable);
+
+        for (i = 0; i < numRays; i++)
+        {
+            sithCollisionSearchEntry* hit;
+            flex_t dist = batch->laneDist[i];
+            rdVector3 point;
+
+            if (dist >= batch->range[i])
+                continue;
+
+            // Where the sphere touches the plane
+            point.x = batch->origin.x + batch->dirX[i] * dist;
+            point.y = batch->origin.y + batch->dirY[i] * dist;
+            point.z = batch->origin.z + batch->dirZ[i] * dist;
+            if (!passable)
+                rdVector_MultAcc3(&point, normal, -batch->moveSize[i]);
+            if (!sithHitscan_InsideFace(face, &point))
+                continue;
+
+            if (passable)
+            {
+                sithHitscan_AddSector(surface->adjoin->sector);
+                continue;
+            }
+
+            hit = &batch->hits[i];
+            hit->hitType = SITHCOLLISION_WORLD;
+            hit->receiver = NULL;
+            hit->surface = surface;
+            hit->distance = dist;
+            rdVector_Copy3(&hit->hitNorm, normal);
+
+            batch->range[i] = dist;
+            batch->hitSectors[i] = sector;
+        }
+    }
+}
+
+void sithHitscan_Flush()
+{
+    sithHitscanBatch* batch = &sithHitscan_batch;
+    int numRays = batch->numRays;
+    int i;
+
+    if (!numRays)
+        return;
+
+    // One walk for the whole batch; sectors are appended as rays cross
+    // into them, so the list doubles as the visit queue
+    sithHitscan_numSectors = 0;
+    sithHitscan_AddSector(batch->sector);
+
+    for (i = 0; i < sithHitscan_numSectors; i++)
+    {
+        sithSector* sector = sithHitscan_aSectors[i];
+
+        sithHitscan_TestThings(sector);
+        sithHitscan_TestSurfaces(sector);
+    }
+
+    for (i = 0; i < numRays; i++)
+    {
+        sithThing* weapon = batch->weapons[i];
+        sithCollisionSearchEntry* hit = &batch->hits[i];
+        rdVector3 dir;
+
+        if (batch->bPerRay[i])
+        {
+            // Destroys the weapon itself
+            sithWeapon_sub_4D35E0(weapon);
+            continue;
+        }
+
+        // An earlier pellet of the blast destroyed what this one hit
+        if ((hit->hitType & SITHCOLLISION_THING) && (hit->receiver->thingflags & SITH_TF_WILLBEREMOVED))
+            hit->hitType = 0;
+
+        if (hit->hitType)
+        {
+            rdVector_Copy3(&dir, &weapon->lookOrientation.lvec);
+            sithWeapon_InstantImpactHit(weapon, batch->hitSectors[i], hit, &dir);
+        }
+        sithThing_Destroy(weapon);
+    }
+
+    batch->numRays = 0;
+}
@@ -0,0 +1,37 @@
+#ifndef _SITHHITSCAN_H
+#define _SITHHITSCAN_H
+
+#ifndef SITHHITSCAN_STANDALONE
+#include "types.h"
+#include "globals.h"
+#endif
+
+// Added: batched hitscan for instant-impact weapons.
+//
+// Every ray one shooter fires from one spot in a tick (a shotgun blast,
+// a repeater burst) is queued instead of running its own
+// sithCollision_SearchRadiusForThings. The batch is resolved with a
+// single walk of the sector/adjoin graph: each thing and surface met on
+// the way is tested against every ray, then damage, decay and explosions
+// are applied per ray with sithWeapon_InstantImpactHit. A ray that
+// reaches a thing colliding by its faces (a door, an elevator) is left to
+// the per-ray search, which tests the faces rather than the sphere.
+//
+// The batch is flushed when a weapon from another shooter or spot is
+// queued, when it is full, and by sithWeapon_TickEnd() after all things
+// have ticked.
+//
+// The ray-vs-sphere and ray-vs-plane loops take four rays at a time with
+// SSE where the target has it, and fall back to scalar loops elsewhere
+// or with SITHHITSCAN_NO_SIMD. sithHitscan_compare.c builds this file
+// on its own (SITHHITSCAN_STANDALONE) and checks both against a
+// brute-force search per ray.
+
+#define SITHHITSCAN_MAX_RAYS    (32)
+#define SITHHITSCAN_MAX_SECTORS (128)
+
+MATH_FUNC int sithHitscan_Queue(sithThing* weapon);
+MATH_FUNC void sithHitscan_Flush();
+void sithHitscan_Reset();
+
+#endif // _SITHHITSCAN_H
@@ -0,0 +1,566 @@
+// ================================================================
+// File: sithHitscan_compare.c
+// Brute-force check for the batched hitscan (sithHitscan)
+//
+// Builds a corridor of box sectors joined by adjoins, scatters things in
+// it and fires blasts of rays from random spots through sithHitscan.
+// Every ray's result is compared with a brute-force search over every
+// thing and every solid surface of the world:
+//
+// - a ray that hits must hit the same thing or surface at the same
+//   distance, with the weapon's moveSize applied (another one at the
+//   same distance, such as the edge two walls share, counts as a tie);
+// - a ray whose nearest hit is a face-collide thing must have been left
+//   to the per-ray search (sithWeapon_sub_4D35E0). A ray that reaches one
+//   behind its nearest hit may be left to it too; that is counted as
+//   perRayExtra, since the per-ray search then finds the same hit.
+//
+// Results are printed as JSON; the exit code is non-zero on a mismatch.
+//
+// Build (SSE lanes where the target has them, then the scalar loops):
+//   cc -O2 sithHitscan_compare.c -lm -o sithHitscan_compare
+//   cc -O2 -DSITHHITSCAN_NO_SIMD sithHitscan_compare.c -lm -o sithHitscan_compare
+//
+// Usage:
+//   sithHitscan_compare [--blasts N] [--sectors N] [--things N] [--seed N]
+// ================================================================
+
+#define SITHHITSCAN_STANDALONE
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ================================================================
+// Stand-ins for the engine types and functions sithHitscan.c uses
+// ================================================================
+
+typedef float flex_t;
+#define MATH_FUNC
+
+typedef struct { flex_t x, y, z; } rdVector3;
+typedef struct { rdVector3 rvec, lvec, uvec, scale; } rdMatrix34;
+typedef struct { int numVertices; int* vertexPosIdx; rdVector3 normal; } rdFace;
+typedef struct sithSector sithSector;
+typedef struct sithThing sithThing;
+typedef struct { int flags; sithSector* sector; } sithAdjoin;
+typedef struct { rdFace face; } sithSurfaceInfo;
+typedef struct sithSurface { sithAdjoin* adjoin; sithSurfaceInfo surfaceInfo; } sithSurface;
+struct sithSector { int numSurfaces; sithSurface* surfaces; sithThing* thingsList; };
+typedef struct { int typeflags; flex_t range; sithThing* trailThing; } sithWeaponParams;
+struct sithThing
+{
+    int type;
+    int collide;
+    int thingflags;
+    sithSector* sector;
+    sithThing* nextThing;
+    rdVector3 position;
+    rdMatrix34 lookOrientation;
+    flex_t moveSize;
+    flex_t collideSize;
+    sithWeaponParams weaponParams;
+};
+typedef struct { int hitType; sithThing* receiver; sithSurface* surface; rdVector3 hitNorm; flex_t distance; } sithCollisionSearchEntry;
+typedef struct { void* handler; } sithCollisionEntry;
+typedef struct { rdVector3* vertices; } sithWorld;
+
+enum { SITH_THING_FREE = 0, SITH_THING_ACTOR = 2, SITH_THING_WEAPON = 3 };
+
+#define SITH_COLLIDE_NONE       (0)
+#define SITH_COLLIDE_SPHERE     (1)
+#define SITH_COLLIDE_FACE       (3)
+#define SITH_TF_DISABLED        (0x1)
+#define SITH_TF_WILLBEREMOVED   (0x2)
+#define SITH_ADJOIN_MOVE        (0x2)
+#define SITH_WF_OBJECT_TRAIL    (0x4)
+#define SITHCOLLISION_THING     (0x1)
+#define SITHCOLLISION_WORLD     (0x2)
+
+static sithCollisionEntry sithCollision_collisionHandlers[144];
+static sithWorld compare_world;
+static sithWorld* sithWorld_pCurrentWorld = &compare_world;
+
+static void rdVector_Copy3(rdVector3* out, const rdVector3* v) { *out = *v; }
+static void rdVector_Sub3(rdVector3* out, const rdVector3* a, const rdVector3* b) { out->x = a->x - b->x; out->y = a->y - b->y; out->z = a->z - b->z; }
+static flex_t rdVector_Dot3(const rdVector3* a, const rdVector3* b) { return a->x*b->x + a->y*b->y + a->z*b->z; }
+static void rdVector_MultAcc3(rdVector3* out, const rdVector3* v, flex_t scale) { out->x += v->x*scale; out->y += v->y*scale; out->z += v->z*scale; }
+static flex_t stdMath_Sqrt(flex_t a) { return sqrtf(a); }
+
+static void rdVector_Cross3(rdVector3* out, const rdVector3* a, const rdVector3* b)
+{
+    out->x = a->y*b->z - a->z*b->y;
+    out->y = a->z*b->x - a->x*b->z;
+    out->z = a->x*b->y - a->y*b->x;
+}
+
+static flex_t rdVector_Normalize3Acc(rdVector3* v)
+{
+    flex_t len = sqrtf(rdVector_Dot3(v, v));
+    if (len > 0.0f)
+    {
+        v->x /= len;
+        v->y /= len;
+        v->z /= len;
+    }
+    return len;
+}
+
+static sithThing compare_shooter;
+static sithThing* sithThing_GetParent(sithThing* thing) { (void)thing; return &compare_shooter; }
+static void sithThing_Destroy(sithThing* thing) { (void)thing; }
+
+#include "sithHitscan.h"
+
+// What the batch decided for each ray
+typedef struct CompareResult
+{
+    int bPerRay;
+    sithCollisionSearchEntry hit;   // hitType 0 = none
+} CompareResult;
+
+#define COMPARE_MAX_RAYS (SITHHITSCAN_MAX_RAYS)
+
+static sithThing compare_aWeapons[COMPARE_MAX_RAYS];
+static CompareResult compare_aResults[COMPARE_MAX_RAYS];
+
+static void sithWeapon_sub_4D35E0(sithThing* weapon)
+{
+    compare_aResults[weapon - compare_aWeapons].bPerRay = 1;
+}
+
+static void sithWeapon_InstantImpactHit(sithThing* weapon, sithSector* sector, sithCollisionSearchEntry* hit, rdVector3* dir)
+{
+    (void)sector;
+    (void)dir;
+    compare_aResults[weapon - compare_aWeapons].hit = *hit;
+}
+
+#include "sithHitscan.c"
+
+// ================================================================
+// World: a corridor of boxes along x, joined by adjoins at each end
+// ================================================================
+
+#define COMPARE_MAX_SECTORS     (16)
+#define COMPARE_MAX_THINGS      (256)
+#define COMPARE_BOX_LENGTH      (4.0f)
+#define COMPARE_BOX_HALF_WIDTH  (1.5f)
+#define COMPARE_BOX_HALF_HEIGHT (1.0f)
+#define COMPARE_MAX_MOVE_SIZE   (0.1f)
+#define COMPARE_DIST_EPSILON    (1e-3f)
+
+static rdVector3 compare_aVertices[COMPARE_MAX_SECTORS * 8];
+static int compare_aFaceVertices[COMPARE_MAX_SECTORS * 6][4];
+static sithSector compare_aSectors[COMPARE_MAX_SECTORS];
+static sithSurface compare_aSurfaces[COMPARE_MAX_SECTORS * 6];
+static sithAdjoin compare_aAdjoins[COMPARE_MAX_SECTORS * 2];
+static sithThing compare_aThings[COMPARE_MAX_THINGS];
+static int compare_numSectors;
+static int compare_numThings;
+
+static uint32_t compare_seed = 1;
+
+static float Compare_Rand()
+{
+    compare_seed = compare_seed * 1664525u + 1013904223u;
+    return (float)(compare_seed >> 8) / 16777216.0f;
+}
+
+static float Compare_Range(float lo, float hi)
+{
+    return lo + (hi - lo) * Compare_Rand();
+}
+
+// Corner c of box k: bit 0 = +x, bit 1 = +y, bit 2 = +z
+static int Compare_Corner(int k, int c)
+{
+    return k * 8 + c;
+}
+
+// Face normals point into the box, as the walk expects (negative
+// planeDist in front)
+static void Compare_SetFace(sithSurface* surface, int* vertexIdx, int a, int b, int c, int d, float nx, float ny, float nz)
+{
+    vertexIdx[0] = a;
+    vertexIdx[1] = b;
+    vertexIdx[2] = c;
+    vertexIdx[3] = d;
+    surface->surfaceInfo.face.numVertices = 4;
+    surface->surfaceInfo.face.vertexPosIdx = vertexIdx;
+    surface->surfaceInfo.face.normal.x = nx;
+    surface->surfaceInfo.face.normal.y = ny;
+    surface->surfaceInfo.face.normal.z = nz;
+    surface->adjoin = NULL;
+}
+
+static void Compare_BuildWorld(int numSectors)
+{
+    int k, c;
+
+    compare_numSectors = numSectors;
+    compare_world.vertices = compare_aVertices;
+
+    for (k = 0; k < numSectors; k++)
+    {
+        sithSector* sector = &compare_aSectors[k];
+        sithSurface* surfaces = &compare_aSurfaces[k * 6];
+        int (*faces)[4] = &compare_aFaceVertices[k * 6];
+
+        for (c = 0; c < 8; c++)
+        {
+            rdVector3* v = &compare_aVertices[Compare_Corner(k, c)];
+            v->x = (k + (c & 1)) * COMPARE_BOX_LENGTH;
+            v->y = (c & 2) ? COMPARE_BOX_HALF_WIDTH : -COMPARE_BOX_HALF_WIDTH;
+            v->z = (c & 4) ? COMPARE_BOX_HALF_HEIGHT : -COMPARE_BOX_HALF_HEIGHT;
+        }
+
+        Compare_SetFace(&surfaces[0], faces[0], Compare_Corner(k, 0), Compare_Corner(k, 2), Compare_Corner(k, 6), Compare_Corner(k, 4), 1, 0, 0);
+        Compare_SetFace(&surfaces[1], faces[1], Compare_Corner(k, 1), Compare_Corner(k, 5), Compare_Corner(k, 7), Compare_Corner(k, 3), -1, 0, 0);
+        Compare_SetFace(&surfaces[2], faces[2], Compare_Corner(k, 0), Compare_Corner(k, 4), Compare_Corner(k, 5), Compare_Corner(k, 1), 0, 1, 0);
+        Compare_SetFace(&surfaces[3], faces[3], Compare_Corner(k, 2), Compare_Corner(k, 3), Compare_Corner(k, 7), Compare_Corner(k, 6), 0, -1, 0);
+        Compare_SetFace(&surfaces[4], faces[4], Compare_Corner(k, 0), Compare_Corner(k, 1), Compare_Corner(k, 3), Compare_Corner(k, 2), 0, 0, 1);
+        Compare_SetFace(&surfaces[5], faces[5], Compare_Corner(k, 4), Compare_Corner(k, 6), Compare_Corner(k, 7), Compare_Corner(k, 5), 0, 0, -1);
+
+        if (k > 0)
+        {
+            compare_aAdjoins[k * 2].flags = SITH_ADJOIN_MOVE;
+            compare_aAdjoins[k * 2].sector = &compare_aSectors[k - 1];
+            surfaces[0].adjoin = &compare_aAdjoins[k * 2];
+        }
+        if (k + 1 < numSectors)
+        {
+            compare_aAdjoins[k * 2 + 1].flags = SITH_ADJOIN_MOVE;
+            compare_aAdjoins[k * 2 + 1].sector = &compare_aSectors[k + 1];
+            surfaces[1].adjoin = &compare_aAdjoins[k * 2 + 1];
+        }
+
+        sector->numSurfaces = 6;
+        sector->surfaces = surfaces;
+        sector->thingsList = NULL;
+    }
+}
+
+// Things sit wholly inside their box, clear of the walls by more than
+// any weapon's moveSize, so the nearest hit doesn't depend on which
+// sector a thing is listed in
+static void Compare_AddThings(int numThings)
+{
+    int i;
+
+    compare_numThings = numThings;
+    for (i = 0; i < numThings; i++)
+    {
+        sithThing* thing = &compare_aThings[i];
+        int k = (int)(Compare_Rand() * compare_numSectors);
+        float size = Compare_Range(0.05f, 0.3f);
+        float margin = size + COMPARE_MAX_MOVE_SIZE + 0.01f;
+        float roll = Compare_Rand();
+
+        memset(thing, 0, sizeof(*thing));
+        thing->type = SITH_THING_ACTOR;
+        thing->collide = roll < 0.1f ? SITH_COLLIDE_FACE : SITH_COLLIDE_SPHERE;
+        thing->thingflags = roll > 0.95f ? SITH_TF_DISABLED : 0;
+        thing->collideSize = size;
+        thing->position.x = Compare_Range(k * COMPARE_BOX_LENGTH + margin, (k + 1) * COMPARE_BOX_LENGTH - margin);
+        thing->position.y = Compare_Range(-COMPARE_BOX_HALF_WIDTH + margin, COMPARE_BOX_HALF_WIDTH - margin);
+        thing->position.z = Compare_Range(-COMPARE_BOX_HALF_HEIGHT + margin, COMPARE_BOX_HALF_HEIGHT - margin);
+        thing->sector = &compare_aSectors[k];
+        thing->nextThing = compare_aSectors[k].thingsList;
+        compare_aSectors[k].thingsList = thing;
+    }
+
+    sithCollision_collisionHandlers[SITH_THING_WEAPON * 12 + SITH_THING_ACTOR].handler = (void*)1;
+}
+
+// ================================================================
+// Brute force: every thing and every solid surface, per ray
+// ================================================================
+
+typedef struct CompareHit
+{
+    float dist;
+    sithThing* thing;       // NULL for a surface
+    sithSurface* surface;
+} CompareHit;
+
+static int Compare_InsideFace(rdFace* face, rdVector3* point)
+{
+    int sign = 0;
+    int i;
+
+    for (i = 0; i < face->numVertices; i++)
+    {
+        rdVector3* a = &compare_aVertices[face->vertexPosIdx[i]];
+        rdVector3* b = &compare_aVertices[face->vertexPosIdx[(i + 1) % face->numVertices]];
+        rdVector3 edge, toPoint, cross;
+        float side;
+
+        rdVector_Sub3(&edge, b, a);
+        rdVector_Sub3(&toPoint, point, a);
+        rdVector_Cross3(&cross, &edge, &toPoint);
+        side = rdVector_Dot3(&cross, &face->normal);
+        if ((side > 0.0f && sign < 0) || (side < 0.0f && sign > 0))
+            return 0;
+        if (side != 0.0f)
+            sign = side > 0.0f ? 1 : -1;
+    }
+    return 1;
+}
+
+// Nearest hit within range; *pFaceDist gets the nearest face-collide
+// thing the ray reaches before any solid surface (past range if none)
+static int Compare_Nearest(sithThing* weapon, CompareHit* out, float* pFaceDist)
+{
+    rdVector3* origin = &weapon->position;
+    rdVector3* dir = &weapon->lookOrientation.lvec;
+    float moveSize = weapon->moveSize;
+    float wallDist = weapon->weaponParams.range;
+    int i;
+
+    out->dist = weapon->weaponParams.range;
+    out->thing = NULL;
+    out->surface = NULL;
+    *pFaceDist = weapon->weaponParams.range + 1.0f;
+
+    for (i = 0; i < compare_numSectors * 6; i++)
+    {
+        sithSurface* surface = &compare_aSurfaces[i];
+        rdFace* face = &surface->surfaceInfo.face;
+        rdVector3 toV0, point;
+        float planeDist, facing, touch;
+
+        if (surface->adjoin)
+            continue;
+
+        rdVector_Sub3(&toV0, &compare_aVertices[face->vertexPosIdx[0]], origin);
+        planeDist = rdVector_Dot3(&face->normal, &toV0);
+        facing = rdVector_Dot3(&face->normal, dir);
+        if (planeDist > 0.0f || facing >= 0.0f)
+            continue;
+
+        touch = (planeDist + moveSize) / facing;
+        if (touch < 0.0f)
+            touch = 0.0f;
+        if (touch >= wallDist)
+            continue;
+
+        point = *origin;
+        rdVector_MultAcc3(&point, dir, touch);
+        rdVector_MultAcc3(&point, &face->normal, -moveSize);
+        if (!Compare_InsideFace(face, &point))
+            continue;
+
+        wallDist = touch;
+        out->dist = touch;
+        out->surface = surface;
+    }
+
+    for (i = 0; i < compare_numThings; i++)
+    {
+        sithThing* thing = &compare_aThings[i];
+        rdVector3 toThing;
+        float radius = thing->collideSize + moveSize;
+        float along, inside, enter;
+
+        if (thing->thingflags & SITH_TF_DISABLED)
+            continue;
+
+        rdVector_Sub3(&toThing, &thing->position, origin);
+        along = rdVector_Dot3(&toThing, dir);
+        inside = radius*radius - (rdVector_Dot3(&toThing, &toThing) - along*along);
+        if (inside < 0.0f || along + radius < 0.0f)
+            continue;
+        enter = along - stdMath_Sqrt(inside);
+        if (enter < 0.0f)
+            enter = 0.0f;
+        if (enter >= wallDist)
+            continue;
+
+        if (thing->collide == SITH_COLLIDE_FACE && enter < *pFaceDist)
+            *pFaceDist = enter;
+        if (enter < out->dist)
+        {
+            out->dist = enter;
+            out->thing = thing;
+            out->surface = NULL;
+        }
+    }
+
+    return out->thing || out->surface;
+}
+
+// A shooter stands clear of every thing; from inside two of them the
+// nearest hit is a tie at 0
+static int Compare_Clear(rdVector3* origin)
+{
+    int i;
+
+    for (i = 0; i < compare_numThings; i++)
+    {
+        rdVector3 delta;
+        float radius = compare_aThings[i].collideSize + COMPARE_MAX_MOVE_SIZE;
+
+        rdVector_Sub3(&delta, &compare_aThings[i].position, origin);
+        if (rdVector_Dot3(&delta, &delta) <= radius * radius)
+            return 0;
+    }
+    return 1;
+}
+
+// Same hit, or another one at the same distance
+static int Compare_SameHit(CompareResult* result, CompareHit* expected)
+{
+    if (fabsf(result->hit.distance - expected->dist) > COMPARE_DIST_EPSILON)
+        return 0;
+    if (expected->thing)
+        return result->hit.hitType == SITHCOLLISION_THING;
+    return result->hit.hitType == SITHCOLLISION_WORLD;
+}
+
+int main(int argc, char** argv)
+{
+    int numBlasts = 20000;
+    int numSectors = 8;
+    int numThings = 96;
+    long rays = 0, hits = 0, ties = 0, perRay = 0, perRayExtra = 0, mismatches = 0;
+    float maxDistError = 0.0f;
+    int blast, i;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "--blasts"))
+            numBlasts = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--sectors"))
+            numSectors = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--things"))
+            numThings = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seed"))
+            compare_seed = (uint32_t)atoi(argv[i + 1]);
+    }
+    if (numSectors < 1)
+        numSectors = 1;
+    if (numSectors > COMPARE_MAX_SECTORS)
+        numSectors = COMPARE_MAX_SECTORS;
+    if (numThings < 0)
+        numThings = 0;
+    if (numThings > COMPARE_MAX_THINGS)
+        numThings = COMPARE_MAX_THINGS;
+
+    Compare_BuildWorld(numSectors);
+    Compare_AddThings(numThings);
+
+    for (blast = 0; blast < numBlasts; blast++)
+    {
+        int k = (int)(Compare_Rand() * numSectors);
+        int numRays = 1 + (int)(Compare_Rand() * COMPARE_MAX_RAYS);
+        float yaw = Compare_Range(-3.14159265f, 3.14159265f);
+        float pitch = Compare_Range(-0.6f, 0.6f);
+        float spread = Compare_Rand() < 0.5f ? 0.05f : 0.4f;
+        float moveSize = Compare_Rand() < 0.5f ? 0.0f : Compare_Range(0.01f, COMPARE_MAX_MOVE_SIZE);
+        rdVector3 origin;
+
+        do
+        {
+            origin.x = Compare_Range(k * COMPARE_BOX_LENGTH + 0.2f, (k + 1) * COMPARE_BOX_LENGTH - 0.2f);
+            origin.y = Compare_Range(-COMPARE_BOX_HALF_WIDTH + 0.2f, COMPARE_BOX_HALF_WIDTH - 0.2f);
+            origin.z = Compare_Range(-COMPARE_BOX_HALF_HEIGHT + 0.2f, COMPARE_BOX_HALF_HEIGHT - 0.2f);
+        }
+        while (!Compare_Clear(&origin));
+
+        for (i = 0; i < numRays; i++)
+        {
+            sithThing* weapon = &compare_aWeapons[i];
+            float rayYaw = yaw + Compare_Range(-spread, spread);
+            float rayPitch = pitch + Compare_Range(-spread, spread);
+
+            memset(weapon, 0, sizeof(*weapon));
+            weapon->type = SITH_THING_WEAPON;
+            weapon->sector = &compare_aSectors[k];
+            weapon->position = origin;
+            weapon->lookOrientation.lvec.x = cosf(rayYaw) * cosf(rayPitch);
+            weapon->lookOrientation.lvec.y = sinf(rayYaw) * cosf(rayPitch);
+            weapon->lookOrientation.lvec.z = sinf(rayPitch);
+            weapon->moveSize = moveSize;
+            weapon->weaponParams.range = Compare_Range(2.0f, 40.0f);
+            memset(&compare_aResults[i], 0, sizeof(compare_aResults[i]));
+
+            sithHitscan_Queue(weapon);
+        }
+        sithHitscan_Flush();
+
+        for (i = 0; i < numRays; i++)
+        {
+            sithThing* weapon = &compare_aWeapons[i];
+            CompareResult* result = &compare_aResults[i];
+            CompareHit expected;
+            float faceDist;
+            int bExpected = Compare_Nearest(weapon, &expected, &faceDist);
+            int bFaceNearest = expected.thing && expected.thing->collide == SITH_COLLIDE_FACE;
+
+            rays++;
+
+            if (result->bPerRay)
+            {
+                perRay++;
+                if (!bFaceNearest)
+                {
+                    if (faceDist < weapon->weaponParams.range)
+                        perRayExtra++;
+                    else
+                        mismatches++;
+                }
+                continue;
+            }
+            if (bFaceNearest)
+            {
+                mismatches++;
+                continue;
+            }
+
+            if (!bExpected)
+            {
+                if (result->hit.hitType)
+                    mismatches++;
+                continue;
+            }
+
+            hits++;
+            if (result->hit.receiver != expected.thing || result->hit.surface != expected.surface)
+            {
+                if (Compare_SameHit(result, &expected))
+                    ties++;
+                else
+                    mismatches++;
+                continue;
+            }
+
+            if (fabsf(result->hit.distance - expected.dist) > maxDistError)
+                maxDistError = fabsf(result->hit.distance - expected.dist);
+            if (fabsf(result->hit.distance - expected.dist) > COMPARE_DIST_EPSILON)
+                mismatches++;
+        }
+    }
+
+    printf("{\n");
+#ifdef SITHHITSCAN_SSE
+    printf("  \"lanes\": \"sse\",\n");
+#else
+    printf("  \"lanes\": \"scalar\",\n");
+#endif
+    printf("  \"sectors\": %d,\n", numSectors);
+    printf("  \"things\": %d,\n", numThings);
+    printf("  \"blasts\": %d,\n", numBlasts);
+    printf("  \"rays\": %ld,\n", rays);
+    printf("  \"hits\": %ld,\n", hits);
+    printf("  \"ties\": %ld,\n", ties);
+    printf("  \"perRay\": %ld,\n", perRay);
+    printf("  \"perRayExtra\": %ld,\n", perRayExtra);
+    printf("  \"maxDistError\": %g,\n", maxDistError);
+    printf("  \"mismatches\": %ld\n", mismatches);
+    printf("}\n");
+
+    return mismatches ? 1 : 0;
+}
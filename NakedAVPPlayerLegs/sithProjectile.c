@@ -0,0 +1,330 @@
+#include "sithProjectile.h"
+
+#ifndef SITHPROJECTILE_STANDALONE
+#include "World/sithThing.h"
+#include "World/sithSector.h"
+#include "Engine/sithCollision.h"
+#include "Engine/sithRender.h"
+#include "Engine/rdThing.h"
+#include "Main/Main.h"
+#include "General/stdMath.h"
+#include "jk.h"
+
+#include "sithWeapon.h"
+#endif
+
+// One lane per projectile; the integrate and decay loops walk the arrays
+// together.
+typedef struct sithProjectilePool
+{
+    int numProjectiles;
+
+    flex_t posX[SITHPROJECTILE_MAX];
+    flex_t posY[SITHPROJECTILE_MAX];
+    flex_t posZ[SITHPROJECTILE_MAX];
+    flex_t velX[SITHPROJECTILE_MAX];
+    flex_t velY[SITHPROJECTILE_MAX];
+    flex_t velZ[SITHPROJECTILE_MAX];
+    flex_t damage[SITHPROJECTILE_MAX];
+    flex_t decayRate[SITHPROJECTILE_MAX];   // 0 without SITH_WF_DAMAGE_DECAY
+    flex_t minDamage[SITHPROJECTILE_MAX];
+    flex_t lifeLeft[SITHPROJECTILE_MAX];    // Seconds
+    flex_t extraSecs[SITHPROJECTILE_MAX];   // Fire-rate catch-up, moved with the first tick
+    int typeflags[SITHPROJECTILE_MAX];
+    flex_t unk8[SITHPROJECTILE_MAX];        // Only read when promoted
+
+    // Scratch for one tick
+    flex_t stepX[SITHPROJECTILE_MAX];
+    flex_t stepY[SITHPROJECTILE_MAX];
+    flex_t stepZ[SITHPROJECTILE_MAX];
+
+    sithThing* projectileTemplate[SITHPROJECTILE_MAX];
+    sithThing* shooter[SITHPROJECTILE_MAX];
+    int shooterSignature[SITHPROJECTILE_MAX];
+    sithSector* sector[SITHPROJECTILE_MAX];
+} sithProjectilePool;
+
+static sithProjectilePool sithProjectile_pool;
+
+// Flies straight until it hits something: anything the physics or weapon
+// tick would do to it on the way (gravity, drag, spin, awareness events,
+// proximity checks, lights and sounds that follow it, a class cog) needs
+// the thing, so those templates are never pooled.
+static int sithProjectile_CanPool(sithThing* projectileTemplate)
+{
+    if (sithNet_isMulti || Main_bMotsCompat)
+        return 0;
+    if (projectileTemplate->type != SITH_THING_WEAPON || projectileTemplate->moveType != SITH_MT_PHYSICS)
+        return 0;
+    if (projectileTemplate->lifeLeftMs <= 0)
+        return 0;
+    if (projectileTemplate->class_cog || projectileTemplate->soundclass || (projectileTemplate->thingflags & SITH_TF_LIGHT))
+        return 0;
+    if ((projectileTemplate->physicsParams.physflags & SITH_PF_USEGRAVITY)
+        || projectileTemplate->physicsParams.airDrag != 0.0
+        || !rdVector_IsZero3(&projectileTemplate->physicsParams.angVel))
+        return 0;
+    if (projectileTemplate->weaponParams.typeflags & (SITH_WF_PROXIMITY | SITH_WF_TRIGGER_AI_AWARENESS | SITH_WF_TRIGGER_AIEVENT | SITH_WF_INSTANT_IMPACT | SITH_WF_INSTANT_IMPACT_RANDOM))
+        return 0;
+    return 1;
+}
+
+// Straight move of a pooled projectile, following adjoins. Returns 1 if
+// it runs into anything on the way; pSector is left in the last sector
+// reached either way.
+static int sithProjectile_Sweep(sithThing* projectileTemplate, sithThing* shooter, rdVector3* from, rdVector3* dir, flex_t dist, sithSector** pSector)
+{
+    sithCollisionSearchEntry* searchRes;
+    int bHit = 0;
+
+    // The template stands in for the projectile: same type and size, and
+    // never in a sector itself
+    sithCollision_SearchRadiusForThings(*pSector, projectileTemplate, from, dir, dist, projectileTemplate->moveSize, 0);
+    for (searchRes = sithCollision_NextSearchResult(); searchRes; searchRes = sithCollision_NextSearchResult())
+    {
+        if (searchRes->hitType & SITHCOLLISION_ADJOINCROSS)
+        {
+            *pSector = searchRes->surface->adjoin->sector;
+            continue;
+        }
+        if ((searchRes->hitType & SITHCOLLISION_THING) && searchRes->receiver == shooter)
+            continue;
+
+        bHit = 1;
+        break;
+    }
+    sithCollision_SearchClose();
+
+    return bHit;
+}
+
+int sithProjectile_Fire(sithThing* sender, sithThing* projectileTemplate, rdVector3* dir, rdVector3* firePos, flex_t scale, int scaleFlags, flex_t deltaSecs)
+{
+    sithProjectilePool* pool = &sithProjectile_pool;
+    sithSector* sector = sender->sector;
+    rdMatrix34 orient;
+    rdVector3 vel, toFirePos;
+    flex_t damage, unk8, fireDist;
+    int i;
+
+    if (!projectileTemplate || !sector || pool->numProjectiles == SITHPROJECTILE_MAX)
+        return 0;
+    if (!sithProjectile_CanPool(projectileTemplate))
+        return 0;
+
+    // sithWeapon_FireProjectile_0 moves the new thing from the shooter to
+    // the fire point with collision; if that would hit anything, let it
+    rdVector_Sub3(&toFirePos, firePos, &sender->position);
+    fireDist = rdVector_Normalize3Acc(&toFirePos);
+    if (fireDist > 0.0 && sithProjectile_Sweep(projectileTemplate, sender, &sender->position, &toFirePos, fireDist, &sector))
+        return 0;
+
+    rdMatrix_BuildFromLook34(&orient, dir);
+    rdMatrix_TransformVector34(&vel, &projectileTemplate->physicsParams.vel, &orient);
+
+    damage = projectileTemplate->weaponParams.damage;
+    unk8 = projectileTemplate->weaponParams.unk8;
+    if (scaleFlags & 1)
+        rdVector_Scale3Acc(&vel, scale);
+    if (scaleFlags & 2)
+        damage *= scale;
+    if (scaleFlags & 4)
+        damage *= scale;
+    if (scaleFlags & 8)
+        unk8 *= scale;
+
+    i = pool->numProjectiles++;
+    pool->posX[i] = firePos->x;
+    pool->posY[i] = firePos->y;
+    pool->posZ[i] = firePos->z;
+    pool->velX[i] = vel.x;
+    pool->velY[i] = vel.y;
+    pool->velZ[i] = vel.z;
+    pool->damage[i] = damage;
+    pool->decayRate[i] = (projectileTemplate->weaponParams.typeflags & SITH_WF_DAMAGE_DECAY) ? projectileTemplate->weaponParams.rate : 0.0;
+    pool->minDamage[i] = projectileTemplate->weaponParams.mindDamage;
+    pool->lifeLeft[i] = (flex_t)projectileTemplate->lifeLeftMs * 0.001;
+    pool->extraSecs[i] = deltaSecs > 0.02 ? deltaSecs : 0.0;
+    pool->typeflags[i] = projectileTemplate->weaponParams.typeflags;
+    pool->unk8[i] = unk8;
+    pool->projectileTemplate[i] = projectileTemplate;
+    pool->shooter[i] = sender;
+    pool->shooterSignature[i] = sender->signature;
+    pool->sector[i] = sector;
+
+    return 1;
+}
+
+// Real thing for lane i, where and as it is now
+static sithThing* sithProjectile_Promote(int i)
+{
+    sithProjectilePool* pool = &sithProjectile_pool;
+    sithThing* shooter = pool->shooter[i];
+    sithThing* thing;
+    rdMatrix34 orient;
+    rdVector3 pos, vel, look;
+
+    pos.x = pool->posX[i];
+    pos.y = pool->posY[i];
+    pos.z = pool->posZ[i];
+    vel.x = pool->velX[i];
+    vel.y = pool->velY[i];
+    vel.z = pool->velZ[i];
+
+    // The shooter may be gone (and its slot reused) by now
+    if (shooter->signature != pool->shooterSignature[i] || shooter->type == SITH_THING_FREE)
+        shooter = NULL;
+
+    rdVector_Normalize3(&look, &vel);
+    rdMatrix_BuildFromLook34(&orient, &look);
+    thing = sithThing_Create(pool->projectileTemplate[i], &pos, &orient, pool->sector[i], shooter);
+    if (!thing)
+        return NULL;
+
+    rdVector_Copy3(&thing->physicsParams.vel, &vel);
+    thing->weaponParams.damage = pool->damage[i];
+    thing->weaponParams.typeflags = pool->typeflags[i];
+    thing->weaponParams.unk8 = pool->unk8[i];
+    thing->lifeLeftMs = (int)(pool->lifeLeft[i] * 1000.0);
+    if (thing->lifeLeftMs <= 0)
+        thing->lifeLeftMs = 1;
+
+    return thing;
+}
+
+static void sithProjectile_Remove(int i)
+{
+    sithProjectilePool* pool = &sithProjectile_pool;
+    int last = --pool->numProjectiles;
+
+    if (i == last)
+        return;
+
+    pool->posX[i] = pool->posX[last];
+    pool->posY[i] = pool->posY[last];
+    pool->posZ[i] = pool->posZ[last];
+    pool->velX[i] = pool->velX[last];
+    pool->velY[i] = pool->velY[last];
+    pool->velZ[i] = pool->velZ[last];
+    pool->damage[i] = pool->damage[last];
+    pool->decayRate[i] = pool->decayRate[last];
+    pool->minDamage[i] = pool->minDamage[last];
+    pool->lifeLeft[i] = pool->lifeLeft[last];
+    pool->extraSecs[i] = pool->extraSecs[last];
+    pool->typeflags[i] = pool->typeflags[last];
+    pool->unk8[i] = pool->unk8[last];
+    pool->stepX[i] = pool->stepX[last];
+    pool->stepY[i] = pool->stepY[last];
+    pool->stepZ[i] = pool->stepZ[last];
+    pool->projectileTemplate[i] = pool->projectileTemplate[last];
+    pool->shooter[i] = pool->shooter[last];
+    pool->shooterSignature[i] = pool->shooterSignature[last];
+    pool->sector[i] = pool->sector[last];
+}
+
+void sithProjectile_Tick(flex_t deltaSecs)
+{
+    sithProjectilePool* pool = &sithProjectile_pool;
+    int numProjectiles = pool->numProjectiles;
+    int i;
+
+    if (!numProjectiles)
+        return;
+
+    // Integrate, decay and age every lane
+    for (i = 0; i < numProjectiles; i++)
+    {
+        flex_t stepSecs = deltaSecs + pool->extraSecs[i];
+
+        pool->stepX[i] = pool->velX[i] * stepSecs;
+        pool->stepY[i] = pool->velY[i] * stepSecs;
+        pool->stepZ[i] = pool->velZ[i] * stepSecs;
+        pool->extraSecs[i] = 0.0;
+    }
+    for (i = 0; i < numProjectiles; i++)
+    {
+        // As sithWeapon_Tick: decayed to nothing drops to the minimum
+        flex_t decayed = pool->damage[i] - pool->decayRate[i] * deltaSecs;
+
+        if (pool->damage[i] > pool->minDamage[i])
+            pool->damage[i] = decayed <= 0.0 ? pool->minDamage[i] : decayed;
+        pool->lifeLeft[i] -= deltaSecs;
+    }
+
+    // Sweep each lane along its step; backwards so removal keeps the
+    // lanes still to visit in place
+    for (i = numProjectiles - 1; i >= 0; i--)
+    {
+        sithThing* projectileTemplate = pool->projectileTemplate[i];
+        sithSector* sector = pool->sector[i];
+        sithThing* thing;
+        rdVector3 from, dir;
+        flex_t dist;
+
+        if (pool->lifeLeft[i] <= 0.0)
+        {
+            if ((pool->typeflags[i] & SITH_WF_EXPLODE_AT_TIMER_TIMEOUT) && (thing = sithProjectile_Promote(i)) != NULL)
+                sithWeapon_RemoveAndExplode(thing, thing->weaponParams.explodeTemplate);
+            sithProjectile_Remove(i);
+            continue;
+        }
+
+        from.x = pool->posX[i];
+        from.y = pool->posY[i];
+        from.z = pool->posZ[i];
+        dir.x = pool->stepX[i];
+        dir.y = pool->stepY[i];
+        dir.z = pool->stepZ[i];
+        dist = rdVector_Normalize3Acc(&dir);
+        if (dist <= 0.0)
+            continue;
+
+        if (!sithProjectile_Sweep(projectileTemplate, pool->shooter[i], &from, &dir, dist, &sector))
+        {
+            pool->sector[i] = sector;
+            pool->posX[i] += pool->stepX[i];
+            pool->posY[i] += pool->stepY[i];
+            pool->posZ[i] += pool->stepZ[i];
+            continue;
+        }
+
+        // Hit something: from here on it is a normal projectile, created
+        // where the step started and moved into the hit by the engine
+        thing = sithProjectile_Promote(i);
+        if (thing)
+            sithCollision_UpdateThingCollision(thing, &dir, dist, thing->physicsParams.physflags);
+        sithProjectile_Remove(i);
+    }
+}
+
+// Render hook, see sithProjectile.h
+void sithProjectile_Draw()
+{
+    sithProjectilePool* pool = &sithProjectile_pool;
+    int i;
+
+    for (i = 0; i < pool->numProjectiles; i++)
+    {
+        rdMatrix34 mat;
+        rdVector3 look;
+
+        if (pool->sector[i]->renderTick != sithRender_lastRenderTick)
+            continue;
+
+        look.x = pool->velX[i];
+        look.y = pool->velY[i];
+        look.z = pool->velZ[i];
+        rdVector_Normalize3Acc(&look);
+        rdMatrix_BuildFromLook34(&mat, &look);
+        mat.scale.x = pool->posX[i];
+        mat.scale.y = pool->posY[i];
+        mat.scale.z = pool->posZ[i];
+        rdThing_Draw(&pool->projectileTemplate[i]->rdthing, &mat);
+    }
+}
+
+void sithProjectile_Reset()
+{
+    // Templates, shooters and sectors belong to the world being unloaded
+    sithProjectile_pool.numProjectiles = 0;
+}
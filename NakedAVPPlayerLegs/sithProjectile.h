@@ -0,0 +1,45 @@
+#ifndef _SITHPROJECTILE_H
+#define _SITHPROJECTILE_H
+
+#ifndef SITHPROJECTILE_STANDALONE
+#include "types.h"
+#include "globals.h"
+#endif
+
+// Added: pooled physics projectiles.
+//
+// A bolt in flight only needs a position, a velocity and a damage value;
+// as a sithThing it also takes a thing slot, sector membership and its
+// own physics/weapon tick. Projectiles fired with
+// SITHPROJECTILE_FIRE_POOLED are kept here instead, one slot per
+// projectile in parallel arrays, and the whole pool is moved, decayed and
+// swept in one pass from sithWeapon_TickEnd. sithProjectile_Draw draws
+// them with their template's rdThing.
+//
+// A pooled projectile becomes a real thing (promoted) the moment
+// anything else has to see it: when it hits something, the thing is
+// created where it was and moved into the hit with
+// sithCollision_UpdateThingCollision, so damage, explosions and cog
+// messages go through sithWeapon_Collide as before. Timed explosions are
+// promoted the same way. There is no thing while it flies, so the flag
+// is for cogs that don't use FireProjectile's return value (it is -1),
+// and it is ignored in multiplayer, where every projectile is synced as
+// a thing.
+//
+// Nothing in this tree calls sithProjectile_Draw. Its place is in
+// sithRender_Draw (outside this tree), after sithRender_RenderThings has
+// marked the visible sectors with the current renderTick. Leave
+// PROJECTILE_POOL undefined until that call is in: pooled bolts would
+// still fly and hit, but nobody would see them.
+
+#define SITHPROJECTILE_MAX            (256)
+
+// FireProjectile flag (above the SITH_PROJECTILE_* bits)
+#define SITHPROJECTILE_FIRE_POOLED    (0x4000)
+
+MATH_FUNC int sithProjectile_Fire(sithThing* sender, sithThing* projectileTemplate, rdVector3* dir, rdVector3* firePos, flex_t scale, int scaleFlags, flex_t deltaSecs);
+MATH_FUNC void sithProjectile_Tick(flex_t deltaSecs);
+MATH_FUNC void sithProjectile_Draw();
+void sithProjectile_Reset();
+
+#endif // _SITHPROJECTILE_H
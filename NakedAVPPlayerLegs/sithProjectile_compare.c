@@ -0,0 +1,835 @@
+// ================================================================
+// File: sithProjectile_compare.c
+// Check of the pooled projectiles (sithProjectile) against the things
+// they stand in for
+//
+// Shooters in a corridor of box sectors fire bolts at scattered targets
+// through sithProjectile_Fire and the pool is ticked and drawn as the
+// engine would. Next to it every shot is flown the way its sithThing
+// would be (one shot at a time, no lanes), and each tick checks that:
+//
+// - Fire takes exactly the shots the thing path may leave to the pool:
+//   not gravity, cog or proximity templates, not shots whose way to the
+//   fire point is blocked, not once the pool is full;
+// - a pooled shot is promoted on the tick its thing would hit something,
+//   where the step started, in the same sector, with the same damage
+//   (decayed), unk8 (scaled), time left and step into the hit;
+// - the parent of a promoted shot is its shooter, or none once the
+//   shooter's slot was freed or reused;
+// - a timed explosion is promoted and exploded on the tick its time runs
+//   out, and any other shot that times out just disappears;
+// - the pool holds as many shots as are still in flight, and
+//   sithProjectile_Draw draws each one in a visible sector once, where
+//   its thing would be.
+//
+// Results are printed as JSON; the exit code is non-zero on a mismatch.
+//
+// Build:
+//   cc -O2 sithProjectile_compare.c -lm -o sithProjectile_compare
+//
+// Usage:
+//   sithProjectile_compare [--shooters N] [--targets N] [--rate SHOTS_PER_SEC]
+//                          [--seconds S] [--hz H] [--seed N]
+// ================================================================
+
+#define SITHPROJECTILE_STANDALONE
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ================================================================
+// Stand-ins for the engine types and functions sithProjectile.c uses
+// ================================================================
+
+typedef float flex_t;
+#define MATH_FUNC
+
+typedef struct { flex_t x, y, z; } rdVector3;
+typedef struct { rdVector3 rvec, lvec, uvec, scale; } rdMatrix34;
+typedef struct { int type; } rdThing;
+typedef struct sithSector { int renderTick; } sithSector;
+typedef struct { int flags; sithSector* sector; } sithAdjoin;
+typedef struct { sithAdjoin* adjoin; } sithSurface;
+typedef struct { int physflags; flex_t airDrag; rdVector3 angVel; rdVector3 vel; } sithPhysicsParams;
+typedef struct sithThing sithThing;
+typedef struct { int typeflags; flex_t damage; flex_t rate; flex_t mindDamage; flex_t unk8; sithThing* explodeTemplate; } sithWeaponParams;
+struct sithThing
+{
+    int type;
+    int moveType;
+    int lifeLeftMs;
+    int thingflags;
+    int signature;
+    void* class_cog;
+    void* soundclass;
+    flex_t moveSize;
+    flex_t collideSize;
+    sithPhysicsParams physicsParams;
+    sithWeaponParams weaponParams;
+    rdThing rdthing;
+    rdVector3 position;
+    sithSector* sector;
+};
+typedef struct { int hitType; sithThing* receiver; sithSurface* surface; flex_t distance; } sithCollisionSearchEntry;
+
+enum { SITH_THING_FREE = 0, SITH_THING_ACTOR = 2, SITH_THING_WEAPON = 3 };
+
+#define SITH_MT_PHYSICS                     (1)
+#define SITH_TF_LIGHT                       (0x1)
+#define SITH_PF_USEGRAVITY                  (0x1)
+#define SITH_WF_PROXIMITY                   (0x1)
+#define SITH_WF_TRIGGER_AI_AWARENESS        (0x2)
+#define SITH_WF_TRIGGER_AIEVENT             (0x4)
+#define SITH_WF_INSTANT_IMPACT              (0x8)
+#define SITH_WF_INSTANT_IMPACT_RANDOM       (0x10)
+#define SITH_WF_DAMAGE_DECAY                (0x20)
+#define SITH_WF_EXPLODE_AT_TIMER_TIMEOUT    (0x40)
+#define SITHCOLLISION_THING                 (0x1)
+#define SITHCOLLISION_WORLD                 (0x2)
+#define SITHCOLLISION_ADJOINCROSS           (0x4)
+
+static int sithNet_isMulti;
+static int Main_bMotsCompat;
+static int sithRender_lastRenderTick;
+
+static int rdVector_IsZero3(const rdVector3* v) { return v->x == 0.0f && v->y == 0.0f && v->z == 0.0f; }
+static void rdVector_Copy3(rdVector3* out, const rdVector3* v) { *out = *v; }
+static void rdVector_Sub3(rdVector3* out, const rdVector3* a, const rdVector3* b) { out->x = a->x - b->x; out->y = a->y - b->y; out->z = a->z - b->z; }
+static void rdVector_Scale3Acc(rdVector3* v, flex_t scale) { v->x *= scale; v->y *= scale; v->z *= scale; }
+static flex_t rdVector_Dot3(const rdVector3* a, const rdVector3* b) { return a->x*b->x + a->y*b->y + a->z*b->z; }
+
+static flex_t rdVector_Normalize3Acc(rdVector3* v)
+{
+    flex_t len = sqrtf(rdVector_Dot3(v, v));
+    if (len > 0.0f)
+    {
+        v->x /= len;
+        v->y /= len;
+        v->z /= len;
+    }
+    return len;
+}
+
+static flex_t rdVector_Normalize3(rdVector3* out, const rdVector3* v)
+{
+    *out = *v;
+    return rdVector_Normalize3Acc(out);
+}
+
+static void rdMatrix_BuildFromLook34(rdMatrix34* out, const rdVector3* look)
+{
+    memset(out, 0, sizeof(*out));
+    out->lvec = *look;
+    out->rvec.x = look->y;
+    out->rvec.y = -look->x;
+    if (rdVector_Normalize3Acc(&out->rvec) == 0.0f)
+        out->rvec.x = 1.0f;
+    out->uvec.x = out->rvec.y*look->z - out->rvec.z*look->y;
+    out->uvec.y = out->rvec.z*look->x - out->rvec.x*look->z;
+    out->uvec.z = out->rvec.x*look->y - out->rvec.y*look->x;
+}
+
+static void rdMatrix_TransformVector34(rdVector3* out, const rdVector3* v, const rdMatrix34* m)
+{
+    out->x = m->rvec.x*v->x + m->lvec.x*v->y + m->uvec.x*v->z;
+    out->y = m->rvec.y*v->x + m->lvec.y*v->y + m->uvec.y*v->z;
+    out->z = m->rvec.z*v->x + m->lvec.z*v->y + m->uvec.z*v->z;
+}
+
+static void sithCollision_SearchRadiusForThings(sithSector* sector, sithThing* thing, rdVector3* from, rdVector3* dir, flex_t dist, flex_t radius, int flags);
+static sithCollisionSearchEntry* sithCollision_NextSearchResult();
+static void sithCollision_SearchClose();
+static void sithCollision_UpdateThingCollision(sithThing* thing, rdVector3* dir, flex_t dist, int physflags);
+static sithThing* sithThing_Create(sithThing* templateThing, rdVector3* position, rdMatrix34* orient, sithSector* sector, sithThing* parent);
+static void sithWeapon_RemoveAndExplode(sithThing* thing, sithThing* explodeTemplate);
+static void rdThing_Draw(rdThing* rdthing, rdMatrix34* mat);
+
+#include "sithProjectile.c"
+
+// ================================================================
+// The world: a corridor of COMPARE_SECTORS boxes along x, joined by
+// adjoins, with sphere things in it
+// ================================================================
+
+#define COMPARE_SECTORS         (8)
+#define COMPARE_SECTOR_LEN      (4.0f)
+#define COMPARE_HALF_HEIGHT     (2.0f)
+#define COMPARE_MAX_SHOOTERS    (32)
+#define COMPARE_MAX_TARGETS     (64)
+#define COMPARE_MAX_THINGS      (COMPARE_MAX_SHOOTERS + COMPARE_MAX_TARGETS)
+#define COMPARE_MAX_SHOTS       (65536)
+#define COMPARE_MAX_SEARCH      (COMPARE_SECTORS + COMPARE_MAX_THINGS + 1)
+#define COMPARE_MAX_CREATED     (SITHPROJECTILE_MAX)
+#define COMPARE_KINDS           (6)
+
+// Bolt, decaying bolt, timed explosion; then three the pool must refuse
+enum { COMPARE_KIND_BOLT, COMPARE_KIND_DECAY, COMPARE_KIND_TIMED, COMPARE_KIND_GRAVITY, COMPARE_KIND_COG, COMPARE_KIND_PROXIMITY };
+
+static sithSector compare_aSectors[COMPARE_SECTORS];
+static sithAdjoin compare_aAdjoins[COMPARE_SECTORS];
+static sithSurface compare_aAdjoinSurfaces[COMPARE_SECTORS];
+static sithThing compare_aThings[COMPARE_MAX_THINGS];   // Shooters first, then targets
+static int compare_numThings;
+static sithThing compare_explodeTemplate;
+static int compare_cog;
+
+static sithCollisionSearchEntry compare_aSearch[COMPARE_MAX_SEARCH];
+static int compare_numSearch;
+static int compare_searchIdx;
+
+static int Compare_SectorIdx(flex_t x)
+{
+    int idx = (int)floorf(x / COMPARE_SECTOR_LEN);
+
+    if (idx < 0)
+        return 0;
+    if (idx >= COMPARE_SECTORS)
+        return COMPARE_SECTORS - 1;
+    return idx;
+}
+
+// Distance along dir at which a sphere of the given radius starting at
+// from reaches the sphere at center; 0 if it starts inside, -1 if it
+// doesn't get there within dist
+static flex_t Compare_SphereHit(const rdVector3* from, const rdVector3* dir, flex_t dist, flex_t radius, const rdVector3* center, flex_t centerRadius)
+{
+    rdVector3 d;
+    flex_t r = radius + centerRadius;
+    flex_t b, c, disc, t;
+
+    rdVector_Sub3(&d, from, center);
+    c = rdVector_Dot3(&d, &d) - r*r;
+    if (c <= 0.0f)
+        return 0.0f;
+    b = rdVector_Dot3(&d, dir);
+    if (b >= 0.0f)
+        return -1.0f;
+    disc = b*b - c;
+    if (disc < 0.0f)
+        return -1.0f;
+    t = -b - sqrtf(disc);
+    return t <= dist ? t : -1.0f;
+}
+
+// Same for the corridor's walls, floor, ceiling and ends
+static flex_t Compare_WallHit(const rdVector3* from, const rdVector3* dir, flex_t dist, flex_t radius)
+{
+    const flex_t* p = &from->x;
+    const flex_t* d = &dir->x;
+    flex_t lo[3], hi[3];
+    flex_t best = -1.0f;
+    int axis;
+
+    lo[0] = radius;
+    hi[0] = COMPARE_SECTORS * COMPARE_SECTOR_LEN - radius;
+    lo[1] = lo[2] = -COMPARE_HALF_HEIGHT + radius;
+    hi[1] = hi[2] = COMPARE_HALF_HEIGHT - radius;
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        flex_t t;
+
+        if (d[axis] > 0.0f)
+            t = (hi[axis] - p[axis]) / d[axis];
+        else if (d[axis] < 0.0f)
+            t = (lo[axis] - p[axis]) / d[axis];
+        else
+            continue;
+        if (t < 0.0f)
+            t = 0.0f;
+        if (t <= dist && (best < 0.0f || t < best))
+            best = t;
+    }
+    return best;
+}
+
+static int Compare_InWorld(const sithThing* thing)
+{
+    return thing->type != SITH_THING_FREE;
+}
+
+// What the thing path runs into first, its own shooter aside; -1 if
+// nothing within dist
+static flex_t Compare_FirstHit(const rdVector3* from, const rdVector3* dir, flex_t dist, flex_t radius, const sithThing* shooter)
+{
+    flex_t best = Compare_WallHit(from, dir, dist, radius);
+    int i;
+
+    for (i = 0; i < compare_numThings; i++)
+    {
+        const sithThing* thing = &compare_aThings[i];
+        flex_t t;
+
+        if (thing == shooter || !Compare_InWorld(thing))
+            continue;
+        t = Compare_SphereHit(from, dir, dist, radius, &thing->position, thing->collideSize);
+        if (t >= 0.0f && (best < 0.0f || t < best))
+            best = t;
+    }
+    return best;
+}
+
+static void Compare_AddSearch(int hitType, sithThing* receiver, sithSurface* surface, flex_t distance)
+{
+    sithCollisionSearchEntry* entry;
+    int i = compare_numSearch++;
+
+    // Sorted by distance, as sithCollision hands them out
+    while (i > 0 && compare_aSearch[i - 1].distance > distance)
+    {
+        compare_aSearch[i] = compare_aSearch[i - 1];
+        i--;
+    }
+    entry = &compare_aSearch[i];
+    entry->hitType = hitType;
+    entry->receiver = receiver;
+    entry->surface = surface;
+    entry->distance = distance;
+}
+
+// Everything on the way, the shooter and the adjoins crossed included
+static void sithCollision_SearchRadiusForThings(sithSector* sector, sithThing* thing, rdVector3* from, rdVector3* dir, flex_t dist, flex_t radius, int flags)
+{
+    flex_t wall = Compare_WallHit(from, dir, dist, radius);
+    int i;
+
+    (void)sector;
+    (void)thing;
+    (void)flags;
+    compare_numSearch = 0;
+    compare_searchIdx = 0;
+
+    if (wall >= 0.0f)
+        Compare_AddSearch(SITHCOLLISION_WORLD, NULL, NULL, wall);
+    for (i = 0; i < compare_numThings; i++)
+    {
+        sithThing* other = &compare_aThings[i];
+        flex_t t;
+
+        if (!Compare_InWorld(other))
+            continue;
+        t = Compare_SphereHit(from, dir, dist, radius, &other->position, other->collideSize);
+        if (t >= 0.0f)
+            Compare_AddSearch(SITHCOLLISION_THING, other, NULL, t);
+    }
+    if (dir->x != 0.0f)
+    {
+        for (i = 1; i < COMPARE_SECTORS; i++)
+        {
+            flex_t t = (i * COMPARE_SECTOR_LEN - from->x) / dir->x;
+
+            if (t > 0.0f && t <= dist)
+                Compare_AddSearch(SITHCOLLISION_ADJOINCROSS, NULL, &compare_aAdjoinSurfaces[dir->x > 0.0f ? i : i - 1], t);
+        }
+    }
+}
+
+static sithCollisionSearchEntry* sithCollision_NextSearchResult()
+{
+    if (compare_searchIdx >= compare_numSearch)
+        return NULL;
+    return &compare_aSearch[compare_searchIdx++];
+}
+
+static void sithCollision_SearchClose()
+{
+    compare_numSearch = 0;
+}
+
+// ================================================================
+// Shots, and what the pool did with them
+// ================================================================
+
+enum { COMPARE_EVENT_NONE, COMPARE_EVENT_HIT, COMPARE_EVENT_EXPLODE };
+
+typedef struct CompareEvent
+{
+    int kind;
+    int tick;
+    int sectorIdx;
+    int bOrphan;
+    int lifeLeftMs;
+    flex_t damage;
+    flex_t unk8;
+    rdVector3 pos;
+    rdVector3 end;
+} CompareEvent;
+
+// A shot as its thing would fly
+typedef struct CompareShot
+{
+    int bFlying;
+    int shooterIdx;
+    int shooterSignature;
+    int sectorIdx;
+    rdVector3 pos;
+    rdVector3 vel;
+    flex_t damage;
+    flex_t decayRate;
+    flex_t minDamage;
+    flex_t lifeLeft;
+    flex_t extraSecs;
+    flex_t unk8;
+    int typeflags;
+    int draws;
+} CompareShot;
+
+// One template per shot, so whatever the pool hands back names its shot
+static sithThing compare_aTemplates[COMPARE_MAX_SHOTS];
+static CompareShot compare_aShots[COMPARE_MAX_SHOTS];
+static CompareEvent compare_aActual[COMPARE_MAX_SHOTS];
+static int compare_numShots;
+
+static sithThing compare_aCreated[COMPARE_MAX_CREATED];
+static int compare_aCreatedShot[COMPARE_MAX_CREATED];
+static sithThing* compare_aCreatedParent[COMPARE_MAX_CREATED];
+static int compare_numCreated;
+
+static int compare_tick;
+static long compare_drawMismatches;
+static rdVector3 compare_aDrawPos[COMPARE_MAX_SHOTS];
+
+static int Compare_ShotOf(const sithThing* projectileTemplate)
+{
+    return (int)(projectileTemplate - compare_aTemplates);
+}
+
+static sithThing* sithThing_Create(sithThing* templateThing, rdVector3* position, rdMatrix34* orient, sithSector* sector, sithThing* parent)
+{
+    int idx = compare_numCreated++ % COMPARE_MAX_CREATED;
+    sithThing* thing = &compare_aCreated[idx];
+
+    (void)orient;
+    *thing = *templateThing;
+    thing->position = *position;
+    thing->sector = sector;
+    compare_aCreatedShot[idx] = Compare_ShotOf(templateThing);
+    compare_aCreatedParent[idx] = parent;
+    return thing;
+}
+
+static CompareEvent* Compare_Record(sithThing* thing, int kind)
+{
+    int idx = (int)(thing - compare_aCreated);
+    CompareEvent* ev = &compare_aActual[compare_aCreatedShot[idx]];
+
+    ev->kind = ev->kind ? -1 : kind;    // -1: promoted twice
+    ev->tick = compare_tick;
+    ev->sectorIdx = (int)(thing->sector - compare_aSectors);
+    ev->bOrphan = compare_aCreatedParent[idx] == NULL;
+    ev->lifeLeftMs = thing->lifeLeftMs;
+    ev->damage = thing->weaponParams.damage;
+    ev->unk8 = thing->weaponParams.unk8;
+    ev->pos = thing->position;
+    ev->end = thing->position;
+    return ev;
+}
+
+static void sithCollision_UpdateThingCollision(sithThing* thing, rdVector3* dir, flex_t dist, int physflags)
+{
+    CompareEvent* ev = Compare_Record(thing, COMPARE_EVENT_HIT);
+
+    (void)physflags;
+    ev->end.x += dir->x * dist;
+    ev->end.y += dir->y * dist;
+    ev->end.z += dir->z * dist;
+}
+
+static void sithWeapon_RemoveAndExplode(sithThing* thing, sithThing* explodeTemplate)
+{
+    Compare_Record(thing, explodeTemplate == &compare_explodeTemplate ? COMPARE_EVENT_EXPLODE : -1);
+}
+
+static void rdThing_Draw(rdThing* rdthing, rdMatrix34* mat)
+{
+    sithThing* projectileTemplate = (sithThing*)((char*)rdthing - offsetof(sithThing, rdthing));
+    int shot = Compare_ShotOf(projectileTemplate);
+
+    if (shot < 0 || shot >= compare_numShots)
+    {
+        compare_drawMismatches++;
+        return;
+    }
+    compare_aShots[shot].draws++;
+    compare_aDrawPos[shot] = mat->scale;
+}
+
+// ================================================================
+// Driver
+// ================================================================
+
+static uint32_t compare_seed = 1;
+
+static float Compare_Rand()
+{
+    compare_seed = compare_seed * 1664525u + 1013904223u;
+    return (float)(compare_seed >> 8) / 16777216.0f;
+}
+
+static float Compare_Range(float lo, float hi)
+{
+    return lo + (hi - lo) * Compare_Rand();
+}
+
+static void Compare_RandomPos(rdVector3* pos)
+{
+    pos->x = Compare_Range(0.5f, COMPARE_SECTORS * COMPARE_SECTOR_LEN - 0.5f);
+    pos->y = Compare_Range(-COMPARE_HALF_HEIGHT + 0.5f, COMPARE_HALF_HEIGHT - 0.5f);
+    pos->z = Compare_Range(-COMPARE_HALF_HEIGHT + 0.5f, COMPARE_HALF_HEIGHT - 0.5f);
+}
+
+static void Compare_MakeTemplate(sithThing* projectileTemplate, int kind)
+{
+    memset(projectileTemplate, 0, sizeof(*projectileTemplate));
+    projectileTemplate->type = SITH_THING_WEAPON;
+    projectileTemplate->moveType = SITH_MT_PHYSICS;
+    projectileTemplate->lifeLeftMs = (int)Compare_Range(300.0f, 4000.0f);
+    projectileTemplate->moveSize = Compare_Range(0.0f, 0.05f);
+    projectileTemplate->physicsParams.vel.y = Compare_Range(2.0f, 12.0f);
+    projectileTemplate->weaponParams.damage = Compare_Range(5.0f, 50.0f);
+    projectileTemplate->weaponParams.unk8 = Compare_Range(0.5f, 3.0f);
+    projectileTemplate->weaponParams.explodeTemplate = &compare_explodeTemplate;
+
+    switch (kind)
+    {
+    case COMPARE_KIND_DECAY:
+        projectileTemplate->weaponParams.typeflags = SITH_WF_DAMAGE_DECAY;
+        projectileTemplate->weaponParams.rate = Compare_Range(5.0f, 60.0f);
+        projectileTemplate->weaponParams.mindDamage = Compare_Range(0.0f, 5.0f);
+        break;
+    case COMPARE_KIND_TIMED:
+        projectileTemplate->weaponParams.typeflags = SITH_WF_EXPLODE_AT_TIMER_TIMEOUT;
+        projectileTemplate->lifeLeftMs = (int)Compare_Range(100.0f, 800.0f);
+        break;
+    case COMPARE_KIND_GRAVITY:
+        projectileTemplate->physicsParams.physflags = SITH_PF_USEGRAVITY;
+        break;
+    case COMPARE_KIND_COG:
+        projectileTemplate->class_cog = &compare_cog;
+        break;
+    case COMPARE_KIND_PROXIMITY:
+        projectileTemplate->weaponParams.typeflags = SITH_WF_PROXIMITY;
+        break;
+    }
+}
+
+// What sithWeapon_FireProjectile_0 would make of it, if the pool may
+// take it: 0 if not
+static int Compare_Fire(CompareShot* shot, sithThing* shooter, sithThing* projectileTemplate, rdVector3* dir, rdVector3* firePos, flex_t scale, int scaleFlags, flex_t deltaSecs, int numFlying, int kind)
+{
+    rdMatrix34 orient;
+    rdVector3 toFirePos;
+    flex_t fireDist;
+
+    if (numFlying == SITHPROJECTILE_MAX || kind >= COMPARE_KIND_GRAVITY)
+        return 0;
+    rdVector_Sub3(&toFirePos, firePos, &shooter->position);
+    fireDist = rdVector_Normalize3Acc(&toFirePos);
+    if (fireDist > 0.0f && Compare_FirstHit(&shooter->position, &toFirePos, fireDist, projectileTemplate->moveSize, shooter) >= 0.0f)
+        return 0;
+
+    memset(shot, 0, sizeof(*shot));
+    shot->bFlying = 1;
+    shot->shooterIdx = (int)(shooter - compare_aThings);
+    shot->shooterSignature = shooter->signature;
+    shot->sectorIdx = Compare_SectorIdx(firePos->x);
+    shot->pos = *firePos;
+    rdMatrix_BuildFromLook34(&orient, dir);
+    rdMatrix_TransformVector34(&shot->vel, &projectileTemplate->physicsParams.vel, &orient);
+    shot->damage = projectileTemplate->weaponParams.damage;
+    shot->unk8 = projectileTemplate->weaponParams.unk8;
+    if (scaleFlags & 1)
+        rdVector_Scale3Acc(&shot->vel, scale);
+    if (scaleFlags & 2)
+        shot->damage *= scale;
+    if (scaleFlags & 4)
+        shot->damage *= scale;
+    if (scaleFlags & 8)
+        shot->unk8 *= scale;
+    shot->typeflags = projectileTemplate->weaponParams.typeflags;
+    shot->decayRate = (shot->typeflags & SITH_WF_DAMAGE_DECAY) ? projectileTemplate->weaponParams.rate : 0.0f;
+    shot->minDamage = projectileTemplate->weaponParams.mindDamage;
+    shot->lifeLeft = (flex_t)projectileTemplate->lifeLeftMs * 0.001;
+    shot->extraSecs = deltaSecs > 0.02 ? deltaSecs : 0.0f;
+    return 1;
+}
+
+// One tick of the shot's thing; fills ev when it stops flying
+static void Compare_Tick(CompareShot* shot, flex_t deltaSecs, CompareEvent* ev)
+{
+    sithThing* shooter = &compare_aThings[shot->shooterIdx];
+    flex_t stepSecs = deltaSecs + shot->extraSecs;
+    flex_t decayed = shot->damage - shot->decayRate * deltaSecs;
+    rdVector3 step, dir;
+    flex_t dist;
+
+    step.x = shot->vel.x * stepSecs;
+    step.y = shot->vel.y * stepSecs;
+    step.z = shot->vel.z * stepSecs;
+    shot->extraSecs = 0.0f;
+    if (shot->damage > shot->minDamage)
+        shot->damage = decayed <= 0.0 ? shot->minDamage : decayed;
+    shot->lifeLeft -= deltaSecs;
+
+    memset(ev, 0, sizeof(*ev));
+    if (shot->lifeLeft <= 0.0)
+    {
+        shot->bFlying = 0;
+        if (!(shot->typeflags & SITH_WF_EXPLODE_AT_TIMER_TIMEOUT))
+            return;
+        ev->kind = COMPARE_EVENT_EXPLODE;
+        ev->end = shot->pos;
+    }
+    else
+    {
+        dir = step;
+        dist = rdVector_Normalize3Acc(&dir);
+        if (dist <= 0.0f)
+            return;
+        if (Compare_FirstHit(&shot->pos, &dir, dist, compare_aTemplates[shot - compare_aShots].moveSize, shooter) < 0.0f)
+        {
+            shot->pos.x += step.x;
+            shot->pos.y += step.y;
+            shot->pos.z += step.z;
+            shot->sectorIdx = Compare_SectorIdx(shot->pos.x);
+            return;
+        }
+        shot->bFlying = 0;
+        ev->kind = COMPARE_EVENT_HIT;
+        ev->end.x = shot->pos.x + dir.x * dist;
+        ev->end.y = shot->pos.y + dir.y * dist;
+        ev->end.z = shot->pos.z + dir.z * dist;
+    }
+
+    ev->sectorIdx = shot->sectorIdx;
+    ev->bOrphan = shooter->signature != shot->shooterSignature || shooter->type == SITH_THING_FREE;
+    ev->lifeLeftMs = (int)(shot->lifeLeft * 1000.0);
+    if (ev->lifeLeftMs <= 0)
+        ev->lifeLeftMs = 1;
+    ev->damage = shot->damage;
+    ev->unk8 = shot->unk8;
+    ev->pos = shot->pos;
+}
+
+static int Compare_Near(const rdVector3* a, const rdVector3* b)
+{
+    return fabsf(a->x - b->x) < 1e-4f && fabsf(a->y - b->y) < 1e-4f && fabsf(a->z - b->z) < 1e-4f;
+}
+
+static int Compare_SameEvent(const CompareEvent* expected, const CompareEvent* actual)
+{
+    return expected->kind == actual->kind
+        && actual->tick == compare_tick
+        && expected->sectorIdx == actual->sectorIdx
+        && expected->bOrphan == actual->bOrphan
+        && expected->lifeLeftMs == actual->lifeLeftMs
+        && expected->damage == actual->damage
+        && expected->unk8 == actual->unk8
+        && Compare_Near(&expected->pos, &actual->pos)
+        && Compare_Near(&expected->end, &actual->end);
+}
+
+int main(int argc, char** argv)
+{
+    int numShooters = 16;
+    int numTargets = 32;
+    float rate = 4.0f;
+    float seconds = 60.0f;
+    float hz = 50.0f;
+    long fired = 0, pooled = 0, refused = 0, hits = 0, explosions = 0, expired = 0, orphans = 0, draws = 0;
+    long fireMismatches = 0, eventMismatches = 0, countMismatches = 0;
+    int numFlying = 0;
+    int numTicks, i;
+    float dt;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "--shooters"))
+            numShooters = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--targets"))
+            numTargets = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--rate"))
+            rate = (float)atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seconds"))
+            seconds = (float)atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--hz"))
+            hz = (float)atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seed"))
+            compare_seed = (uint32_t)atoi(argv[i + 1]);
+    }
+    if (numShooters < 1)
+        numShooters = 1;
+    if (numShooters > COMPARE_MAX_SHOOTERS)
+        numShooters = COMPARE_MAX_SHOOTERS;
+    if (numTargets < 0)
+        numTargets = 0;
+    if (numTargets > COMPARE_MAX_TARGETS)
+        numTargets = COMPARE_MAX_TARGETS;
+
+    dt = 1.0f / hz;
+    numTicks = (int)(seconds * hz);
+
+    for (i = 0; i < COMPARE_SECTORS; i++)
+    {
+        compare_aAdjoins[i].sector = &compare_aSectors[i];
+        compare_aAdjoinSurfaces[i].adjoin = &compare_aAdjoins[i];
+    }
+    compare_numThings = numShooters + numTargets;
+    for (i = 0; i < compare_numThings; i++)
+    {
+        sithThing* thing = &compare_aThings[i];
+
+        thing->type = SITH_THING_ACTOR;
+        thing->signature = i + 1;
+        thing->collideSize = i < numShooters ? 0.2f : Compare_Range(0.1f, 0.4f);
+        Compare_RandomPos(&thing->position);
+        thing->sector = &compare_aSectors[Compare_SectorIdx(thing->position.x)];
+    }
+
+    for (compare_tick = 0; compare_tick < numTicks; compare_tick++)
+    {
+        int numVisible = 0;
+
+        // Now and then a shooter dies, and its slot is soon reused
+        for (i = 0; i < numShooters; i++)
+        {
+            sithThing* shooter = &compare_aThings[i];
+
+            if (Compare_Rand() < (shooter->type == SITH_THING_FREE ? 0.05f : 0.002f))
+            {
+                if (shooter->type == SITH_THING_FREE)
+                {
+                    shooter->type = SITH_THING_ACTOR;
+                    shooter->signature += COMPARE_MAX_THINGS;
+                }
+                else
+                {
+                    shooter->type = SITH_THING_FREE;
+                }
+            }
+        }
+
+        // Fire
+        for (i = 0; i < numShooters && compare_numShots < COMPARE_MAX_SHOTS; i++)
+        {
+            sithThing* shooter = &compare_aThings[i];
+            sithThing* projectileTemplate = &compare_aTemplates[compare_numShots];
+            CompareShot* shot = &compare_aShots[compare_numShots];
+            rdVector3 dir, firePos;
+            flex_t scale, deltaSecs, offset;
+            int kind, scaleFlags, bExpected, bPooled;
+
+            if (shooter->type == SITH_THING_FREE || Compare_Rand() >= rate * dt)
+                continue;
+
+            kind = (int)(Compare_Rand() * COMPARE_KINDS);
+            Compare_MakeTemplate(projectileTemplate, kind);
+            dir.x = Compare_Range(-1.0f, 1.0f);
+            dir.y = Compare_Range(-1.0f, 1.0f);
+            dir.z = Compare_Range(-0.3f, 0.3f);
+            if (rdVector_Normalize3Acc(&dir) == 0.0f)
+                dir.x = 1.0f;
+            offset = Compare_Range(0.0f, 0.5f);
+            firePos.x = shooter->position.x + dir.x * offset;
+            firePos.y = shooter->position.y + dir.y * offset;
+            firePos.z = shooter->position.z + dir.z * offset;
+            scale = Compare_Range(0.5f, 2.0f);
+            scaleFlags = (int)(Compare_Rand() * 16);
+            deltaSecs = Compare_Rand() < 0.5f ? 0.0f : Compare_Range(0.0f, 0.05f);
+
+            memset(&compare_aActual[compare_numShots], 0, sizeof(compare_aActual[0]));
+            bExpected = Compare_Fire(shot, shooter, projectileTemplate, &dir, &firePos, scale, scaleFlags, deltaSecs, numFlying, kind);
+            bPooled = sithProjectile_Fire(shooter, projectileTemplate, &dir, &firePos, scale, scaleFlags, deltaSecs);
+            if (bPooled != bExpected)
+                fireMismatches++;
+            if (!bExpected)
+                shot->bFlying = 0;
+
+            fired++;
+            pooled += bPooled;
+            refused += !bPooled;
+            numFlying += bExpected;
+            compare_numShots++;
+        }
+
+        // Fly
+        sithProjectile_Tick(dt);
+        for (i = 0; i < compare_numShots; i++)
+        {
+            CompareShot* shot = &compare_aShots[i];
+            CompareEvent expected;
+
+            if (!shot->bFlying)
+                continue;
+
+            Compare_Tick(shot, dt, &expected);
+            if (shot->bFlying)
+            {
+                if (compare_aActual[i].kind)
+                    eventMismatches++;
+                continue;
+            }
+
+            numFlying--;
+            if (!expected.kind)
+            {
+                expired++;
+                if (compare_aActual[i].kind)
+                    eventMismatches++;
+                continue;
+            }
+            if (!Compare_SameEvent(&expected, &compare_aActual[i]))
+                eventMismatches++;
+            hits += expected.kind == COMPARE_EVENT_HIT;
+            explosions += expected.kind == COMPARE_EVENT_EXPLODE;
+            orphans += expected.bOrphan;
+        }
+        if (sithProjectile_pool.numProjectiles != numFlying)
+            countMismatches++;
+
+        // Draw, with about half the sectors in view
+        sithRender_lastRenderTick++;
+        for (i = 0; i < COMPARE_SECTORS; i++)
+        {
+            if (Compare_Rand() < 0.5f)
+                compare_aSectors[i].renderTick = sithRender_lastRenderTick;
+        }
+        for (i = 0; i < compare_numShots; i++)
+            compare_aShots[i].draws = 0;
+        sithProjectile_Draw();
+        for (i = 0; i < compare_numShots; i++)
+        {
+            CompareShot* shot = &compare_aShots[i];
+            int bVisible = shot->bFlying && compare_aSectors[shot->sectorIdx].renderTick == sithRender_lastRenderTick;
+
+            if (shot->draws != bVisible || (bVisible && !Compare_Near(&compare_aDrawPos[i], &shot->pos)))
+                compare_drawMismatches++;
+            numVisible += bVisible;
+        }
+        draws += numVisible;
+    }
+
+    printf("{\n");
+    printf("  \"shooters\": %d,\n", numShooters);
+    printf("  \"targets\": %d,\n", numTargets);
+    printf("  \"ticks\": %d,\n", numTicks);
+    printf("  \"fired\": %ld,\n", fired);
+    printf("  \"pooled\": %ld,\n", pooled);
+    printf("  \"refused\": %ld,\n", refused);
+    printf("  \"hits\": %ld,\n", hits);
+    printf("  \"timedExplosions\": %ld,\n", explosions);
+    printf("  \"expired\": %ld,\n", expired);
+    printf("  \"orphans\": %ld,\n", orphans);
+    printf("  \"draws\": %ld,\n", draws);
+    printf("  \"fireMismatches\": %ld,\n", fireMismatches);
+    printf("  \"eventMismatches\": %ld,\n", eventMismatches);
+    printf("  \"countMismatches\": %ld,\n", countMismatches);
+    printf("  \"drawMismatches\": %ld\n", compare_drawMismatches);
+    printf("}\n");
+
+    return (fireMismatches || eventMismatches || countMismatches || compare_drawMismatches) ? 1 : 0;
+}
@@ -0,0 +1,48 @@
+#include "sithSweep.h"
+
+#ifndef SITHSWEEP_STANDALONE
+#include "World/sithThing.h"
+#include "Engine/sithCollision.h"
+#include "jk.h"
+#endif
+
+// Moves a physics weapon by step (velocityMaybe, deltaSeconds worth).
+// Returns 0 for things that can't ricochet; those are moved the usual
+// way.
+//
+// This relies on sithCollision_UpdateThingCollision stopping at the
+// first hit whose handler turns the velocity, and returning how far it
+// got. If it went on along the reflected velocity by itself, every
+// ricochet here would spend the rest of the step twice.
+int sithSweep_Move(sithThing* weapon, rdVector3* step, flex_t deltaSeconds)
+{
+    rdVector3 dir;
+    flex_t dist, moved, timeLeft;
+    int numBounces;
+    int i;
+
+    if (weapon->type != SITH_THING_WEAPON || weapon->moveType != SITH_MT_PHYSICS || deltaSeconds <= 0.0)
+        return 0;
+    if (!(weapon->weaponParams.typeflags & (SITH_WF_RICOCHET_OFF_SURFACE | SITH_WF_IMPACT_SOUND_FX)))
+        return 0;
+
+    timeLeft = deltaSeconds;
+    dist = rdVector_Normalize3(&dir, step);
+    for (i = 0; i < SITHSWEEP_MAX_SWEEPS && dist > 0.0; i++)
+    {
+        numBounces = weapon->weaponParams.numDeflectionBounces;
+        moved = sithCollision_UpdateThingCollision(weapon, &dir, dist, weapon->physicsParams.physflags);
+
+        // Went the whole way, or hit something it doesn't bounce off
+        if (weapon->weaponParams.numDeflectionBounces == numBounces
+            || (weapon->thingflags & (SITH_TF_DEAD | SITH_TF_WILLBEREMOVED))
+            || weapon->moveType != SITH_MT_PHYSICS)
+            break;
+
+        if (moved > dist)
+            moved = dist;
+        timeLeft -= timeLeft * (moved / dist);
+        dist = rdVector_Normalize3(&dir, &weapon->physicsParams.vel) * timeLeft;
+    }
+    return 1;
+}
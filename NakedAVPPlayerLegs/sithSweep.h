@@ -0,0 +1,36 @@
+#ifndef _SITHSWEEP_H
+#define _SITHSWEEP_H
+
+#ifndef SITHSWEEP_STANDALONE
+#include "types.h"
+#include "globals.h"
+#endif
+
+// Added: ricochets swept at the time of impact (CONTINUOUS_COLLISION).
+//
+// sithWeapon_Collide and sithWeapon_HitDebug turn a weapon's velocity
+// when it ricochets, but the sweep that found the hit was built from the
+// old velocity, so the rest of the step went the wrong way or was lost.
+// At a low tick rate that is a long way: bolts bounced late or ended up
+// past thin walls. sithSweep_Move splits the step at every ricochet and
+// sweeps what is left of the tick's time from the hit along the new
+// velocity, in up to SITHSWEEP_MAX_SWEEPS sweeps.
+//
+// Hooks: sithWeapon_FireProjectile_0 moves its fire-rate catch-up step
+// through sithSweep_Move. The per-tick move is in sithThing_TickPhysics
+// (outside this tree), which normalizes velocityMaybe after
+// sithPhysics_ThingTick and hands it to sithCollision_UpdateThingCollision.
+// With CONTINUOUS_COLLISION that call must become
+//
+//     if (!sithSweep_Move(thing, &thing->physicsParams.velocityMaybe, deltaSecs))
+//         sithCollision_UpdateThingCollision(thing, &dir, dist, thing->physicsParams.physflags);
+//
+// or only the catch-up step is swept. sithSweep_Move returns 0 for
+// anything but a physics weapon that can ricochet, so the call needs no
+// type check of its own.
+
+#define SITHSWEEP_MAX_SWEEPS (4)
+
+MATH_FUNC int sithSweep_Move(sithThing* weapon, rdVector3* step, flex_t deltaSeconds);
+
+#endif // _SITHSWEEP_H
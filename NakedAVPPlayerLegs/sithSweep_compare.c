@@ -0,0 +1,368 @@
+// ================================================================
+// File: sithSweep_compare.c
+// Check of the ricochet sweeps (sithSweep) against the exact path
+//
+// Bolts that ricochet are fired around box rooms and stepped at a low
+// tick rate through sithSweep_Move. Walls reflect a bolt the way
+// sithWeapon_HitDebug does, and sithCollision_UpdateThingCollision is
+// stood in for as sithSweep.c assumes it works: it stops at a ricochet
+// and returns how far it got. Every step is compared with the exact path
+// of a sphere bouncing in a box (each axis folded back at the walls),
+// and checks that:
+//
+// - the bolt ends each step where the exact path does, with the same
+//   velocity and the same number of bounces, up to SITHSWEEP_MAX_SWEEPS - 1
+//   bounces in one step;
+// - nothing is swept for a weapon that can't ricochet, a non-weapon or a
+//   zero step; those are left to the usual move.
+//
+// The same steps moved the old way (one sweep per step) are measured
+// too, as oldMaxError.
+//
+// Results are printed as JSON; the exit code is non-zero on a mismatch.
+//
+// Build:
+//   cc -O2 sithSweep_compare.c -lm -o sithSweep_compare
+//
+// Usage:
+//   sithSweep_compare [--bolts N] [--ticks N] [--hz H] [--seed N]
+// ================================================================
+
+#define SITHSWEEP_STANDALONE
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ================================================================
+// Stand-ins for the engine types and functions sithSweep.c uses
+// ================================================================
+
+typedef float flex_t;
+#define MATH_FUNC
+
+typedef struct { flex_t x, y, z; } rdVector3;
+typedef struct { int physflags; rdVector3 vel; } sithPhysicsParams;
+typedef struct { int typeflags; int numDeflectionBounces; } sithWeaponParams;
+typedef struct sithThing
+{
+    int type;
+    int moveType;
+    int thingflags;
+    flex_t moveSize;
+    rdVector3 position;
+    sithPhysicsParams physicsParams;
+    sithWeaponParams weaponParams;
+} sithThing;
+
+enum { SITH_THING_FREE = 0, SITH_THING_ACTOR = 2, SITH_THING_WEAPON = 3 };
+
+#define SITH_MT_PHYSICS                 (1)
+#define SITH_TF_DEAD                    (0x1)
+#define SITH_TF_WILLBEREMOVED           (0x2)
+#define SITH_WF_IMPACT_SOUND_FX         (0x1)
+#define SITH_WF_RICOCHET_OFF_SURFACE    (0x2)
+
+static flex_t rdVector_Normalize3(rdVector3* out, const rdVector3* v)
+{
+    flex_t len = sqrtf(v->x*v->x + v->y*v->y + v->z*v->z);
+
+    *out = *v;
+    if (len > 0.0f)
+    {
+        out->x /= len;
+        out->y /= len;
+        out->z /= len;
+    }
+    return len;
+}
+
+static flex_t sithCollision_UpdateThingCollision(sithThing* thing, rdVector3* dir, flex_t dist, int physflags);
+
+#include "sithSweep.c"
+
+// ================================================================
+// The room: a box centered on the origin, and the bolt's walls inside it
+// ================================================================
+
+#define COMPARE_MAX_BOLTS   (1024)
+
+static rdVector3 compare_halfSize;
+static long compare_calls;
+
+// Walls as the bolt's center sees them: the room less its moveSize
+static void Compare_Bounds(const sithThing* thing, flex_t* lo, flex_t* hi)
+{
+    lo[0] = -compare_halfSize.x + thing->moveSize;
+    lo[1] = -compare_halfSize.y + thing->moveSize;
+    lo[2] = -compare_halfSize.z + thing->moveSize;
+    hi[0] = -lo[0];
+    hi[1] = -lo[1];
+    hi[2] = -lo[2];
+}
+
+// Moves to the first wall on the way, bounces off it as
+// sithWeapon_HitDebug does and stops there
+static flex_t sithCollision_UpdateThingCollision(sithThing* thing, rdVector3* dir, flex_t dist, int physflags)
+{
+    flex_t* pos = &thing->position.x;
+    flex_t* vel = &thing->physicsParams.vel.x;
+    const flex_t* d = &dir->x;
+    flex_t lo[3], hi[3];
+    flex_t best = dist;
+    int bestAxis = -1;
+    int axis;
+
+    (void)physflags;
+    compare_calls++;
+    Compare_Bounds(thing, lo, hi);
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        flex_t t;
+
+        if (d[axis] > 0.0f)
+            t = (hi[axis] - pos[axis]) / d[axis];
+        else if (d[axis] < 0.0f)
+            t = (lo[axis] - pos[axis]) / d[axis];
+        else
+            continue;
+        if (t < 0.0f)
+            t = 0.0f;
+        if (t < best)
+        {
+            best = t;
+            bestAxis = axis;
+        }
+    }
+
+    for (axis = 0; axis < 3; axis++)
+        pos[axis] += d[axis] * best;
+    if (bestAxis < 0)
+        return dist;
+
+    // Snapped onto the wall, as the hit handler leaves it
+    pos[bestAxis] = d[bestAxis] > 0.0f ? hi[bestAxis] : lo[bestAxis];
+    if (thing->weaponParams.typeflags & SITH_WF_RICOCHET_OFF_SURFACE)
+    {
+        thing->weaponParams.numDeflectionBounces++;
+        vel[bestAxis] = -vel[bestAxis];
+    }
+    else
+    {
+        thing->thingflags |= SITH_TF_WILLBEREMOVED;
+    }
+    return best;
+}
+
+// Where the exact path is after secs: each axis runs back and forth
+// between its walls. Returns the number of bounces.
+static int Compare_Exact(const sithThing* thing, double secs, double* pos, double* vel)
+{
+    flex_t lo[3], hi[3];
+    int numBounces = 0;
+    int axis;
+
+    Compare_Bounds(thing, lo, hi);
+    for (axis = 0; axis < 3; axis++)
+    {
+        double span = (double)hi[axis] - lo[axis];
+        double v = (&thing->physicsParams.vel.x)[axis];
+        double p = (&thing->position.x)[axis] - lo[axis] + v * secs;
+        double folds = floor(p / span);
+        double q = p - folds * span;
+        int n = (int)fabs(folds);
+
+        // Odd number of folds: on the way back
+        if (n & 1)
+        {
+            q = span - q;
+            v = -v;
+        }
+        pos[axis] = lo[axis] + q;
+        vel[axis] = v;
+        numBounces += n;
+    }
+    return numBounces;
+}
+
+static uint32_t compare_seed = 1;
+
+static float Compare_Rand()
+{
+    compare_seed = compare_seed * 1664525u + 1013904223u;
+    return (float)(compare_seed >> 8) / 16777216.0f;
+}
+
+static float Compare_Range(float lo, float hi)
+{
+    return lo + (hi - lo) * Compare_Rand();
+}
+
+static void Compare_NewBolt(sithThing* bolt)
+{
+    flex_t lo[3], hi[3];
+
+    memset(bolt, 0, sizeof(*bolt));
+    bolt->type = SITH_THING_WEAPON;
+    bolt->moveType = SITH_MT_PHYSICS;
+    bolt->moveSize = Compare_Range(0.0f, 0.05f);
+    bolt->weaponParams.typeflags = SITH_WF_RICOCHET_OFF_SURFACE;
+    Compare_Bounds(bolt, lo, hi);
+    bolt->position.x = Compare_Range(lo[0], hi[0]);
+    bolt->position.y = Compare_Range(lo[1], hi[1]);
+    bolt->position.z = Compare_Range(lo[2], hi[2]);
+    bolt->physicsParams.vel.x = Compare_Range(-12.0f, 12.0f);
+    bolt->physicsParams.vel.y = Compare_Range(-12.0f, 12.0f);
+    bolt->physicsParams.vel.z = Compare_Range(-4.0f, 4.0f);
+}
+
+// sithSweep_Move must leave these alone
+static long Compare_Refusals()
+{
+    sithThing thing;
+    rdVector3 step = {1.0f, 0.0f, 0.0f};
+    long mismatches = 0;
+
+    Compare_NewBolt(&thing);
+    thing.weaponParams.typeflags = 0;
+    mismatches += sithSweep_Move(&thing, &step, 0.1f) != 0;
+
+    Compare_NewBolt(&thing);
+    thing.type = SITH_THING_ACTOR;
+    mismatches += sithSweep_Move(&thing, &step, 0.1f) != 0;
+
+    Compare_NewBolt(&thing);
+    mismatches += sithSweep_Move(&thing, &step, 0.0f) != 0;
+
+    Compare_NewBolt(&thing);
+    thing.weaponParams.typeflags = SITH_WF_IMPACT_SOUND_FX;
+    mismatches += sithSweep_Move(&thing, &step, 0.1f) != 1;
+
+    return mismatches;
+}
+
+int main(int argc, char** argv)
+{
+    static sithThing bolts[COMPARE_MAX_BOLTS];
+    int numBolts = 256;
+    int numTicks = 300;
+    float hz = 30.0f;
+    long steps = 0, sweeps = 0, bounces = 0, multiBounceSteps = 0, skippedSteps = 0;
+    long mismatches = 0, refusalMismatches;
+    double maxError = 0.0, oldMaxError = 0.0;
+    float dt;
+    int tick, i;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "--bolts"))
+            numBolts = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--ticks"))
+            numTicks = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--hz"))
+            hz = (float)atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seed"))
+            compare_seed = (uint32_t)atoi(argv[i + 1]);
+    }
+    if (numBolts < 1)
+        numBolts = 1;
+    if (numBolts > COMPARE_MAX_BOLTS)
+        numBolts = COMPARE_MAX_BOLTS;
+    dt = 1.0f / hz;
+
+    refusalMismatches = Compare_Refusals();
+
+    compare_halfSize.x = Compare_Range(0.5f, 3.0f);
+    compare_halfSize.y = Compare_Range(0.5f, 3.0f);
+    compare_halfSize.z = Compare_Range(0.3f, 1.0f);
+    for (i = 0; i < numBolts; i++)
+        Compare_NewBolt(&bolts[i]);
+
+    for (tick = 0; tick < numTicks; tick++)
+    {
+        for (i = 0; i < numBolts; i++)
+        {
+            sithThing* bolt = &bolts[i];
+            sithThing old = *bolt;
+            rdVector3 step, oldDir;
+            flex_t oldDist;
+            double pos[3], vel[3], error = 0.0, oldError = 0.0;
+            long calls = compare_calls;
+            int bouncesBefore = bolt->weaponParams.numDeflectionBounces;
+            int numBounces, axis;
+
+            // What sithPhysics_ThingTick leaves in velocityMaybe
+            step.x = bolt->physicsParams.vel.x * dt;
+            step.y = bolt->physicsParams.vel.y * dt;
+            step.z = bolt->physicsParams.vel.z * dt;
+
+            numBounces = Compare_Exact(bolt, dt, pos, vel);
+            if (!sithSweep_Move(bolt, &step, dt))
+            {
+                mismatches++;
+                continue;
+            }
+            sweeps += compare_calls - calls;
+
+            // The old move: one sweep, the rest lost at a bounce
+            oldDist = rdVector_Normalize3(&oldDir, &step);
+            sithCollision_UpdateThingCollision(&old, &oldDir, oldDist, 0);
+
+            for (axis = 0; axis < 3; axis++)
+            {
+                double e = fabs((&bolt->position.x)[axis] - pos[axis]);
+                double o = fabs((&old.position.x)[axis] - pos[axis]);
+
+                if (e > error)
+                    error = e;
+                if (o > oldError)
+                    oldError = o;
+                if (((&bolt->physicsParams.vel.x)[axis] > 0.0f) != (vel[axis] > 0.0) && vel[axis] != 0.0)
+                    error = 1.0;
+            }
+            if (oldError > oldMaxError)
+                oldMaxError = oldError;
+
+            steps++;
+            if (numBounces >= SITHSWEEP_MAX_SWEEPS)
+            {
+                // More bounces than sweeps: the rest of the step is
+                // dropped by design. Start the bolt over from where the
+                // exact path is.
+                skippedSteps++;
+                for (axis = 0; axis < 3; axis++)
+                {
+                    (&bolt->position.x)[axis] = (flex_t)pos[axis];
+                    (&bolt->physicsParams.vel.x)[axis] = (flex_t)vel[axis];
+                }
+                continue;
+            }
+
+            bounces += numBounces;
+            multiBounceSteps += numBounces > 1;
+            if (error > maxError)
+                maxError = error;
+            if (error > 1e-4 || bolt->weaponParams.numDeflectionBounces != bouncesBefore + numBounces)
+                mismatches++;
+        }
+    }
+
+    printf("{\n");
+    printf("  \"bolts\": %d,\n", numBolts);
+    printf("  \"hz\": %.1f,\n", hz);
+    printf("  \"steps\": %ld,\n", steps);
+    printf("  \"bounces\": %ld,\n", bounces);
+    printf("  \"multiBounceSteps\": %ld,\n", multiBounceSteps);
+    printf("  \"tooManyBounces\": %ld,\n", skippedSteps);
+    printf("  \"sweeps\": %ld,\n", sweeps);
+    printf("  \"maxError\": %.7f,\n", maxError);
+    printf("  \"oldMaxError\": %.4f,\n", oldMaxError);
+    printf("  \"refusalMismatches\": %ld,\n", refusalMismatches);
+    printf("  \"mismatches\": %ld\n", mismatches);
+    printf("}\n");
+
+    return (mismatches || refusalMismatches) ? 1 : 0;
+}
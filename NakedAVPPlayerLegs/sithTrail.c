@@ -0,0 +1,117 @@
+#include "sithTrail.h"
+
+#include "World/sithThing.h"
+#include "World/sithSector.h"
+#include "Gameplay/sithTime.h"
+#include "Engine/sithRender.h"
+#include "Engine/rdThing.h"
+#include "jk.h"
+
+typedef struct sithTrail
+{
+    sithThing* trailTemplate;
+    sithSector* sector;
+    rdMatrix34 orient;          // Weapon look orientation, shared by every element
+    rdVector3 origin;
+    flex_t firstDist;
+    flex_t spacing;
+    int count;
+    uint32_t expireMs;
+} sithTrail;
+
+static sithTrail sithTrail_aTrails[SITHTRAIL_MAX_TRAILS];
+static int sithTrail_numTrails;
+
+// A trail thing that only sits there and shows a sprite until its
+// lifetime runs out. Anything it could do as a thing (move, collide, run
+// a cog, light the room, play a create sound) would be lost in the pool,
+// so those keep the old path.
+static int sithTrail_CanPool(sithThing* trailTemplate)
+{
+    if (trailTemplate->rdthing.type != RD_THINGTYPE_SPRITE3)
+        return 0;
+    if (trailTemplate->lifeLeftMs <= 0)
+        return 0;
+    if (trailTemplate->moveType != SITH_MT_NONE || trailTemplate->collide != SITH_COLLIDE_NONE)
+        return 0;
+    if (trailTemplate->class_cog || trailTemplate->soundclass)
+        return 0;
+    if (trailTemplate->thingflags & SITH_TF_LIGHT)
+        return 0;
+
+    return 1;
+}
+
+// Records count elements at origin + lvec * (firstDist + spacing * i).
+// Returns 0 when the template can't be pooled or the pool is full;
+// the caller then creates the things itself.
+int sithTrail_Add(sithThing* trailTemplate, rdVector3* origin, rdMatrix34* orient, flex_t firstDist, flex_t spacing, int count, sithSector* sector)
+{
+    sithTrail* trail;
+
+    if (count <= 0)
+        return 1;
+    if (!sector || !sithTrail_CanPool(trailTemplate))
+        return 0;
+    if (sithTrail_numTrails == SITHTRAIL_MAX_TRAILS)
+        return 0;
+
+    trail = &sithTrail_aTrails[sithTrail_numTrails++];
+    trail->trailTemplate = trailTemplate;
+    trail->sector = sector;
+    _memcpy(&trail->orient, orient, sizeof(trail->orient));
+    rdVector_Copy3(&trail->origin, origin);
+    trail->firstDist = firstDist;
+    trail->spacing = spacing;
+    trail->count = count;
+    trail->expireMs = sithTime_curMs + trailTemplate->lifeLeftMs;
+
+    return 1;
+}
+
+// The whole trail goes at once, as all of its things would have
+void sithTrail_Tick()
+{
+    int i = 0;
+
+    while (i < sithTrail_numTrails)
+    {
+        if ((int32_t)(sithTrail_aTrails[i].expireMs - sithTime_curMs) <= 0)
+            sithTrail_aTrails[i] = sithTrail_aTrails[--sithTrail_numTrails];
+        else
+            i++;
+    }
+}
+
+// From sithRender_Draw after sithRender_RenderThings (see sithTrail.h).
+// One rdThing_Draw per element at its own spot, as the things had.
+void sithTrail_Draw()
+{
+    int i, j;
+
+    for (i = 0; i < sithTrail_numTrails; i++)
+    {
+        sithTrail* trail = &sithTrail_aTrails[i];
+        rdMatrix34 mat;
+        flex_t dist;
+
+        if (trail->sector->renderTick != sithRender_lastRenderTick)
+            continue;
+
+        _memcpy(&mat, &trail->orient, sizeof(mat));
+        dist = trail->firstDist;
+        for (j = 0; j < trail->count; j++)
+        {
+            rdVector_Copy3(&mat.scale, &trail->origin);
+            rdVector_MultAcc3(&mat.scale, &trail->orient.lvec, dist);
+            rdThing_Draw(&trail->trailTemplate->rdthing, &mat);
+            dist += trail->spacing;
+        }
+    }
+}
+
+void sithTrail_Reset()
+{
+    // The templates belong to the world being unloaded
+    sithTrail_numTrails = 0;
+}
@@ -0,0 +1,34 @@
+#ifndef _SITHTRAIL_H
+#define _SITHTRAIL_H
+
+#include "types.h"
+#include "globals.h"
+
+// Added: pooled weapon trails (TRAIL_POOL).
+//
+// An instant-impact weapon with SITH_WF_OBJECT_TRAIL used to create one
+// trailThing every elementSize along its ray, each a full thing with
+// physics, sector membership and a network slot. A straight trail is now
+// one record (start, direction, spacing, count, template) which expires
+// as a unit when the template's lifetime runs out. sithTrail_Draw draws
+// it element by element, one rdThing_Draw of the template per element,
+// as the things were drawn; what goes away is the things, not the draw
+// calls.
+//
+// Only cosmetic sprite templates are pooled (see sithTrail_Add);
+// anything else still gets its things.
+//
+// Render hook: nothing in this tree draws the pool. TRAIL_POOL is off
+// unless defined, and must stay off until sithRender_Draw (outside this
+// tree) calls sithTrail_Draw right after sithRender_RenderThings, while
+// the visible sectors' renderTick is current; without that call pooled
+// trails are invisible.
+
+#define SITHTRAIL_MAX_TRAILS (256)
+
+MATH_FUNC int sithTrail_Add(sithThing* trailTemplate, rdVector3* origin, rdMatrix34* orient, flex_t firstDist, flex_t spacing, int count, sithSector* sector);
+void sithTrail_Tick();
+MATH_FUNC void sithTrail_Draw();
+void sithTrail_Reset();
+
+#endif // _SITHTRAIL_H
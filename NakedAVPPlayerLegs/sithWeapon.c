@@ -29,6 +29,42 @@
 #include "sithDecal.h"
 #endif
 
+#ifdef HITSCAN_BATCHING
+#include "sithHitscan.h"
+#endif
+
+#ifdef TRAIL_POOL
+#include "sithTrail.h"
+#endif
+
+#ifdef AUTOAIM_CACHE
+#include "sithAutoAim.h"
+#endif
+
+#ifdef PROJECTILE_POOL
+#include "sithProjectile.h"
+#endif
+
+#ifdef AWARENESS_COALESCING
+#include "sithAwarenessBatch.h"
+#endif
+
+#ifdef FIRE_NET_BATCHING
+#include "sithFireNet.h"
+#endif
+
+#ifdef CONTINUOUS_COLLISION
+#include "sithSweep.h"
+#endif
+
+#if defined(REGIONAL_DAMAGE) && defined(HITLOC_CAPSULES)
+#include "sithHitLoc.h"
+#endif
+
+#if (defined(DECAL_RENDERING) || defined(RENDER_DROID2)) && defined(DECAL_POOL)
+#include "sithDecalPool.h"
+#endif
+
 #ifdef PUPPET_PHYSICS
 static float sithWeapon_headShotMultiplier = 10.0f;
 #endif
@@ -39,6 +75,36 @@ int sithWeapon_motsAConv[10] = {
     10, 11, 2, 3, 4, 5, 6, 7, 8, 9
 };
 
+// Added: weapon AI awareness events, merged per sector and tick when
+// AWARENESS_COALESCING is on (sithAwarenessBatch.c)
+static void sithWeapon_AddAwareness(sithSector *sector, rdVector3 *pos, int type, flex_t level, sithThing *thing)
+{
+#ifdef AWARENESS_COALESCING
+    sithAwarenessBatch_Add(sector, pos, type, level, thing);
+#else
+    sithAIAwareness_AddEntry(sector, pos, type, level, thing);
+#endif
+}
+
+#ifdef REGIONAL_DAMAGE
+// Added: body part of receiver hit by weapon, dist along its look
+// vector; ray against the puppet's capsules with HITLOC_CAPSULES
+// (sithHitLoc.c), nearest joint to the hit point otherwise
+static int sithWeapon_FindHitLoc(sithThing *weapon, sithThing *receiver, flex_t dist)
+{
+    rdVector3 hitPos;
+
+#ifdef HITLOC_CAPSULES
+    int joint = sithHitLoc_Find(receiver, &weapon->position, &weapon->lookOrientation.lvec);
+    if (joint >= 0)
+        return joint;
+#endif
+    rdVector_Copy3(&hitPos, &weapon->position);
+    rdVector_MultAcc3(&hitPos, &weapon->lookOrientation.lvec, dist);
+    return sithPuppet_FindHitLoc(receiver, &hitPos);
+}
+#endif
+
 void sithWeapon_InitDefaults()
 {
     sithWeapon_bAutoPickup = 1;
@@ -60,6 +126,9 @@ void sithWeapon_InitDefaults()
 void sithWeapon_Startup()
 {
     sithWeapon_InitDefaults();
+#ifdef FIRE_NET_BATCHING
+    sithFireNet_Startup();
+#endif
 }
 
 void sithWeapon_Tick(sithThing* weapon, flex_t deltaSeconds)
@@ -67,6 +136,11 @@ void sithWeapon_Tick(sithThing* weapon, flex_t deltaSeconds)
     sithWeaponFlags_t typeFlags = weapon->weaponParams.typeflags;
     if (typeFlags & SITH_WF_INSTANT_IMPACT) // shooting walls?
     {
+#ifdef HITSCAN_BATCHING
+        // Added: resolved with the rest of its blast (sithHitscan.c)
+        if (sithHitscan_Queue(weapon))
+            return;
+#endif
         sithWeapon_sub_4D35E0(weapon);
     }
     else if (typeFlags & SITH_WF_INSTANT_IMPACT_RANDOM)
@@ -87,32 +161,53 @@ void sithWeapon_Tick(sithThing* weapon, flex_t deltaSeconds)
             weapon->weaponParams.damage = v3;
         }
         if ( (typeFlags & SITH_WF_TRIGGER_AI_AWARENESS) != 0 && (((uint8_t)jkPlayer_currentTickIdx + (weapon->thingIdx & 0xFF)) & 7) == 0 )
-            sithAIAwareness_AddEntry(weapon->sector, &weapon->position, 2, 2.0, weapon);
+            sithWeapon_AddAwareness(weapon->sector, &weapon->position, 2, 2.0, weapon);
     }
 }
 
+// Added: must run once per tick after every thing has ticked, from the
+// end of sithThing_TickAll (outside this tree, see README.md). Without it
+// batched rays never hit, coalesced awareness never reaches the AI,
+// pooled projectiles stop, fire-net shots wait for a full queue and
+// trails and pooled decals never expire.
+void sithWeapon_TickEnd()
+{
+#ifdef HITSCAN_BATCHING
+    sithHitscan_Flush();
+#endif
+#ifdef TRAIL_POOL
+    sithTrail_Tick();
+#endif
+#ifdef PROJECTILE_POOL
+    sithProjectile_Tick(sithTime_deltaSeconds);
+#endif
+#ifdef FIRE_NET_BATCHING
+    sithFireNet_Flush();
+#endif
+#if (defined(DECAL_RENDERING) || defined(RENDER_DROID2)) && defined(DECAL_POOL)
+    sithDecalPool_Tick();
+#endif
+#ifdef AWARENESS_COALESCING
+    // Last: the flushes above can still explode things
+    sithAwarenessBatch_Flush();
+#endif
+}
+
 // MOTS altered: don't affect cog things?
 void sithWeapon_sub_4D35E0(sithThing *weapon)
 {
-    flex_t damage; // ecx
     rdVector3 *weaponPos; // edx
     sithSector *sector; // ebx
     sithCollisionSearchEntry *searchRes; // edi
-    sithThing *damageReceiver; // eax
     sithThing *explodeTemplate; // eax
     sithThing *trailThing; // eax
     flex_d_t v19; // st7
     flex_t moveSize; // [esp-8h] [ebp-40h]
-    flex_t damage_; // [esp+10h] [ebp-28h]
     rdVector3 weaponPos_; // [esp+14h] [ebp-24h] BYREF
-    rdVector3 tmp; // [esp+20h] [ebp-18h] BYREF
-    rdVector3 tmp2; // [esp+2Ch] [ebp-Ch] BYREF
     flex_t elementSize; // [esp+3Ch] [ebp+4h]
 
-    damage = weapon->weaponParams.damage;
     weaponPos = &weapon->lookOrientation.lvec;
     elementSize = weapon->weaponParams.elementSize;
-    damage_ = damage;
     sector = weapon->sector;
     rdVector_Copy3(&weaponPos_, weaponPos);
     moveSize = weapon->moveSize;
@@ -126,14 +221,7 @@ void sithWeapon_sub_4D35E0(sithThing *weapon)
               && weapon->weaponParams.trailThing
               && elementSize < (flex_d_t)searchRes->distance )
             {
-                do
-                {
-                    rdVector_Copy3(&tmp, &weapon->position);
-                    rdVector_MultAcc3(&tmp, &weaponPos_, elementSize);
-                    sithThing_Create(weapon->weaponParams.trailThing, &tmp, &weapon->lookOrientation, sector, 0);
-                    elementSize += weapon->weaponParams.elementSize;
-                }
-                while ( elementSize < searchRes->distance );
+                elementSize = sithWeapon_LayTrail(weapon, &weaponPos_, elementSize, searchRes->distance, sector);
             }
             if ( (searchRes->hitType & SITHCOLLISION_ADJOINCROSS) == 0 )
                 break;
@@ -142,55 +230,7 @@ void sithWeapon_sub_4D35E0(sithThing *weapon)
             if ( !searchRes )
                 goto LABEL_20;
         }
-        if ( (weapon->weaponParams.typeflags & SITH_WF_DAMAGE_DECAY) != 0 )
-        {
-            damage_ = damage_ - weapon->weaponParams.rate * searchRes->distance;
-            if ( weapon->weaponParams.mindDamage > (flex_d_t)damage_ )
-                damage_ = weapon->weaponParams.mindDamage;
-        }
-        if (searchRes->hitType & SITHCOLLISION_THING)
-        {
-			int joint = -1;
-#ifdef REGIONAL_DAMAGE
-			rdVector3 hitPos;
-			rdVector_Copy3(&hitPos, &weapon->position);
-			rdVector_MultAcc3(&hitPos, &weapon->lookOrientation.lvec, searchRes->distance);
-			joint = sithPuppet_FindHitLoc(searchRes->receiver, &hitPos);
-#endif
-			sithThing_Damage(searchRes->receiver, weapon, damage_, weapon->weaponParams.damageClass, joint);
-            if ( weapon->weaponParams.force != 0.0 )
-            {
-                damageReceiver = searchRes->receiver;
-                if ( damageReceiver->moveType == SITH_MT_PHYSICS && !MOTS_ONLY_FLAG(damageReceiver->type == SITH_THING_COG))
-                {
-					float force = weapon->weaponParams.force;
-#ifdef REGIONAL_DAMAGE
-					if (damageReceiver->type == SITH_THING_ACTOR && damageReceiver->actorParams.health <= 0.0f && joint == JOINTTYPE_HEAD) // boost headshots for a knockback effect
-						force += weapon->weaponParams.damage * sithWeapon_headShotMultiplier;
-#endif
-                    rdVector_Scale3(&tmp2, &weaponPos_, force);
-                    sithPhysics_ThingApplyForce(damageReceiver, &tmp2);
-#ifdef PUPPET_PHYSICS
-					if (damageReceiver->physicsParams.physflags & SITH_PF_ANGIMPULSE)
-					{
-						rdVector3 contact = damageReceiver->position;
-						rdVector_MultAcc3(&contact, &searchRes->hitNorm, -damageReceiver->moveSize);
-						sithPhysics_ThingApplyRotForce(damageReceiver, &contact, &tmp2);
-					}
-#endif
-                }
-            }
-        }
-        else if ( (searchRes->hitType & SITHCOLLISION_WORLD) != 0 )
-        {
-            sithSurface_SendDamageToThing(searchRes->surface, weapon, damage_, weapon->weaponParams.damageClass);
-        }
-        if ( weapon->weaponParams.explodeTemplate )
-        {
-            rdVector_Copy3(&tmp2, &weapon->position);
-            rdVector_MultAcc3(&tmp2, &weaponPos_, searchRes->distance);
-            sithThing_Create(weapon->weaponParams.explodeTemplate, &tmp2, &rdroid_identMatrix34, sector, 0);
-        }
+        sithWeapon_InstantImpactHit(weapon, sector, searchRes, &weaponPos_);
     }
 
 LABEL_20:
@@ -200,16 +240,97 @@ LABEL_20:
       && weapon->weaponParams.trailThing
       && elementSize < (flex_d_t)weapon->weaponParams.range )
     {
-        do
+        elementSize = sithWeapon_LayTrail(weapon, &weaponPos_, elementSize, weapon->weaponParams.range, sector);
+    }
+    sithThing_Destroy(weapon);
+}
+
+// Added: trail elements of sithWeapon_sub_4D35E0 from dist up to (not
+// including) end, all in sector. Returns the distance of the next element.
+flex_t sithWeapon_LayTrail(sithThing *weapon, rdVector3 *dir, flex_t dist, flex_t end, sithSector *sector)
+{
+    flex_t elementSize = weapon->weaponParams.elementSize;
+    rdVector3 tmp;
+
+#ifdef TRAIL_POOL
+    flex_t firstDist = dist;
+    int count = 0;
+
+    while ( dist < end )
+    {
+        dist += elementSize;
+        ++count;
+    }
+    if ( sithTrail_Add(weapon->weaponParams.trailThing, &weapon->position, &weapon->lookOrientation, firstDist, elementSize, count, sector) )
+        return dist;
+    dist = firstDist;
+#endif
+
+    while ( dist < end )
+    {
+        rdVector_Copy3(&tmp, &weapon->position);
+        rdVector_MultAcc3(&tmp, dir, dist);
+        sithThing_Create(weapon->weaponParams.trailThing, &tmp, &weapon->lookOrientation, sector, 0);
+        dist += elementSize;
+    }
+    return dist;
+}
+
+// Added: hit handling of sithWeapon_sub_4D35E0, shared with the batched
+// hitscan (sithHitscan.c). dir is the ray direction, sector the sector
+// the ray was in when it hit.
+void sithWeapon_InstantImpactHit(sithThing *weapon, sithSector *sector, sithCollisionSearchEntry *searchRes, rdVector3 *dir)
+{
+    flex_t damage = weapon->weaponParams.damage;
+    sithThing *damageReceiver;
+    rdVector3 tmp2;
+
+    if ( (weapon->weaponParams.typeflags & SITH_WF_DAMAGE_DECAY) != 0 )
+    {
+        damage = damage - weapon->weaponParams.rate * searchRes->distance;
+        if ( weapon->weaponParams.mindDamage > (flex_d_t)damage )
+            damage = weapon->weaponParams.mindDamage;
+    }
+    if (searchRes->hitType & SITHCOLLISION_THING)
+    {
+		int joint = -1;
+#ifdef REGIONAL_DAMAGE
+		joint = sithWeapon_FindHitLoc(weapon, searchRes->receiver, searchRes->distance);
+#endif
+		sithThing_Damage(searchRes->receiver, weapon, damage, weapon->weaponParams.damageClass, joint);
+        if ( weapon->weaponParams.force != 0.0 )
         {
-            rdVector_Copy3(&tmp, &weapon->position);
-            rdVector_MultAcc3(&tmp, &weaponPos_, elementSize);
-            sithThing_Create(weapon->weaponParams.trailThing, &tmp, &weapon->lookOrientation, sector, 0);
-            elementSize += weapon->weaponParams.elementSize;
+            damageReceiver = searchRes->receiver;
+            if ( damageReceiver->moveType == SITH_MT_PHYSICS && !MOTS_ONLY_FLAG(damageReceiver->type == SITH_THING_COG))
+            {
+				float force = weapon->weaponParams.force;
+#ifdef REGIONAL_DAMAGE
+				if (damageReceiver->type == SITH_THING_ACTOR && damageReceiver->actorParams.health <= 0.0f && joint == JOINTTYPE_HEAD) // boost headshots for a knockback effect
+					force += weapon->weaponParams.damage * sithWeapon_headShotMultiplier;
+#endif
+                rdVector_Scale3(&tmp2, dir, force);
+                sithPhysics_ThingApplyForce(damageReceiver, &tmp2);
+#ifdef PUPPET_PHYSICS
+				if (damageReceiver->physicsParams.physflags & SITH_PF_ANGIMPULSE)
+				{
+					rdVector3 contact = damageReceiver->position;
+					rdVector_MultAcc3(&contact, &searchRes->hitNorm, -damageReceiver->moveSize);
+					sithPhysics_ThingApplyRotForce(damageReceiver, &contact, &tmp2);
+				}
+#endif
+            }
         }
-        while ( elementSize < weapon->weaponParams.range );
     }
-    sithThing_Destroy(weapon);
+    else if ( (searchRes->hitType & SITHCOLLISION_WORLD) != 0 )
+    {
+        sithSurface_SendDamageToThing(searchRes->surface, weapon, damage, weapon->weaponParams.damageClass);
+    }
+    if ( weapon->weaponParams.explodeTemplate )
+    {
+        rdVector_Copy3(&tmp2, &weapon->position);
+        rdVector_MultAcc3(&tmp2, dir, searchRes->distance);
+        sithThing_Create(weapon->weaponParams.explodeTemplate, &tmp2, &rdroid_identMatrix34, sector, 0);
+    }
 }
 
 void sithWeapon_sub_4D3920(sithThing *weapon)
@@ -356,10 +477,7 @@ void sithWeapon_sub_4D3920(sithThing *weapon)
         {
 			int joint = -1;
 #ifdef REGIONAL_DAMAGE
-			rdVector3 hitPos;
-			rdVector_Copy3(&hitPos, &weapon->position);
-			rdVector_MultAcc3(&hitPos, &weapon->lookOrientation.lvec, searchRes->distance);
-			joint = sithPuppet_FindHitLoc(searchRes->receiver, &hitPos);
+			joint = sithWeapon_FindHitLoc(weapon, searchRes->receiver, searchRes->distance);
 #endif
             sithThing_Damage(searchRes->receiver, weapon, amount, weapon->weaponParams.damageClass, joint);
             if ( weapon->weaponParams.force != 0.0 )
@@ -531,12 +649,23 @@ sithThing* sithWeapon_FireMots(sithThing *weapon, sithThing *projectile, rdVecto
     sithThing *spawned; // esi
 
     if ( fireSound )
-        sithAIAwareness_AddEntry(weapon->sector, &weapon->position, 1, 4.0, weapon);
+        sithWeapon_AddAwareness(weapon->sector, &weapon->position, 1, 4.0, weapon);
+
+#ifdef FIRE_NET_BATCHING
+    // Added: fired locally as the other machines will see it
+    sithFireNetEvent fireEvent;
+    if ( sithComm_multiplayerFlags )
+        sithFireNet_Prepare(&fireEvent, weapon, fireOffset, aimError);
+#endif
 
     spawned = sithWeapon_FireProjectile_0(weapon, projectile, fireOffset, aimError, fireSound, anim, scale, scaleFlags, a9, 0);
 
     if ( spawned && sithComm_multiplayerFlags )
+#ifdef FIRE_NET_BATCHING
+        sithFireNet_Queue(&fireEvent, projectile, fireSound, anim, scale, scaleFlags, a9, spawned->thing_id, extra);
+#else
         sithDSSThing_SendFireProjectile(weapon, projectile, fireOffset, aimError, fireSound, anim, scale, scaleFlags, a9, spawned->thing_id, INVALID_DPID, 255, extra);
+#endif
 
     return spawned;
 }
@@ -546,12 +675,23 @@ sithThing* sithWeapon_Fire(sithThing *weapon, sithThing *projectile, rdVector3 *
     sithThing *spawned; // esi
 
     if ( fireSound )
-        sithAIAwareness_AddEntry(weapon->sector, &weapon->position, 1, 4.0, weapon);
+        sithWeapon_AddAwareness(weapon->sector, &weapon->position, 1, 4.0, weapon);
+
+#ifdef FIRE_NET_BATCHING
+    // Added: fired locally as the other machines will see it
+    sithFireNetEvent fireEvent;
+    if ( sithComm_multiplayerFlags )
+        sithFireNet_Prepare(&fireEvent, weapon, fireOffset, aimError);
+#endif
 
     spawned = sithWeapon_FireProjectile_0(weapon, projectile, fireOffset, aimError, fireSound, anim, scale, scaleFlags, a9, 0);
 
     if ( spawned && sithComm_multiplayerFlags )
+#ifdef FIRE_NET_BATCHING
+        sithFireNet_Queue(&fireEvent, projectile, fireSound, anim, scale, scaleFlags, a9, spawned->thing_id, 0);
+#else
         sithDSSThing_SendFireProjectile(weapon, projectile, fireOffset, aimError, fireSound, anim, scale, scaleFlags, a9, spawned->thing_id, INVALID_DPID, 255, 0);
+#endif
 
     return spawned;
 }
@@ -630,6 +770,9 @@ sithThing* sithWeapon_FireProjectile_0(sithThing *sender, sithThing *projectileT
             if ( v17 > 0.0 )
             {
                 a6c = v17;
+#ifdef CONTINUOUS_COLLISION
+                if ( !sithSweep_Move(v9, &v9->physicsParams.velocityMaybe, a9) )
+#endif
                 sithCollision_UpdateThingCollision(v9, &a5a, a6c, v9->physicsParams.physflags);
             }
         }
@@ -653,6 +796,15 @@ sithThing* sithWeapon_FireProjectile_0(sithThing *sender, sithThing *projectileT
     }
 
 LABEL_31:
+    sithWeapon_FireEffects(sender, fireSound, anim);
+
+    return v9;
+}
+
+// Added: fire sound and shooter animation of sithWeapon_FireProjectile_0,
+// shared with pooled projectiles
+void sithWeapon_FireEffects(sithThing *sender, sithSound *fireSound, int anim)
+{
     if ( fireSound ) {
         sithSoundMixer_PlaySoundPosThing(fireSound, sender, 1.0, 1.0, 4.0, SITHSOUNDFLAG_FOLLOWSTHING|SITHSOUNDFLAG_HIGHPRIO);
     }
@@ -662,9 +814,23 @@ LABEL_31:
             sithPuppet_PlayMode(sender, anim, 0);
         }
     }
+}
 
-    return v9;
+#ifdef PROJECTILE_POOL
+// Added: sithWeapon_FireProjectile_0 for a cog that passed
+// SITHPROJECTILE_FIRE_POOLED. Returns 0 if the projectile can't be
+// pooled (see sithProjectile.c) and has to be a thing after all.
+static int sithWeapon_FirePooled(sithThing *sender, sithThing *projectileTemplate, rdVector3 *dir, rdVector3 *firePos, sithSound *fireSound, int anim, flex_t scale, int16_t scaleFlags, flex_t deltaSecs)
+{
+    if ( (scaleFlags & SITHPROJECTILE_FIRE_POOLED) == 0 )
+        return 0;
+    if ( !sithProjectile_Fire(sender, projectileTemplate, dir, firePos, scale, scaleFlags, deltaSecs) )
+        return 0;
+
+    sithWeapon_FireEffects(sender, fireSound, anim);
+    return 1;
 }
+#endif
 
 void sithWeapon_SetTimeLeft(sithThing *weapon, sithThing* a2, flex_t timeLeft)
 {
@@ -680,6 +846,7 @@ void sithWeapon_SetTimeLeft(sithThing *weapon, sithThing* a2, flex_t timeLeft)
 }
 
 
+
 #if defined(DECAL_RENDERING) || defined(RENDER_DROID2)
 void sithWeapon_WallHitExplode(sithThing* weapon, sithThing* hitTemplate, sithCollisionSearchEntry* collideInfo)
 {
@@ -697,12 +864,22 @@ void sithWeapon_WallHitExplode(sithThing* weapon, sithThing* hitTemplate, sithCo
 		rdMatrix_BuildFromLook34(&orient, &lookVec);
 
 		sithThing* player = sithThing_GetParent(weapon);
+#ifdef DECAL_POOL
+		// Added: decals go to the pool, merged and evicted there
+		// (sithDecalPool.c); the AI still hears the impact
+		if (sithDecalPool_Add(hitTemplate, &weapon->position, &orient, weapon->sector, collideInfo->surface))
+		{
+			if (player == sithPlayer_pLocalPlayerThing || player->type == SITH_THING_PLAYER)
+				sithWeapon_AddAwareness(weapon->sector, &weapon->position, 0, 2.0, player);
+			return;
+		}
+#endif
 		sithThing* spawned = sithThing_Create(hitTemplate, &weapon->position, &orient, weapon->sector, player);
 		if (spawned)
 		{
 			// Added: second comparison, co-op
 			if (player == sithPlayer_pLocalPlayerThing || player->type == SITH_THING_PLAYER)
-				sithAIAwareness_AddEntry(spawned->sector, &spawned->position, 0, 2.0, player);
+				sithWeapon_AddAwareness(spawned->sector, &spawned->position, 0, 2.0, player);
 
 			if (weapon->thingflags & SITH_TF_INVULN)
 				spawned->thingflags |= SITH_TF_INVULN;
@@ -782,10 +959,7 @@ int sithWeapon_Collide(sithThing *physicsThing, sithThing *collidedThing, sithCo
 		{
 			int joint = -1;
 #ifdef REGIONAL_DAMAGE
-			rdVector3 hitPos;
-			rdVector_Copy3(&hitPos, &physicsThing->position);
-			rdVector_MultAcc3(&hitPos, &physicsThing->lookOrientation.lvec, a4->distance);
-			joint = sithPuppet_FindHitLoc(collidedThing, &hitPos);
+			joint = sithWeapon_FindHitLoc(physicsThing, collidedThing, a4->distance);
 #endif
             sithThing_Damage(collidedThing, physicsThing, physicsThing->weaponParams.damage, physicsThing->weaponParams.damageClass, joint);
 #ifdef PUPPET_PHYSICS
@@ -851,10 +1025,7 @@ int sithWeapon_Collide(sithThing *physicsThing, sithThing *collidedThing, sithCo
 		{
 			int joint = -1;
 #ifdef REGIONAL_DAMAGE
-			rdVector3 hitPos;
-			rdVector_Copy3(&hitPos, &physicsThing->position);
-			rdVector_MultAcc3(&hitPos, &physicsThing->lookOrientation.lvec, a4->distance);
-			joint = sithPuppet_FindHitLoc(collidedThing, &hitPos);
+			joint = sithWeapon_FindHitLoc(physicsThing, collidedThing, a4->distance);
 #endif
             sithThing_Damage(collidedThing, physicsThing, physicsThing->weaponParams.damage, physicsThing->weaponParams.damageClass, joint);
 			if (collidedThing->moveType == SITH_MT_PHYSICS && !MOTS_ONLY_FLAG(collidedThing->type == SITH_THING_COG))
@@ -1013,7 +1184,7 @@ void sithWeapon_RemoveAndExplode(sithThing *weapon, sithThing *explodeTemplate)
         {
             // Added: second comparison, co-op
             if (player == sithPlayer_pLocalPlayerThing || player->type == SITH_THING_PLAYER) {
-                sithAIAwareness_AddEntry(spawned->sector, &spawned->position, 0, 2.0, player);
+                sithWeapon_AddAwareness(spawned->sector, &spawned->position, 0, 2.0, player);
             }
             if (weapon->thingflags & SITH_TF_INVULN)
             {
@@ -1038,6 +1209,31 @@ void sithWeapon_StartupEntry()
     sithWeapon_8BD05C = 0;
     sithWeapon_CurWeaponMode = -1;
     sithWeapon_8BD024 = -1;
+
+#ifdef HITSCAN_BATCHING
+    sithHitscan_Reset();
+#endif
+#ifdef TRAIL_POOL
+    sithTrail_Reset();
+#endif
+#ifdef AUTOAIM_CACHE
+    sithAutoAim_Reset();
+#endif
+#ifdef PROJECTILE_POOL
+    sithProjectile_Reset();
+#endif
+#ifdef AWARENESS_COALESCING
+    sithAwarenessBatch_Reset();
+#endif
+#ifdef FIRE_NET_BATCHING
+    sithFireNet_Reset();
+#endif
+#if defined(REGIONAL_DAMAGE) && defined(HITLOC_CAPSULES)
+    sithHitLoc_Reset();
+#endif
+#if (defined(DECAL_RENDERING) || defined(RENDER_DROID2)) && defined(DECAL_POOL)
+    sithDecalPool_Reset();
+#endif
 }
 
 void sithWeapon_ShutdownEntry()
@@ -1434,7 +1630,11 @@ sithThing* sithWeapon_ProjectileAutoAim(rdMatrix34 *out, sithThing *sender, rdMa
     flex_d_t v15; // st7
     rdVector3 v16; // [esp+0h] [ebp-58h] BYREF
     rdVector3 v17; // [esp+Ch] [ebp-4Ch] BYREF
+#ifdef AUTOAIM_CACHE
+    sithThing *thingList[SITHAUTOAIM_MAX_CANDIDATES];
+#else
     sithThing *thingList[16]; // [esp+18h] [ebp-40h] BYREF
+#endif
     flex_t a3a; // [esp+6Ch] [ebp+14h]
     int a4a; // [esp+70h] [ebp+18h]
 
@@ -1458,7 +1658,12 @@ sithThing* sithWeapon_ProjectileAutoAim(rdMatrix34 *out, sithThing *sender, rdMa
     }
     _memcpy(out, in, sizeof(rdMatrix34));
     rdVector_Copy3(&out->scale, fireOffset);
+#ifdef AUTOAIM_CACHE
+    // Added: cone query over the per-tick grid (sithAutoAim.c)
+    v9 = sithAutoAim_ThingsInCone(out, autoaimFov, autoaimMaxDist, SITHAUTOAIM_MAX_CANDIDATES, thingList);
+#else
     v9 = sithAI_FirstThingInView(sender->sector, out, autoaimFov, autoaimMaxDist, 16, thingList, 1028, g_flt_8BD044);
+#endif
     if ( v9 )
     {
         v10 = 0;
@@ -1470,7 +1675,11 @@ sithThing* sithWeapon_ProjectileAutoAim(rdMatrix34 *out, sithThing *sender, rdMa
             v12 = *v11;
             if ( *v11 != sender && (v12->actorParams.typeflags & SITH_AF_NOTARGET) == 0 )
             {
+#ifdef AUTOAIM_CACHE
+                if ( sithAutoAim_HasLos(sender, v12) )
+#else
                 if ( sithCollision_HasLos(sender, v12, 0) )
+#endif
                 {
                     v13 = *v11;
                     rdVector_Sub3(&v16, &v13->position, &sender->position);
@@ -1530,6 +1739,13 @@ sithThing* sithWeapon_FireProjectile(sithThing *sender, sithThing *projectileTem
 	if (rdVector_IsZero3(aimError) )
 		rdMatrix_PreRotate34(&projectileLookat, aimError);
 
+#ifdef FIRE_NET_BATCHING
+	// Added: fired locally as the other machines will see it
+	sithFireNetEvent fireEvent;
+	if (sithComm_multiplayerFlags)
+		sithFireNet_Prepare(&fireEvent, sender, &projectileLookat.lvec, fireOffset);
+#endif
+
 	float fireRateDeltaTime = 0.0f;
 	if ( (scaleFlags & SITH_PROJECTILE_SCALE_UNK10) == 0 )
 	{
@@ -1546,22 +1762,38 @@ sithThing* sithWeapon_FireProjectile(sithThing *sender, sithThing *projectileTem
 		{
 			fireRateTimeRatio -= 1.0;
 			fireRateDeltaTime = fireRateTimeRatio * sithWeapon_fireRate;
+#ifdef PROJECTILE_POOL
+			if (sithWeapon_FirePooled(sender, projectileTemplate, &projectileLookat.lvec, fireOffset, 0, mode, scale, scaleFlags, fireRateDeltaTime))
+				continue;
+#endif
 			sithThing* result = sithWeapon_FireProjectile_0(sender, projectileTemplate, &projectileLookat.lvec, fireOffset, 0, mode, scale, scaleFlags, fireRateDeltaTime, extra);
 				
 			if (result && sithComm_multiplayerFlags )
+#ifdef FIRE_NET_BATCHING
+				sithFireNet_Queue(&fireEvent, projectileTemplate, 0, mode, scale, scaleFlags, fireRateDeltaTime, result->thing_id, extra);
+#else
 				sithDSSThing_SendFireProjectile(sender, projectileTemplate, &projectileLookat.lvec, fireOffset, 0, mode, scale, scaleFlags, fireRateDeltaTime, result->thing_id, INVALID_DPID, 255, extra);
+#endif
 		}
 	}
 
 	if ( fireSound )
-		sithAIAwareness_AddEntry(sender->sector, &sender->position, 1, 4.0, sender);
+		sithWeapon_AddAwareness(sender->sector, &sender->position, 1, 4.0, sender);
+#ifdef PROJECTILE_POOL
+	if (sithWeapon_FirePooled(sender, projectileTemplate, &projectileLookat.lvec, fireOffset, fireSound, mode, scale, scaleFlags, fireRateDeltaTime))
+		return NULL;
+#endif
 	sithThing* result = sithWeapon_FireProjectile_0(sender, projectileTemplate, &projectileLookat.lvec, fireOffset, fireSound, mode, scale, scaleFlags, fireRateDeltaTime, extra);
 	if ( result )
 	{
 		if ( sithComm_multiplayerFlags )
 		{
+#ifdef FIRE_NET_BATCHING
+			sithFireNet_Queue(&fireEvent, projectileTemplate, fireSound, mode, scale, scaleFlags, fireRateDeltaTime, result->thing_id, extra);
+#else
 			sithDSSThing_SendFireProjectile(sender, projectileTemplate, &projectileLookat.lvec, fireOffset, fireSound,
 				mode, scale, scaleFlags, fireRateDeltaTime, result->thing_id, INVALID_DPID, 255, extra);
+#endif
 		}
 	}
 	return result;
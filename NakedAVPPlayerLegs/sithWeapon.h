@@ -43,6 +43,10 @@ void sithWeapon_Startup();
 MATH_FUNC void sithWeapon_Tick(sithThing *weapon, flex_t deltaSeconds);
 MATH_FUNC void sithWeapon_sub_4D35E0(sithThing *weapon);
 MATH_FUNC void sithWeapon_sub_4D3920(sithThing *weapon);
+MATH_FUNC void sithWeapon_TickEnd();
+MATH_FUNC flex_t sithWeapon_LayTrail(sithThing *weapon, rdVector3 *dir, flex_t dist, flex_t end, sithSector *sector);
+MATH_FUNC void sithWeapon_InstantImpactHit(sithThing *weapon, sithSector *sector, sithCollisionSearchEntry *searchRes, rdVector3 *dir);
+void sithWeapon_FireEffects(sithThing *sender, sithSound *fireSound, int anim);
 int sithWeapon_LoadParams(stdConffileArg *arg, sithThing *thing, int param);
 MATH_FUNC sithThing* sithWeapon_Fire(sithThing *weapon, sithThing *projectile, rdVector3 *fireOffset, rdVector3 *aimError, sithSound *fireSound, int anim, flex_t scale, int16_t scaleFlags, flex_t a9);
 MATH_FUNC sithThing* sithWeapon_FireProjectile_0(sithThing *sender, sithThing *projectileTemplate, rdVector3 *fireOffset, rdVector3 *aimError, sithSound *fireSound, int anim, flex_t scale, char scaleFlags, flex_t a9, int extra);